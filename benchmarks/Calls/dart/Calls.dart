@@ -91,6 +91,10 @@ Future main() async {
       () => performSyncCallsClosureTarget(returnSync)).report();
   SyncCallBenchmark('Calls.SyncCallInstanceTargetPolymorphic',
       () => performSyncCallsInstanceTargetPolymorphic(target)).report();
+  // Spreads the calls over many dispatch table entries, so it is sensitive to
+  // the layout of the table (e.g. compare cache misses under `perf stat`).
+  SyncCallBenchmark('Calls.SyncCallInstanceTargetMegamorphic',
+      performSyncCallsInstanceTargetMegamorphic).report();
 
   SyncCallBenchmark('Calls.IterableSyncStarIterablePolymorphic',
       () => performSyncIterationPolymorphic(generateNumbersSyncStar)).report();
@@ -328,6 +332,19 @@ int performSyncCallsInstanceTargetPolymorphic(Target target) {
   return iterationLimitSync;
 }
 
+@pragma('vm:never-inline')
+@pragma('wasm:never-inline')
+@pragma('dart2js:noInline')
+int performSyncCallsInstanceTargetMegamorphic() {
+  final targets = megamorphicTargets;
+  int sum = 0;
+  for (int i = 0; i < iterationLimitSync; ++i) {
+    sum += targets[i % targets.length].returnSync(i);
+  }
+  if (sum != sumOfIterationLimitSync) throw 'BUG';
+  return iterationLimitSync;
+}
+
 @pragma('vm:never-inline')
 @pragma('wasm:never-inline')
 @pragma('dart2js:noInline')
@@ -826,6 +843,167 @@ class Target3 extends Target {
   int returnSync(int i) => i;
 }
 
+// Receivers of many classes, grouped under abstract classes like in typical
+// class hierarchies.
+final List<MegamorphicTarget> megamorphicTargets = [
+  MegamorphicTargetA0(),
+  MegamorphicTargetA1(),
+  MegamorphicTargetA2(),
+  MegamorphicTargetA3(),
+  MegamorphicTargetB0(),
+  MegamorphicTargetB1(),
+  MegamorphicTargetB2(),
+  MegamorphicTargetB3(),
+  MegamorphicTargetC0(),
+  MegamorphicTargetC1(),
+  MegamorphicTargetC2(),
+  MegamorphicTargetC3(),
+  MegamorphicTargetD0(),
+  MegamorphicTargetD1(),
+  MegamorphicTargetD2(),
+  MegamorphicTargetD3(),
+];
+
+abstract class MegamorphicTarget {
+  int returnSync(int i);
+}
+
+abstract class MegamorphicTargetA extends MegamorphicTarget {}
+
+class MegamorphicTargetA0 extends MegamorphicTargetA {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetA1 extends MegamorphicTargetA {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetA2 extends MegamorphicTargetA {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetA3 extends MegamorphicTargetA {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+abstract class MegamorphicTargetB extends MegamorphicTarget {}
+
+class MegamorphicTargetB0 extends MegamorphicTargetB {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetB1 extends MegamorphicTargetB {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetB2 extends MegamorphicTargetB {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetB3 extends MegamorphicTargetB {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+abstract class MegamorphicTargetC extends MegamorphicTarget {}
+
+class MegamorphicTargetC0 extends MegamorphicTargetC {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetC1 extends MegamorphicTargetC {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetC2 extends MegamorphicTargetC {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetC3 extends MegamorphicTargetC {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+abstract class MegamorphicTargetD extends MegamorphicTarget {}
+
+class MegamorphicTargetD0 extends MegamorphicTargetD {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetD1 extends MegamorphicTargetD {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetD2 extends MegamorphicTargetD {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
+class MegamorphicTargetD3 extends MegamorphicTargetD {
+  @override
+  @pragma('vm:never-inline')
+  @pragma('wasm:never-inline')
+  @pragma('dart2js:noInline')
+  int returnSync(int i) => i;
+}
+
 typedef PerformSyncCallsFunction = int Function();
 typedef PerformAsyncCallsFunction = Future<int> Function();
 
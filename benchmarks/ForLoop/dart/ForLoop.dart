@@ -2,6 +2,8 @@
 // for details. All rights reserved. Use of this source code is governed by a
 // BSD-style license that can be found in the LICENSE file.
 
+import 'dart:typed_data';
+
 import 'package:benchmark_harness/benchmark_harness.dart';
 
 class IterationBenchmark extends BenchmarkBase {
@@ -22,6 +24,23 @@ class ForLoop extends IterationBenchmark {
   }
 }
 
+// A counted loop over typed data, which can be unrolled.
+class ForLoopTypedData extends IterationBenchmark {
+  static const int length = 1024;
+  final Uint32List data = Uint32List.fromList(List.generate(length, (i) => i));
+  ForLoopTypedData() : super('ForLoop.TypedData');
+
+  @override
+  void run() {
+    var h = 0;
+    for (var i = 0; i < length; i++) {
+      h = (h * 31 + data[i]) & 0x3fffffff;
+    }
+    r = h;
+  }
+}
+
 void main() {
   ForLoop().report();
+  ForLoopTypedData().report();
 }
@@ -0,0 +1,156 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+//
+// Measures is and as tests against an interface implemented by classes in
+// many unrelated hierarchies, whose subtypes span many class id ranges, and
+// against a class whose subtypes are a single range for comparison.
+//
+// When precompiling, the tests against the interface use a class id bitset
+// instead of testing every range (see --subtype-bitset-threshold).
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+const int numTests = 1000;
+
+abstract class Tagged {}
+
+class Base {}
+
+class A0 extends Base {}
+
+class A1 extends A0 implements Tagged {}
+
+class A2 extends A0 {}
+
+class B0 extends Base {}
+
+class B1 extends B0 implements Tagged {}
+
+class B2 extends B0 {}
+
+class C0 extends Base {}
+
+class C1 extends C0 implements Tagged {}
+
+class C2 extends C0 {}
+
+class D0 extends Base {}
+
+class D1 extends D0 implements Tagged {}
+
+class D2 extends D0 {}
+
+class E0 extends Base {}
+
+class E1 extends E0 implements Tagged {}
+
+class E2 extends E0 {}
+
+class F0 extends Base {}
+
+class F1 extends F0 implements Tagged {}
+
+class F2 extends F0 {}
+
+class G0 extends Base {}
+
+class G1 extends G0 implements Tagged {}
+
+class G2 extends G0 {}
+
+class H0 extends Base {}
+
+class H1 extends H0 implements Tagged {}
+
+class H2 extends H0 {}
+
+final List<Object> objects = List<Object>.generate(numTests, (i) {
+  switch (i % 16) {
+    case 0:
+      return A1();
+    case 1:
+      return A2();
+    case 2:
+      return B1();
+    case 3:
+      return B2();
+    case 4:
+      return C1();
+    case 5:
+      return C2();
+    case 6:
+      return D1();
+    case 7:
+      return D2();
+    case 8:
+      return E1();
+    case 9:
+      return E2();
+    case 10:
+      return F1();
+    case 11:
+      return F2();
+    case 12:
+      return G1();
+    case 13:
+      return G2();
+    case 14:
+      return H1();
+    default:
+      return H2();
+  }
+});
+
+final List<Object> tagged = objects.whereType<Tagged>().toList();
+
+abstract class TypeCheckBenchmark extends BenchmarkBase {
+  int count = 0;
+
+  TypeCheckBenchmark(String name) : super('InterfaceTypeCheck.$name');
+
+  @override
+  void teardown() {
+    if (count == 0) throw 'Unexpected count';
+  }
+}
+
+class IsInterface extends TypeCheckBenchmark {
+  IsInterface() : super('IsInterface');
+
+  @override
+  void run() {
+    for (int i = 0; i < objects.length; i++) {
+      if (objects[i] is Tagged) count++;
+    }
+  }
+}
+
+class AsInterface extends TypeCheckBenchmark {
+  AsInterface() : super('AsInterface');
+
+  @override
+  void run() {
+    for (int i = 0; i < tagged.length; i++) {
+      final Tagged t = tagged[i] as Tagged;
+      if (identical(t, tagged[i])) count++;
+    }
+  }
+}
+
+class IsClass extends TypeCheckBenchmark {
+  IsClass() : super('IsClass');
+
+  @override
+  void run() {
+    for (int i = 0; i < objects.length; i++) {
+      if (objects[i] is Base) count++;
+    }
+  }
+}
+
+void main() {
+  IsInterface().report();
+  AsInterface().report();
+  IsClass().report();
+}
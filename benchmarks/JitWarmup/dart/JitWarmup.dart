@@ -0,0 +1,102 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures how long a process takes to run a fixed amount of work right after
+// startup, without and with a JIT warmup cache recorded by a previous run.
+
+import 'dart:io';
+
+const warmupIterations = 200;
+
+abstract class Shape {
+  double area();
+}
+
+class Circle implements Shape {
+  final double radius;
+  Circle(this.radius);
+  double area() => 3.14159 * radius * radius;
+}
+
+class Rectangle implements Shape {
+  final double width;
+  final double height;
+  Rectangle(this.width, this.height);
+  double area() => width * height;
+}
+
+class Triangle implements Shape {
+  final double base;
+  final double height;
+  Triangle(this.base, this.height);
+  double area() => 0.5 * base * height;
+}
+
+double work(int seed) {
+  final shapes = <Shape>[];
+  for (int i = 0; i < 1000; i++) {
+    final v = (seed + i) % 17 + 1.0;
+    switch (i % 3) {
+      case 0:
+        shapes.add(Circle(v));
+      case 1:
+        shapes.add(Rectangle(v, v + 1));
+      default:
+        shapes.add(Triangle(v, v * 2));
+    }
+  }
+  var total = 0.0;
+  for (final shape in shapes) {
+    total += shape.area();
+  }
+  final words = <String, int>{};
+  for (int i = 0; i < 1000; i++) {
+    final word = 'w${(seed * i) % 97}';
+    words[word] = (words[word] ?? 0) + 1;
+  }
+  return total + words.length;
+}
+
+Future<int> warmupMicros(String cachePath) async {
+  final p = await Process.run(Platform.executable, [
+    ...Platform.executableArguments,
+    '--jit_warmup_cache=$cachePath',
+    Platform.script.toFilePath(),
+    '--child'
+  ]);
+  if (p.exitCode != 0) {
+    print(p.stdout);
+    print(p.stderr);
+    throw 'Child process failed: ${p.exitCode}';
+  }
+  return int.parse((p.stdout as String).trim());
+}
+
+Future<void> main(List<String> args) async {
+  if (args.contains('--child')) {
+    final sw = Stopwatch()..start();
+    var result = 0.0;
+    for (int i = 0; i < warmupIterations; i++) {
+      result += work(i);
+    }
+    sw.stop();
+    if (result.isNaN) throw 'Unexpected result';
+    print(sw.elapsedMicroseconds);
+    return;
+  }
+
+  final tempDir = await Directory.systemTemp.createTemp();
+  try {
+    final cachePath = tempDir.uri.resolve('JitWarmup.cache').toFilePath();
+    // The first run starts without a cache and records one on exit.
+    final cold = await warmupMicros(cachePath);
+    final cached = await warmupMicros(cachePath);
+    print('JitWarmup.Cold(RunTime): $cold us.');
+    print('JitWarmup.Cached(RunTime): $cached us.');
+    print('JitWarmup.Cached(Speedup): '
+        '${(cold / cached).toStringAsFixed(2)}x.');
+  } finally {
+    await tempDir.delete(recursive: true);
+  }
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures how long it takes to fill the clusters of the program snapshot
+// when the independent clusters are filled sequentially or on helper threads.
+
+import 'dart:convert';
+import 'dart:io';
+
+import '../../../pkg/vm/bin/gen_kernel.dart' as gen_kernel;
+
+const fillTasks = [1, 2, 4];
+
+Future<int> readFillMicros(int tasks) async {
+  final tempDir = await Directory.systemTemp.createTemp();
+  try {
+    final timelinePath =
+        tempDir.uri.resolve('SnapshotFill-timeline.json').toFilePath();
+    final p = await Process.run(Platform.executable, [
+      ...Platform.executableArguments,
+      '--snapshot_fill_tasks=$tasks',
+      '--timeline_recorder=file:$timelinePath',
+      '--timeline_streams=Isolate',
+      Platform.script.toFilePath(),
+      '--child'
+    ]);
+    if (p.exitCode != 0) {
+      print(p.stdout);
+      print(p.stderr);
+      throw 'Child process failed: ${p.exitCode}';
+    }
+
+    final events = jsonDecode(await File(timelinePath).readAsString());
+    // The last ReadFill is the one of the program snapshot, after the VM
+    // snapshot.
+    var micros;
+    for (final event in events) {
+      if (event['name'] == 'ReadFill' && event['ph'] == 'X') {
+        micros = event['dur'];
+      }
+    }
+    if (micros == null) {
+      throw 'ReadFill is missing';
+    }
+    return micros;
+  } finally {
+    await tempDir.delete(recursive: true);
+  }
+}
+
+Future<void> main(List<String> args) async {
+  if (args.contains('--child')) {
+    return;
+  }
+
+  // Include the CFE and prevent tree-shaking to make this program have a
+  // non-trival snapshot size.
+  if (args.contains('--train')) {
+    args.remove('--train');
+    return gen_kernel.main(args);
+  }
+
+  final sequential = await readFillMicros(fillTasks.first);
+  print('SnapshotFill.Tasks${fillTasks.first}(StartupTime): $sequential us.');
+  for (final tasks in fillTasks.skip(1)) {
+    final micros = await readFillMicros(tasks);
+    print('SnapshotFill.Tasks$tasks(StartupTime): $micros us.');
+    print('SnapshotFill.Tasks$tasks(Speedup): '
+        '${(sequential / micros).toStringAsFixed(2)}x.');
+  }
+}
@@ -0,0 +1,94 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures the cost of walking deep stacks: throwing through them, capturing
+// stack traces, and scanning them for roots during scavenges. Compare
+// StackWalk.Scavenge.Depth500 with StackWalk.Scavenge.Depth0 for the time
+// spent scanning 500 frames.
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+const int depth = 500;
+
+class Marker implements Exception {}
+
+@pragma('vm:never-inline')
+int throwAt(int n) {
+  if (n == 0) throw Marker();
+  return throwAt(n - 1) + 1;
+}
+
+@pragma('vm:never-inline')
+int traceAt(int n) {
+  if (n == 0) return StackTrace.current.toString().length;
+  return traceAt(n - 1) + 1;
+}
+
+List<Object?> sink = [];
+
+@pragma('vm:never-inline')
+int allocateAt(int n) {
+  if (n == 0) {
+    // Enough short-lived garbage for several scavenges, each of which has
+    // to visit every frame of the stack.
+    int total = 0;
+    for (int i = 0; i < 20000; i++) {
+      final list = List<Object?>.filled(64, null);
+      sink = list;
+      total += list.length;
+    }
+    return total;
+  }
+  return allocateAt(n - 1) + 1;
+}
+
+class Throw extends BenchmarkBase {
+  Throw() : super('StackWalk.Throw.Depth$depth');
+
+  @override
+  void run() {
+    for (int i = 0; i < 10; i++) {
+      try {
+        throwAt(depth);
+        throw 'Not reached';
+      } on Marker {
+        // Expected.
+      }
+    }
+  }
+}
+
+class Trace extends BenchmarkBase {
+  Trace() : super('StackWalk.StackTrace.Depth$depth');
+
+  @override
+  void run() {
+    if (traceAt(depth) <= depth) throw 'Bad result';
+  }
+}
+
+class Scavenge extends BenchmarkBase {
+  final int stackDepth;
+
+  Scavenge(this.stackDepth) : super('StackWalk.Scavenge.Depth$stackDepth');
+
+  @override
+  void run() {
+    if (allocateAt(stackDepth) != 20000 * 64 + stackDepth) {
+      throw 'Bad result';
+    }
+  }
+}
+
+void main() {
+  final benchmarks = [
+    Throw(),
+    Trace(),
+    Scavenge(0),
+    Scavenge(depth),
+  ];
+  for (final benchmark in benchmarks) {
+    benchmark.report();
+  }
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures building a log of 1000 lines, as template rendering and logging
+// code does, with the different ways of concatenating strings.
+//
+// StringConcat.PlusEquals and StringConcat.Interpolation copy the log built
+// so far for every line, so they grow quadratically with the number of lines,
+// while StringConcat.StringBuffer and StringConcat.Join copy every line once.
+// The TwoByte variants append lines with code units above 0xFF to a log that
+// starts out as a one-byte string.
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+const int numLines = 1000;
+
+List<String> makeLines(bool twoByte) => List<String>.generate(
+    numLines,
+    (i) => '[${i.toString().padLeft(4, '0')}] request handled '
+        '${twoByte && i.isOdd ? '\u{2713}' : 'ok'} in ${i % 97} ms\n');
+
+abstract class ConcatBenchmark extends BenchmarkBase {
+  final List<String> lines;
+  int length = 0;
+
+  ConcatBenchmark(String name, {bool twoByte = false})
+      : lines = makeLines(twoByte),
+        super('StringConcat.$name${twoByte ? '.TwoByte' : ''}');
+
+  String build();
+
+  @override
+  void run() {
+    length += build().length;
+  }
+
+  @override
+  void teardown() {
+    if (length == 0) throw 'Unexpected length';
+  }
+}
+
+class PlusEquals extends ConcatBenchmark {
+  PlusEquals({super.twoByte}) : super('PlusEquals');
+
+  @override
+  String build() {
+    String log = '';
+    for (final line in lines) {
+      log += line;
+    }
+    return log;
+  }
+}
+
+class Interpolation extends ConcatBenchmark {
+  Interpolation({super.twoByte}) : super('Interpolation');
+
+  @override
+  String build() {
+    String log = '';
+    for (int i = 0; i < lines.length; i++) {
+      log = '$log$i: ${lines[i]}';
+    }
+    return log;
+  }
+}
+
+class Buffer extends ConcatBenchmark {
+  Buffer({super.twoByte}) : super('StringBuffer');
+
+  @override
+  String build() {
+    final buffer = StringBuffer();
+    for (final line in lines) {
+      buffer.write(line);
+    }
+    return buffer.toString();
+  }
+}
+
+class Join extends ConcatBenchmark {
+  Join({super.twoByte}) : super('Join');
+
+  @override
+  String build() => lines.join();
+}
+
+void main() {
+  final benchmarks = [
+    PlusEquals(),
+    PlusEquals(twoByte: true),
+    Interpolation(),
+    Interpolation(twoByte: true),
+    Buffer(),
+    Buffer(twoByte: true),
+    Join(),
+    Join(twoByte: true),
+  ];
+  for (final benchmark in benchmarks) {
+    benchmark.report();
+  }
+}
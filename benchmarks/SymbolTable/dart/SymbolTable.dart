@@ -0,0 +1,121 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Measures interning the keys of a 350 KB JSON document from 16 isolates at
+// the same time, as a JSON decoder interning its keys would.
+//
+// SymbolTable.<Api>.Shared: all isolates intern the same keys, so most of
+// them are found in the symbol table.
+// SymbolTable.<Api>.Unique: every isolate interns its own keys, which all
+// have to be added to the symbol table.
+//
+// <Api> is Intern for one call per key and InternAll for a single batch call
+// per isolate.
+
+// The VM allows importing dart:_internal, which exposes its string interning.
+import 'dart:_internal' show intern, internAll;
+import 'dart:async';
+import 'dart:convert';
+import 'dart:isolate';
+import 'dart:math';
+
+const int numIsolates = 16;
+const int warmupRounds = 2;
+const int rounds = 10;
+
+// Around 350 KB of json data with objects of ten fields each, picked from
+// tens of thousands of distinct field names.
+final String jsonData = () {
+  final rnd = Random(42);
+  final records = <Map<String, int>>[];
+  int size = 0;
+  while (size < 350 * 1024) {
+    final record = <String, int>{};
+    for (int i = 0; i < 10; i++) {
+      final key = 'field${rnd.nextInt(50000)}';
+      record[key] = rnd.nextInt(1000);
+      size += key.length + 8;
+    }
+    records.add(record);
+  }
+  return json.encode(records);
+}();
+
+class Task {
+  final String json;
+  final String salt;
+  final bool batch;
+  final SendPort port;
+  Task(this.json, this.salt, this.batch, this.port);
+}
+
+void collectKeys(Object? value, String salt, List<String> keys) {
+  if (value is Map<String, dynamic>) {
+    for (final entry in value.entries) {
+      keys.add(salt.isEmpty ? entry.key : '${entry.key}$salt');
+      collectKeys(entry.value, salt, keys);
+    }
+  } else if (value is List) {
+    for (final element in value) {
+      collectKeys(element, salt, keys);
+    }
+  }
+}
+
+Future<void> worker(Task task) async {
+  final keys = <String>[];
+  collectKeys(json.decode(task.json), task.salt, keys);
+  final start = ReceivePort();
+  task.port.send(start.sendPort);
+  await start.first;
+  final interned =
+      task.batch ? internAll(keys) : [for (final key in keys) intern(key)];
+  if (interned.length != keys.length) throw 'Unexpected result';
+  task.port.send(null);
+}
+
+int saltCounter = 0;
+
+// Returns the time in microseconds it took all isolates to intern their keys.
+Future<int> round(bool batch, bool unique) async {
+  final port = ReceivePort();
+  final messages = StreamIterator<dynamic>(port);
+  for (int i = 0; i < numIsolates; i++) {
+    final salt = unique ? '#${saltCounter++}' : '';
+    await Isolate.spawn(worker, Task(jsonData, salt, batch, port.sendPort));
+  }
+  final starts = <SendPort>[];
+  while (starts.length < numIsolates) {
+    await messages.moveNext();
+    starts.add(messages.current as SendPort);
+  }
+  final stopwatch = Stopwatch()..start();
+  for (final start in starts) {
+    start.send(null);
+  }
+  for (int i = 0; i < numIsolates; i++) {
+    await messages.moveNext();
+  }
+  stopwatch.stop();
+  port.close();
+  return stopwatch.elapsedMicroseconds;
+}
+
+Future<void> report(String name, bool batch, bool unique) async {
+  for (int i = 0; i < warmupRounds; i++) {
+    await round(batch, unique);
+  }
+  int total = 0;
+  for (int i = 0; i < rounds; i++) {
+    total += await round(batch, unique);
+  }
+  print('SymbolTable.$name(RunTime): ${total / rounds} us.');
+}
+
+Future<void> main() async {
+  await report('Intern.Shared', false, false);
+  await report('InternAll.Shared', true, false);
+  await report('Intern.Unique', false, true);
+  await report('InternAll.Unique', true, true);
+}
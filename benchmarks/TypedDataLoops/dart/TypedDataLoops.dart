@@ -0,0 +1,127 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Element-wise loops over typed data, which can be vectorized.
+
+import 'dart:typed_data';
+
+import 'package:benchmark_harness/benchmark_harness.dart';
+
+const int length = 4099;
+
+abstract class TypedDataLoop extends BenchmarkBase {
+  TypedDataLoop(String name) : super('TypedDataLoops.$name');
+}
+
+class Float32Scale extends TypedDataLoop {
+  final Float32List input =
+      Float32List.fromList(List.generate(length, (i) => i * 0.25));
+  final Float32List output = Float32List(length);
+  Float32Scale() : super('Float32Scale');
+
+  @override
+  void run() {
+    final a = input;
+    final b = output;
+    for (int i = 0; i < a.length; i++) {
+      b[i] = a[i] * 0.5;
+    }
+  }
+}
+
+class Float32Add extends TypedDataLoop {
+  final Float32List left =
+      Float32List.fromList(List.generate(length, (i) => i * 0.25));
+  final Float32List right =
+      Float32List.fromList(List.generate(length, (i) => 1000.0 - i));
+  final Float32List output = Float32List(length);
+  Float32Add() : super('Float32Add');
+
+  @override
+  void run() {
+    final a = left;
+    final b = right;
+    final c = output;
+    for (int i = 0; i < c.length; i++) {
+      c[i] = a[i] + b[i];
+    }
+  }
+}
+
+class Float32Compare extends TypedDataLoop {
+  final Float32List left =
+      Float32List.fromList(List.generate(length, (i) => (i * 7 % 13) * 1.0));
+  final Float32List right =
+      Float32List.fromList(List.generate(length, (i) => (i * 5 % 11) * 1.0));
+  final Int32List output = Int32List(length);
+  Float32Compare() : super('Float32Compare');
+
+  @override
+  void run() {
+    final a = left;
+    final b = right;
+    final c = output;
+    for (int i = 0; i < c.length; i++) {
+      c[i] = a[i] < b[i] ? 1 : 0;
+    }
+  }
+}
+
+class Int32Add extends TypedDataLoop {
+  final Int32List input = Int32List.fromList(List.generate(length, (i) => i));
+  final Int32List output = Int32List(length);
+  Int32Add() : super('Int32Add');
+
+  @override
+  void run() {
+    final a = input;
+    final b = output;
+    for (int i = 0; i < a.length; i++) {
+      b[i] = a[i] + 12345;
+    }
+  }
+}
+
+class Uint8Xor extends TypedDataLoop {
+  final Uint8List input =
+      Uint8List.fromList(List.generate(length, (i) => i & 0xff));
+  final Uint8List output = Uint8List(length);
+  Uint8Xor() : super('Uint8Xor');
+
+  @override
+  void run() {
+    final a = input;
+    final b = output;
+    for (int i = 0; i < a.length; i++) {
+      b[i] = a[i] ^ 0x5a;
+    }
+  }
+}
+
+class Uint8Fill extends TypedDataLoop {
+  final Uint8List output = Uint8List(length);
+  Uint8Fill() : super('Uint8Fill');
+
+  @override
+  void run() {
+    final a = output;
+    for (int i = 0; i < a.length; i++) {
+      a[i] = 0x20;
+    }
+  }
+}
+
+void main() {
+  final benchmarks = [
+    Float32Scale(),
+    Float32Add(),
+    Float32Compare(),
+    Int32Add(),
+    Uint8Xor(),
+    Uint8Fill(),
+  ];
+  for (final benchmark in benchmarks) {
+    benchmark.report();
+  }
+}
@@ -245,6 +245,13 @@ DEFINE_NATIVE_ENTRY(StringBase_intern, 0, 1) {
   return Symbols::New(thread, receiver);
 }
 
+DEFINE_NATIVE_ENTRY(StringBase_internAll, 0, 1) {
+  GET_NON_NULL_NATIVE_ARGUMENT(Array, strings, arguments->NativeArgAt(0));
+  ASSERT(!strings.IsImmutable());
+  Symbols::NewAll(thread, strings);
+  return Object::null();
+}
+
 DEFINE_NATIVE_ENTRY(OneByteString_substringUnchecked, 0, 3) {
   const String& receiver =
       String::CheckedHandle(zone, arguments->NativeArgAt(0));
@@ -257,6 +264,15 @@ DEFINE_NATIVE_ENTRY(OneByteString_substringUnchecked, 0, 3) {
   return OneByteString::New(receiver, start, end - start, Heap::kNew);
 }
 
+DEFINE_NATIVE_ENTRY(OneByteString_indexOf, 0, 3) {
+  const String& receiver =
+      String::CheckedHandle(zone, arguments->NativeArgAt(0));
+  ASSERT(receiver.IsOneByteString());
+  GET_NON_NULL_NATIVE_ARGUMENT(String, pattern, arguments->NativeArgAt(1));
+  GET_NON_NULL_NATIVE_ARGUMENT(Smi, start_obj, arguments->NativeArgAt(2));
+  return Smi::New(OneByteString::IndexOf(receiver, pattern, start_obj.Value()));
+}
+
 DEFINE_NATIVE_ENTRY(Internal_allocateOneByteString, 0, 1) {
   GET_NON_NULL_NATIVE_ARGUMENT(Integer, length_obj, arguments->NativeArgAt(0));
   const int64_t length = length_obj.AsInt64Value();
@@ -452,6 +468,10 @@ DEFINE_NATIVE_ENTRY(String_concat, 0, 2) {
   const String& receiver =
       String::CheckedHandle(zone, arguments->NativeArgAt(0));
   GET_NON_NULL_NATIVE_ARGUMENT(String, b, arguments->NativeArgAt(1));
+  // Strings are immutable, so there is no need to copy the other operand if
+  // one of them is empty.
+  if (b.Length() == 0) return receiver.ptr();
+  if (receiver.Length() == 0) return b.ptr();
   return String::Concat(receiver, b);
 }
 
@@ -0,0 +1,17 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// OtherResources=appjit_compressed_clusters_test_body.dart
+
+// Verify that kernel buffers loaded from an app-jit snapshot with compressed
+// clusters remain readable after the snapshot has been loaded.
+
+import 'dart:async';
+import 'dart:io' show Platform;
+
+import 'snapshot_test_helper.dart';
+
+Future<void> main() => runAppJitTest(
+    Platform.script.resolve('appjit_compressed_clusters_test_body.dart'),
+    trainingArguments: ['--compress-snapshot-clusters']);
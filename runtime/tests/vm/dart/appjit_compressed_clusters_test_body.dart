@@ -0,0 +1,54 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Functions not called during training are compiled lazily from the kernel
+// buffer in the snapshot, which points into the decompressed clusters.
+
+import 'package:expect/expect.dart';
+
+@pragma('vm:never-inline')
+int trained(int n) => n + 1;
+
+@pragma('vm:never-inline')
+String untrainedString(int n) => 'untrained-$n';
+
+@pragma('vm:never-inline')
+int untrainedLoop(int n) {
+  int sum = 0;
+  for (int i = 0; i < n; i++) {
+    sum += i * i;
+  }
+  return sum;
+}
+
+class Untrained {
+  final List<int> values;
+  Untrained(int n) : values = List<int>.generate(n, (i) => i * 3);
+
+  int get total => values.fold(0, (a, b) => a + b);
+}
+
+// Allocates and drops enough memory to reuse anything released after the
+// snapshot was loaded.
+void churn() {
+  final chunks = <List<int>>[];
+  for (int i = 0; i < 64; i++) {
+    chunks.add(List<int>.filled(64 * 1024, i));
+  }
+  Expect.equals(63, chunks.last.first);
+}
+
+void main(List<String> args) {
+  final isTraining = args.contains('--train');
+  Expect.equals(2, trained(1));
+  if (isTraining) {
+    print('OK(Trained)');
+    return;
+  }
+  churn();
+  Expect.equals('untrained-7', untrainedString(7));
+  Expect.equals(285, untrainedLoop(10));
+  Expect.equals(135, Untrained(10).total);
+  print('OK(Run)');
+}
@@ -0,0 +1,16 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// OtherResources=appjit_osr_test_body.dart
+
+// Verify that loops which were compiled through OSR when training an app-jit
+// snapshot run correctly from the snapshot.
+
+import 'dart:async';
+import 'dart:io' show Platform;
+
+import 'snapshot_test_helper.dart';
+
+Future<void> main() =>
+    runAppJitTest(Platform.script.resolve('appjit_osr_test_body.dart'));
@@ -0,0 +1,37 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verify that a loop OSR compiled for the receivers of the training run
+// computes the right result for other receivers when run from the snapshot.
+
+import 'package:expect/expect.dart';
+
+abstract class Step {
+  int apply(int i);
+}
+
+class Up implements Step {
+  int apply(int i) => i;
+}
+
+class Down implements Step {
+  int apply(int i) => -i;
+}
+
+// Called once, so its loop is only optimized through OSR.
+int sum(Step step, int n) {
+  int result = 0;
+  for (var i = 0; i < n; i++) {
+    result += step.apply(i);
+  }
+  return result;
+}
+
+void main(List<String> args) {
+  final isTraining = args.contains("--train");
+  final Step step = isTraining ? Up() : Down();
+  final result = sum(step, 1000000);
+  Expect.equals(isTraining ? 499999500000 : -499999500000, result);
+  print(isTraining ? 'OK(Trained)' : 'OK(Run)');
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization-counter-threshold=100 --background-compiler-threads=1
+// VMOptions=--optimization-counter-threshold=100 --background-compiler-threads=4
+// VMOptions=--optimization-counter-threshold=100 --background-compiler-threads=4 --stress-test-background-compilation
+
+// Verifies that functions optimized concurrently by several background
+// compiler threads, including ones whose class hierarchy changes while they
+// are compiled, keep computing the right results.
+
+import 'package:expect/expect.dart';
+
+abstract class Shape {
+  int area();
+}
+
+class Square extends Shape {
+  final int side;
+  Square(this.side);
+  int area() => side * side;
+}
+
+class Rectangle extends Shape {
+  final int width;
+  final int height;
+  Rectangle(this.width, this.height);
+  int area() => width * height;
+}
+
+class Triangle extends Shape {
+  final int base;
+  final int height;
+  Triangle(this.base, this.height);
+  int area() => base * height ~/ 2;
+}
+
+class Counter {
+  var value;
+  Counter(this.value);
+}
+
+@pragma('vm:never-inline')
+int sumAreas(List<Shape> shapes) {
+  int sum = 0;
+  for (final shape in shapes) {
+    sum += shape.area();
+  }
+  return sum;
+}
+
+@pragma('vm:never-inline')
+num bump(Counter counter) => counter.value + 1;
+
+@pragma('vm:never-inline')
+int f0(int x) => x + 1;
+@pragma('vm:never-inline')
+int f1(int x) => f0(x) * 2;
+@pragma('vm:never-inline')
+int f2(int x) => f1(x) - 3;
+@pragma('vm:never-inline')
+int f3(int x) => f2(x) ^ 5;
+@pragma('vm:never-inline')
+int f4(int x) => f3(x) + f0(x);
+@pragma('vm:never-inline')
+int f5(int x) => f4(x) * f1(x);
+@pragma('vm:never-inline')
+int f6(int x) => f5(x) % 1000;
+@pragma('vm:never-inline')
+int f7(int x) => f6(x) + f2(x);
+
+int expected(int x) {
+  final r0 = x + 1;
+  final r1 = r0 * 2;
+  final r2 = r1 - 3;
+  final r3 = r2 ^ 5;
+  final r4 = r3 + r0;
+  final r5 = r4 * r1;
+  final r6 = r5 % 1000;
+  return r6 + r2;
+}
+
+void main() {
+  final squares = <Shape>[Square(1), Square(2), Square(3)];
+  for (int i = 0; i < 20000; i++) {
+    Expect.equals(expected(i), f7(i));
+    Expect.equals(14, sumAreas(squares));
+    Expect.equals(i + 1, bump(Counter(i)));
+  }
+  // Invalidate the class hierarchy and field guard assumptions of the code
+  // compiled so far.
+  final shapes = <Shape>[Square(2), Rectangle(2, 3), Triangle(4, 3)];
+  for (int i = 0; i < 20000; i++) {
+    Expect.equals(16, sumAreas(shapes));
+    Expect.equals(2.5, bump(Counter(1.5)));
+    Expect.equals(expected(i), f7(i));
+  }
+}
@@ -0,0 +1,167 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Checks type tests and calls over a hierarchy with many abstract classes
+// when those are numbered last and the dispatch table is densely packed.
+
+// VMOptions=--sort_abstract_classes_last
+// VMOptions=--dispatch_table_dense_packing
+// VMOptions=--sort_abstract_classes_last --dispatch_table_dense_packing
+
+import 'package:expect/expect.dart';
+
+abstract class Node {
+  String get kind;
+  int eval();
+  int get depth => 1;
+}
+
+abstract class Leaf extends Node {
+  int get depth => 0;
+}
+
+abstract class Composite extends Node {
+  List<Node> get children;
+  int get depth {
+    int max = 0;
+    for (final child in children) {
+      if (child.depth > max) max = child.depth;
+    }
+    return max + 1;
+  }
+}
+
+abstract class Unary extends Composite {
+  Node get operand;
+  List<Node> get children => [operand];
+}
+
+abstract class Binary extends Composite {
+  Node get left;
+  Node get right;
+  List<Node> get children => [left, right];
+}
+
+abstract class Commutative implements Binary {}
+
+mixin Named on Node {
+  String get kind => runtimeType.toString().toLowerCase();
+}
+
+class Literal extends Leaf with Named {
+  final int value;
+  Literal(this.value);
+  int eval() => value;
+}
+
+class Zero extends Leaf with Named {
+  int eval() => 0;
+}
+
+class Negate extends Unary with Named {
+  final Node operand;
+  Negate(this.operand);
+  int eval() => -operand.eval();
+}
+
+class Add extends Binary with Named implements Commutative {
+  final Node left, right;
+  Add(this.left, this.right);
+  int eval() => left.eval() + right.eval();
+}
+
+class Mul extends Binary with Named implements Commutative {
+  final Node left, right;
+  Mul(this.left, this.right);
+  int eval() => left.eval() * right.eval();
+}
+
+class Sub extends Binary with Named {
+  final Node left, right;
+  Sub(this.left, this.right);
+  int eval() => left.eval() - right.eval();
+}
+
+abstract class Visitor {
+  String visit(Node node);
+}
+
+class Printer extends Visitor {
+  String visit(Node node) {
+    if (node is Literal) return '${node.value}';
+    if (node is Leaf) return node.kind;
+    if (node is Unary) return '-${visit(node.operand)}';
+    final binary = node as Binary;
+    final op = binary is Add
+        ? '+'
+        : binary is Mul
+            ? '*'
+            : '-';
+    return '(${visit(binary.left)} $op ${visit(binary.right)})';
+  }
+}
+
+@pragma('vm:never-inline')
+dynamic opaque(dynamic x) => x;
+
+void main() {
+  final tree = Sub(Add(Literal(3), Mul(Literal(4), Negate(Literal(5)))),
+      Add(Zero(), Zero()));
+
+  Expect.equals(-17, tree.eval());
+  Expect.equals(4, tree.depth);
+  Expect.equals('sub', tree.kind);
+  Expect.equals('((3 + (4 * -5)) - (zero + zero))', Printer().visit(tree));
+
+  final nodes = <Node>[
+    Literal(1),
+    Zero(),
+    Negate(Literal(2)),
+    Add(Literal(1), Literal(2)),
+    Mul(Literal(3), Literal(4)),
+    Sub(Literal(5), Literal(6)),
+  ];
+  final expected = <List<bool>>[
+    // Leaf, Composite, Unary, Binary, Commutative, Named
+    [true, false, false, false, false, true],
+    [true, false, false, false, false, true],
+    [false, true, true, false, false, true],
+    [false, true, false, true, true, true],
+    [false, true, false, true, true, true],
+    [false, true, false, true, false, true],
+  ];
+  for (int i = 0; i < nodes.length; i++) {
+    final dynamic node = opaque(nodes[i]);
+    Expect.listEquals(expected[i], <bool>[
+      node is Leaf,
+      node is Composite,
+      node is Unary,
+      node is Binary,
+      node is Commutative,
+      node is Named,
+    ]);
+    Expect.isTrue(node is Node);
+    Expect.isFalse(node is Visitor);
+    Expect.equals(node, node as Node);
+    if (node is Binary) {
+      Expect.equals(node, node as Composite);
+    } else {
+      Expect.throws<TypeError>(() => node as Binary);
+    }
+    Expect.throws<TypeError>(() => opaque(Printer()) as Node);
+
+    // Dynamic calls, through the dispatch table and the selectors of
+    // abstract classes.
+    Expect.equals(nodes[i].eval(), node.eval());
+    Expect.equals(nodes[i].kind, node.kind);
+    Expect.equals(nodes[i].depth, node.depth);
+    if (node is Composite) {
+      Expect.equals(node.children.length, (node as dynamic).children.length);
+    } else {
+      Expect.throws<NoSuchMethodError>(() => node.children);
+    }
+  }
+  Expect.listEquals(
+      [1, 0, -2, 3, 12, -1], nodes.map((n) => opaque(n).eval()).toList());
+}
@@ -0,0 +1,90 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation --fast-register-allocation-threshold=0
+
+// Verifies that code compiled with the fast register allocation mode keeps
+// values alive across loops, calls and register pressure.
+
+import 'package:expect/expect.dart';
+
+@pragma('vm:never-inline')
+int id(int x) => x;
+
+@pragma('vm:never-inline')
+int pressure(int n) {
+  int a = id(1), b = id(2), c = id(3), d = id(4), e = id(5), f = id(6);
+  int g = id(7), h = id(8), i = id(9), j = id(10), k = id(11), l = id(12);
+  int m = id(13), o = id(14), p = id(15), q = id(16), r = id(17), s = id(18);
+  for (int x = 0; x < n; x++) {
+    a += b;
+    b += c;
+    c += d;
+    d += e;
+    e += f;
+    f += g;
+    g += h;
+    h += i;
+    i += j;
+    j += k;
+    k += l;
+    l += m;
+    m += o;
+    o += p;
+    p += q;
+    q += r;
+    r += s;
+    s += id(x);
+  }
+  return a ^ b ^ c ^ d ^ e ^ f ^ g ^ h ^ i ^ j ^ k ^ l ^ m ^ o ^ p ^ q ^ r ^ s;
+}
+
+@pragma('vm:never-inline')
+double nested(List<double> values) {
+  double sum = 0.0;
+  double product = 1.0;
+  for (int i = 0; i < values.length; i++) {
+    double inner = 0.0;
+    for (int j = 0; j <= i; j++) {
+      inner += values[j] * (j + 1);
+    }
+    sum += inner;
+    product *= (inner == 0.0) ? 1.0 : 1.0 + 1.0 / inner;
+  }
+  return sum + product;
+}
+
+int expectedPressure(int n) {
+  final v = List<int>.generate(18, (i) => i + 1);
+  for (int x = 0; x < n; x++) {
+    for (int i = 0; i < 17; i++) {
+      v[i] += v[i + 1];
+    }
+    v[17] += x;
+  }
+  return v.reduce((a, b) => a ^ b);
+}
+
+double expectedNested(List<double> values) {
+  double sum = 0.0;
+  double product = 1.0;
+  for (int i = 0; i < values.length; i++) {
+    double inner = 0.0;
+    for (int j = 0; j <= i; j++) {
+      inner += values[j] * (j + 1);
+    }
+    sum += inner;
+    product *= (inner == 0.0) ? 1.0 : 1.0 + 1.0 / inner;
+  }
+  return sum + product;
+}
+
+void main() {
+  final values = [0.5, -1.25, 3.0, 0.0, 7.75, 2.5];
+  for (int k = 0; k < 50; k++) {
+    Expect.equals(expectedPressure(k % 7), pressure(k % 7));
+    Expect.equals(expectedNested(values), nested(values));
+  }
+}
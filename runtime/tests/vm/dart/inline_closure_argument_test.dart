@@ -0,0 +1,76 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation --inlining-closure-argument-size-threshold=0
+
+// Verifies that higher-order functions inlined because they are passed
+// closures with known functions call the right closures.
+
+import 'package:expect/expect.dart';
+
+int applyTwice(int x, int Function(int) f) {
+  int result = x;
+  for (int i = 0; i < 2; i++) {
+    result = f(result);
+    if (result < 0) {
+      throw 'negative';
+    }
+  }
+  return result;
+}
+
+int twice(int x) => x * 2;
+
+class Scale {
+  final int factor;
+  Scale(this.factor);
+  int apply(int x) => x * factor;
+}
+
+@pragma('vm:never-inline')
+int localClosure(int x, int offset) => applyTwice(x, (y) => y + offset);
+
+@pragma('vm:never-inline')
+int tearOff(int x) => applyTwice(x, twice);
+
+@pragma('vm:never-inline')
+int instanceTearOff(int x, Scale s) => applyTwice(x, s.apply);
+
+@pragma('vm:never-inline')
+int sameFunction(bool c, int x) {
+  // Closures of the same function with different contexts.
+  final int Function(int) f = c ? (y) => y + x : (y) => y + x;
+  return applyTwice(x, f);
+}
+
+@pragma('vm:never-inline')
+int differentFunctions(bool c, int x) {
+  final int Function(int) f = c ? (y) => y + 1 : (y) => y - 1;
+  return applyTwice(x, f);
+}
+
+@pragma('vm:never-inline')
+int collections(List<int> values) {
+  int sum = 0;
+  values.forEach((v) => sum += v);
+  return values
+          .where((v) => v.isOdd)
+          .map((v) => v * 10)
+          .fold(sum, (int a, int b) => a + b);
+}
+
+void main() {
+  final values = [1, 2, 3, 4, 5];
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(i + 2 * 3, localClosure(i, 3));
+    Expect.equals(i * 4, tearOff(i));
+    Expect.equals(i * 9, instanceTearOff(i, Scale(3)));
+    Expect.equals(i * 3, sameFunction(i.isEven, i));
+    Expect.equals(
+        i.isEven ? i + 12 : i + 8, differentFunctions(i.isEven, i + 10));
+    Expect.equals(15 + 90, collections(values));
+  }
+  Expect.throws(() => differentFunctions(false, 1));
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verifies the runtime's fast paths for long one-byte strings: searching and
+// case conversion.
+
+import 'package:expect/expect.dart';
+
+int slowIndexOf(String s, String pattern, int start) {
+  for (int i = start; i + pattern.length <= s.length; i++) {
+    if (s.substring(i, i + pattern.length) == pattern) return i;
+  }
+  return -1;
+}
+
+void testIndexOf() {
+  final haystack = 'ab' * 500 + 'abc' + 'ab' * 200 + 'abcd';
+  for (final pattern in ['ab', 'ba', 'abc', 'cab', 'abcd', 'd', 'x', 'abx']) {
+    for (final start in [0, 1, 500, 999, 1000, 1001, 1400, haystack.length]) {
+      Expect.equals(slowIndexOf(haystack, pattern, start),
+          haystack.indexOf(pattern, start), '$pattern from $start');
+    }
+    Expect.equals(slowIndexOf(haystack, pattern, 0) >= 0,
+        haystack.contains(pattern));
+  }
+  Expect.equals(0, haystack.indexOf('', 0));
+  Expect.equals(haystack.length, haystack.indexOf('', haystack.length));
+  Expect.equals(-1, haystack.indexOf('ab\u{100}'));
+  Expect.throws(() => haystack.indexOf('ab', haystack.length + 1));
+}
+
+void testCaseConversion() {
+  final ascii = 'The Quick Brown Fox @[`{ 0123456789 ~' * 20;
+  final lower = ascii.toLowerCase();
+  final upper = ascii.toUpperCase();
+  for (int i = 0; i < ascii.length; i++) {
+    final c = ascii.codeUnitAt(i);
+    final isUpper = c >= 0x41 && c <= 0x5A;
+    final isLower = c >= 0x61 && c <= 0x7A;
+    Expect.equals(isUpper ? c + 0x20 : c, lower.codeUnitAt(i));
+    Expect.equals(isLower ? c - 0x20 : c, upper.codeUnitAt(i));
+  }
+  Expect.identical(lower, lower.toLowerCase());
+  Expect.identical(upper, upper.toUpperCase());
+
+  // Latin-1 letters outside of ASCII, some of which map to two-byte code
+  // units.
+  Expect.equals('ÀÉ Ÿ' * 40, ('àé ÿ' * 40).toUpperCase());
+  Expect.equals('Ÿµ'.toLowerCase(), 'ÿµ');
+  Expect.equals('\u{178}\u{39C}', 'ÿµ'.toUpperCase());
+}
+
+void main() {
+  testIndexOf();
+  testCaseConversion();
+}
@@ -0,0 +1,121 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation --no-loop-unrolling
+
+// Verifies that unrolled counted loops compute the same results as the
+// original loops.
+
+import 'dart:typed_data';
+
+import 'package:expect/expect.dart';
+
+@pragma('vm:never-inline')
+int hashUp(int x) {
+  int h = 0;
+  for (int i = 0; i < 16; i++) {
+    h = h * x + i;
+  }
+  return h;
+}
+
+@pragma('vm:never-inline')
+int hashDown(int x) {
+  int h = 7;
+  for (int i = 12; i > 0; i--) {
+    h = (h ^ i) * x;
+  }
+  return h;
+}
+
+@pragma('vm:never-inline')
+int swap(int a, int b) {
+  // The phis of a and b swap their values every iteration.
+  for (int i = 0; i < 8; i++) {
+    final t = a;
+    a = b + i;
+    b = t;
+  }
+  return a * 1000 + b;
+}
+
+@pragma('vm:never-inline')
+int exitValue() {
+  int i = 3;
+  int j = 100;
+  for (; i < 23; i++) {
+    j -= 2;
+  }
+  return i * 1000 + j;
+}
+
+@pragma('vm:never-inline')
+int sumBytes(Uint8List bytes) {
+  int sum = 0;
+  for (int i = 0; i < 64; i++) {
+    sum += bytes[i] * (i + 1);
+  }
+  return sum;
+}
+
+@pragma('vm:never-inline')
+void fillWords(Uint32List words, int seed) {
+  for (int i = 0; i < 16; i++) {
+    seed = (seed * 1103515245 + 12345) & 0xffffffff;
+    words[i] = seed;
+  }
+}
+
+@pragma('vm:never-inline')
+double sumDoubles(Float64List values) {
+  double sum = 0.0;
+  for (int i = 0; i < 32; i++) {
+    sum += values[i] * 0.5;
+  }
+  return sum;
+}
+
+int referenceHashUp(int x) {
+  int h = 0;
+  for (int i = 0; i < 16; i++) {
+    h = h * x + i;
+    if (h == -1) print(h); // Prevent unrolling.
+  }
+  return h;
+}
+
+void main() {
+  final bytes = Uint8List(64);
+  for (int i = 0; i < bytes.length; i++) {
+    bytes[i] = (i * 37) & 0xff;
+  }
+  int expectedSum = 0;
+  for (int i = 0; i < 64; i++) {
+    expectedSum += ((i * 37) & 0xff) * (i + 1);
+  }
+
+  final values = Float64List(32);
+  for (int i = 0; i < values.length; i++) {
+    values[i] = i * 1.5;
+  }
+
+  for (int k = 0; k < 100; k++) {
+    Expect.equals(referenceHashUp(31), hashUp(31));
+    Expect.equals(referenceHashUp(-5), hashUp(-5));
+    Expect.equals(8897692922228675711, hashDown(31));
+    Expect.equals(19017, swap(3, 5));
+    Expect.equals(23060, exitValue());
+    Expect.equals(expectedSum, sumBytes(bytes));
+    Expect.equals(372.0, sumDoubles(values));
+
+    final words = Uint32List(16);
+    fillWords(words, k);
+    int seed = k;
+    for (int i = 0; i < 16; i++) {
+      seed = (seed * 1103515245 + 12345) & 0xffffffff;
+      Expect.equals(seed, words[i]);
+    }
+  }
+}
@@ -0,0 +1,175 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation --no-loop-vectorization
+
+// Verifies that vectorized typed data loops compute the same results as the
+// original loops, including the elements after the last full vector.
+
+import 'dart:typed_data';
+
+import 'package:expect/expect.dart';
+
+@pragma('vm:never-inline')
+void scale(Float32List a, Float32List b) {
+  for (int i = 0; i < a.length; i++) {
+    b[i] = a[i] * 1.5;
+  }
+}
+
+@pragma('vm:never-inline')
+void divide(Float32List a, Float32List b, Float32List c) {
+  for (int i = 0; i < c.length; i++) {
+    c[i] = a[i] / b[i];
+  }
+}
+
+@pragma('vm:never-inline')
+void greater(Float32List a, Float32List b, Int32List c) {
+  for (int i = 0; i < c.length; i++) {
+    c[i] = a[i] > b[i] ? 3 : -5;
+  }
+}
+
+@pragma('vm:never-inline')
+void addWords(Int32List a, Uint32List b) {
+  for (int i = 0; i < a.length; i++) {
+    b[i] = a[i] + 0x7fffffff;
+  }
+}
+
+@pragma('vm:never-inline')
+void maskBytes(Uint8List a, Uint8List b, int start) {
+  for (int i = start; i < a.length; i++) {
+    b[i] = (a[i] & 0xf0) ^ 0x0f;
+  }
+}
+
+@pragma('vm:never-inline')
+void copyBytes(Uint8List from, Uint8List to) {
+  for (int i = 0; i < from.length; i++) {
+    to[i] = from[i];
+  }
+}
+
+@pragma('vm:never-inline')
+void checked(Int32List a, Int32List b, int n) {
+  for (int i = 0; i < n; i++) {
+    b[i] = a[i] | 1;
+  }
+}
+
+double toFloat(double x) => (Float32List(1)..[0] = x)[0];
+
+void expectFloat(double expected, double actual) {
+  if (expected.isNaN) {
+    Expect.isTrue(actual.isNaN);
+  } else {
+    Expect.equals(expected, actual);
+  }
+}
+
+void testFloats(int length) {
+  final a = Float32List(length);
+  final b = Float32List(length);
+  for (int i = 0; i < length; i++) {
+    a[i] = i * 0.1 - 1.7;
+    b[i] = (i % 7) - 3.0;
+  }
+  if (length > 3) {
+    a[3] = double.nan;
+    b[2] = double.infinity;
+  }
+
+  final scaled = Float32List(length);
+  scale(a, scaled);
+  for (int i = 0; i < length; i++) {
+    expectFloat(toFloat(a[i] * 1.5), scaled[i]);
+  }
+
+  final quotients = Float32List(length);
+  divide(a, b, quotients);
+  for (int i = 0; i < length; i++) {
+    expectFloat(toFloat(a[i] / b[i]), quotients[i]);
+  }
+
+  final flags = Int32List(length);
+  greater(a, b, flags);
+  for (int i = 0; i < length; i++) {
+    Expect.equals(a[i] > b[i] ? 3 : -5, flags[i]);
+  }
+}
+
+void testIntegers(int length) {
+  final a = Int32List(length);
+  for (int i = 0; i < length; i++) {
+    a[i] = i * 0x12345 - 0x40000000;
+  }
+  final b = Uint32List(length);
+  addWords(a, b);
+  for (int i = 0; i < length; i++) {
+    Expect.equals((a[i] + 0x7fffffff) & 0xffffffff, b[i]);
+  }
+
+  final bytes = Uint8List(length);
+  for (int i = 0; i < length; i++) {
+    bytes[i] = i * 37;
+  }
+  final masked = Uint8List(length);
+  for (final start in [0, 1, 5]) {
+    masked.fillRange(0, length, 0);
+    maskBytes(bytes, masked, start);
+    for (int i = 0; i < length; i++) {
+      Expect.equals(i < start ? 0 : (bytes[i] & 0xf0) ^ 0x0f, masked[i]);
+    }
+  }
+}
+
+void testAliasing() {
+  // Overlapping views of the same buffer must see each earlier store.
+  final buffer = Uint8List(64);
+  for (int i = 0; i < buffer.length; i++) {
+    buffer[i] = i;
+  }
+  final to = Uint8List.view(buffer.buffer, 1, 40);
+  final from = Uint8List.view(buffer.buffer, 0, 40);
+  copyBytes(from, to);
+  for (int i = 0; i <= 40; i++) {
+    Expect.equals(0, buffer[i]);
+  }
+  for (int i = 41; i < buffer.length; i++) {
+    Expect.equals(i, buffer[i]);
+  }
+
+  // The same array as source and destination.
+  final words = Int32List(21);
+  for (int i = 0; i < words.length; i++) {
+    words[i] = i * 2;
+  }
+  checked(words, words, words.length);
+  for (int i = 0; i < words.length; i++) {
+    Expect.equals(i * 2 + 1, words[i]);
+  }
+}
+
+void testBoundsCheck() {
+  final a = Int32List(10);
+  final b = Int32List(6);
+  Expect.throws<RangeError>(() => checked(a, b, 10));
+  for (int i = 0; i < b.length; i++) {
+    Expect.equals(1, b[i]);
+  }
+}
+
+void main() {
+  for (int k = 0; k < 20; k++) {
+    for (final length in [0, 1, 3, 4, 7, 16, 17, 33, 100]) {
+      testFloats(length);
+      testIntegers(length);
+    }
+    testAliasing();
+    testBoundsCheck();
+  }
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization-counter-threshold=100 --no-background-compilation
+// VMOptions=--optimization-counter-threshold=100 --no-background-compilation --no-specialize-osr-entry
+// VMOptions=--optimization-counter-threshold=100 --no-background-compilation --no-osr-code-cache
+
+// Verifies that loops entered through cached OSR code, which may have been
+// specialized for the classes of the values in an earlier frame, compute
+// the right results when the classes of the values change.
+
+import 'package:expect/expect.dart';
+
+@pragma('vm:never-inline')
+int sumLengths(Object values, int n) {
+  int sum = 0;
+  for (int i = 0; i < n; i++) {
+    if (values is List) {
+      sum += values.length;
+    } else if (values is String) {
+      sum += values.length * 2;
+    } else {
+      sum += 1;
+    }
+  }
+  return sum;
+}
+
+@pragma('vm:never-inline')
+num accumulate(num start, int n) {
+  num value = start;
+  for (int i = 0; i < n; i++) {
+    value = value + 1;
+  }
+  return value;
+}
+
+@pragma('vm:never-inline')
+int lateInLoop(bool initialize, int n) {
+  late int value;
+  if (initialize) value = 3;
+  int sum = 0;
+  for (int i = 0; i < n; i++) {
+    if (initialize) {
+      sum += value;
+    } else {
+      sum += 1;
+    }
+  }
+  return sum;
+}
+
+void main() {
+  const n = 1000;
+  for (int k = 0; k < 5; k++) {
+    Expect.equals(3 * n, sumLengths(<int>[1, 2, 3], n));
+    Expect.equals(4 * n, sumLengths('ab', n));
+    Expect.equals(n, sumLengths(42, n));
+    Expect.equals(2 * n, sumLengths(List<String>.filled(2, ''), n));
+
+    Expect.equals(n, accumulate(0, n));
+    Expect.equals(n + 0.5, accumulate(0.5, n));
+    Expect.equals(n, accumulate(0, n));
+
+    Expect.equals(3 * n, lateInLoop(true, n));
+    Expect.equals(n, lateInLoop(false, n));
+  }
+}
@@ -0,0 +1,126 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation
+// VMOptions=--optimization-counter-threshold=10 --no-background-compilation --no-partial-escape-analysis
+
+// Verifies that allocations eliminated through phis or sunk into the paths
+// where they escape behave like the original allocations.
+
+import 'package:expect/expect.dart';
+
+class Point {
+  final int x;
+  final int y;
+  Point(this.x, this.y);
+}
+
+class Box {
+  int value;
+  Box(this.value);
+}
+
+final escaped = <Object>[];
+
+@pragma('vm:never-inline')
+void keep(Object o) {
+  escaped.add(o);
+}
+
+@pragma('vm:never-inline')
+void bump(Box b) {
+  b.value++;
+}
+
+@pragma('vm:never-inline')
+int merge(bool c, int a, int b) {
+  final p = c ? Point(a, b) : Point(b, a);
+  return p.x * 10 + p.y;
+}
+
+@pragma('vm:never-inline')
+int fibonacci(int n) {
+  var p = Point(0, 1);
+  for (int i = 0; i < n; i++) {
+    p = Point(p.y, p.x + p.y);
+  }
+  return p.x;
+}
+
+@pragma('vm:never-inline')
+int records(bool c, int a) {
+  final (q, r) = c ? (a, 0) : (a ~/ 3, a % 3);
+  return q * 100 + r;
+}
+
+@pragma('vm:never-inline')
+int sinkOne(bool c, int a, int b) {
+  final p = Point(a, b);
+  if (c) keep(p);
+  return p.x + p.y;
+}
+
+@pragma('vm:never-inline')
+int sinkTwice(int mode, int a) {
+  final p = Point(a, -a);
+  if (mode == 1) {
+    keep(p);
+    keep(p);
+  } else if (mode == 2) {
+    keep(p);
+  }
+  return p.x;
+}
+
+@pragma('vm:never-inline')
+int escapeAfterJoin(bool c, int a) {
+  final p = Point(a, a);
+  if (c) keep(p);
+  keep(p);
+  return p.y;
+}
+
+@pragma('vm:never-inline')
+int mutated(bool c, int v) {
+  final b = Box(v);
+  if (c) bump(b);
+  return b.value;
+}
+
+void main() {
+  for (int i = 0; i < 100; i++) {
+    Expect.equals(12, merge(true, 1, 2));
+    Expect.equals(21, merge(false, 1, 2));
+    Expect.equals(55, fibonacci(10));
+    Expect.equals(0, fibonacci(0));
+    Expect.equals(700, records(true, 7));
+    Expect.equals(201, records(false, 7));
+
+    escaped.clear();
+    Expect.equals(3, sinkOne(false, 1, 2));
+    Expect.equals(0, escaped.length);
+    Expect.equals(7, sinkOne(true, 3, 4));
+    Expect.equals(1, escaped.length);
+    final p = escaped[0] as Point;
+    Expect.equals(3, p.x);
+    Expect.equals(4, p.y);
+
+    escaped.clear();
+    Expect.equals(5, sinkTwice(1, 5));
+    Expect.equals(2, escaped.length);
+    Expect.identical(escaped[0], escaped[1]);
+    Expect.equals(-5, (escaped[0] as Point).y);
+    Expect.equals(6, sinkTwice(2, 6));
+    Expect.equals(7, sinkTwice(3, 7));
+    Expect.equals(3, escaped.length);
+
+    escaped.clear();
+    Expect.equals(8, escapeAfterJoin(true, 8));
+    Expect.equals(2, escaped.length);
+    Expect.identical(escaped[0], escaped[1]);
+
+    Expect.equals(1, mutated(false, 1));
+    Expect.equals(2, mutated(true, 1));
+  }
+}
@@ -0,0 +1,108 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// This test ensures that gen_snapshot prints consistent dispatch table
+// statistics with --print-dispatch-table-stats, with and without dense
+// packing of the table, and that the resulting snapshots run.
+
+// OtherResources=dispatch_table_dense_packing_test.dart
+
+import "dart:io";
+
+import 'package:expect/expect.dart';
+import 'package:path/path.dart' as path;
+
+import 'use_flag_test_helper.dart';
+
+final rowsRegExp = RegExp(r'^Dispatch table: (\d+) classes, (\d+) selector '
+    r'rows \((\d+) at small offsets\)$');
+final entriesRegExp = RegExp(r'^Dispatch table: (\d+) entries, (\d+) used '
+    r'\((\d+\.\d)% full, (\d+) by rows at small offsets\)$');
+
+class DispatchTableStats {
+  final int classes;
+  final int rows;
+  final int smallOffsetRows;
+  final int entries;
+  final int usedEntries;
+  final int smallOffsetEntries;
+
+  DispatchTableStats(List<String> lines)
+      : this._(lines.map(rowsRegExp.firstMatch).singleWhere((m) => m != null)!,
+            lines.map(entriesRegExp.firstMatch).singleWhere((m) => m != null)!);
+
+  DispatchTableStats._(RegExpMatch rows, RegExpMatch entries)
+      : classes = int.parse(rows[1]!),
+        rows = int.parse(rows[2]!),
+        smallOffsetRows = int.parse(rows[3]!),
+        entries = int.parse(entries[1]!),
+        usedEntries = int.parse(entries[2]!),
+        smallOffsetEntries = int.parse(entries[4]!) {
+    Expect.isTrue(classes > 0);
+    Expect.isTrue(this.rows > 0);
+    Expect.isTrue(smallOffsetRows <= this.rows);
+    Expect.isTrue(usedEntries <= this.entries);
+    Expect.isTrue(smallOffsetEntries <= usedEntries);
+    Expect.equals(
+        (100 * usedEntries / this.entries).toStringAsFixed(1), entries[3]);
+  }
+}
+
+main(List<String> args) async {
+  if (!isAOTRuntime) {
+    return; // Running in JIT: AOT binaries not available.
+  }
+
+  if (Platform.isAndroid) {
+    return; // SDK tree and gen_snapshot not available on the test device.
+  }
+
+  // These are the tools we need to be available to run on a given platform:
+  if (!await testExecutable(genSnapshot)) {
+    throw "Cannot run test as $genSnapshot not available";
+  }
+  if (!await testExecutable(dartPrecompiledRuntime)) {
+    throw "Cannot run test as $dartPrecompiledRuntime not available";
+  }
+  if (!File(platformDill).existsSync()) {
+    throw "Cannot run test as $platformDill does not exist";
+  }
+
+  await withTempDir('print-dispatch-table-stats-flag-test',
+      (String tempDir) async {
+    final cwDir = path.dirname(Platform.script.toFilePath());
+    final script = path.join(cwDir, 'dispatch_table_dense_packing_test.dart');
+    final scriptDill = path.join(tempDir, 'flag_program.dill');
+
+    await run(genKernel, <String>[
+      '--aot',
+      '--platform=$platformDill',
+      '-o',
+      scriptDill,
+      script,
+    ]);
+
+    Future<DispatchTableStats> compile(List<String> flags) async {
+      final snapshot = path.join(tempDir, 'snapshot.so');
+      final lines = await runOutput(genSnapshot, <String>[
+        '--print-dispatch-table-stats',
+        ...flags,
+        '--snapshot-kind=app-aot-elf',
+        '--elf=$snapshot',
+        scriptDill,
+      ]);
+      final stats = DispatchTableStats(lines);
+      await run(dartPrecompiledRuntime, <String>[snapshot]);
+      return stats;
+    }
+
+    final sparse = await compile(<String>[]);
+    final dense = await compile(<String>[
+      '--sort-abstract-classes-last',
+      '--dispatch-table-dense-packing',
+    ]);
+    Expect.equals(sparse.classes, dense.classes);
+    Expect.equals(sparse.rows, dense.rows);
+  });
+}
@@ -170,7 +170,8 @@ checkDeterministicSnapshot(String snapshotKind, String expectedStdout) async {
 }
 
 runAppJitTest(Uri testScriptUri,
-    {Future<Result> Function(String snapshotPath)? runSnapshot}) async {
+    {Future<Result> Function(String snapshotPath)? runSnapshot,
+    List<String> trainingArguments = const <String>[]}) async {
   runSnapshot ??=
       (snapshotPath) => runDart('RUN FROM SNAPSHOT', [snapshotPath]);
 
@@ -182,6 +183,7 @@ runAppJitTest(Uri testScriptUri,
       '--snapshot=$snapshotPath',
       '--snapshot-kind=app-jit',
       '--verbosity=warning',
+      ...trainingArguments,
       testPath,
       '--train'
     ]);
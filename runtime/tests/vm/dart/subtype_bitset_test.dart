@@ -0,0 +1,108 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// Verifies is and as tests against interfaces implemented by classes in many
+// unrelated hierarchies, whose subtypes span many class id ranges. When
+// precompiling, these are tested with class id bitsets.
+
+import 'package:expect/expect.dart';
+
+abstract class I {}
+
+abstract class J {}
+
+class A0 {}
+
+class A1 extends A0 implements I {}
+
+class A2 extends A0 {}
+
+class A3 extends A2 implements J {}
+
+class B0 {}
+
+class B1 extends B0 implements I, J {}
+
+class B2 extends B0 {}
+
+class C0 implements J {}
+
+class C1 extends C0 implements I {}
+
+class C2 extends C0 {}
+
+class D0 {}
+
+class D1 extends D0 {}
+
+class D2 extends D1 implements I {}
+
+class E0 implements I {}
+
+class E1 extends E0 {}
+
+class F0 {}
+
+class F1 extends F0 implements I {}
+
+class F2 extends F0 implements J {}
+
+class G0 implements J {}
+
+class G1 extends G0 {}
+
+class G2 extends G1 implements I {}
+
+class H0 {}
+
+class H1 extends H0 implements J {}
+
+final subtypesOfIOnly = <Object>[A1(), D2(), E0(), E1(), F1()];
+final subtypesOfJOnly = <Object>[A3(), C0(), C2(), F2(), G0(), G1(), H1()];
+final subtypesOfBoth = <Object>[B1(), C1(), G2()];
+final subtypesOfNeither = <Object>[
+  A0(), A2(), B0(), B2(), D0(), D1(), F0(), H0(), 1, 1.5, 'I', //
+];
+
+@pragma('vm:never-inline')
+bool isI(Object? o) => o is I;
+
+@pragma('vm:never-inline')
+bool isJ(Object? o) => o is J;
+
+@pragma('vm:never-inline')
+bool isNullableI(Object? o) => o is I?;
+
+@pragma('vm:never-inline')
+I asI(Object? o) => o as I;
+
+@pragma('vm:never-inline')
+I? asNullableI(Object? o) => o as I?;
+
+void check(Object? o, bool expectI, bool expectJ) {
+  Expect.equals(expectI, isI(o));
+  Expect.equals(expectJ, isJ(o));
+  Expect.equals(expectI || o == null, isNullableI(o));
+  if (expectI) {
+    Expect.identical(o, asI(o));
+    Expect.identical(o, asNullableI(o));
+  } else {
+    Expect.throwsTypeError(() => asI(o));
+    if (o == null) {
+      Expect.isNull(asNullableI(o));
+    } else {
+      Expect.throwsTypeError(() => asNullableI(o));
+    }
+  }
+}
+
+void main() {
+  for (int i = 0; i < 20; i++) {
+    subtypesOfIOnly.forEach((o) => check(o, true, false));
+    subtypesOfJOnly.forEach((o) => check(o, false, true));
+    subtypesOfBoth.forEach((o) => check(o, true, true));
+    subtypesOfNeither.forEach((o) => check(o, false, false));
+    check(null, false, false);
+  }
+}
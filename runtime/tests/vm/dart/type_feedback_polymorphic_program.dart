@@ -0,0 +1,109 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// A program whose polymorphic calls see different receivers depending on its
+// arguments. Without arguments it trains the calls on circles and squares.
+// With 'shifted' the calls also see classes which were never recorded,
+// including a subclass of a recorded class which overrides its method.
+
+abstract class Shape {
+  int area();
+  String get name;
+}
+
+class Circle extends Shape {
+  final int r;
+  Circle(this.r);
+  int area() => 3 * r * r;
+  String get name => 'circle';
+}
+
+class Square extends Shape {
+  final int side;
+  Square(this.side);
+  int area() => side * side;
+  String get name => 'square';
+}
+
+class Rect extends Shape {
+  final int w, h;
+  Rect(this.w, this.h);
+  int area() => w * h;
+  String get name => 'rect';
+}
+
+class Triangle extends Shape {
+  final int b, h;
+  Triangle(this.b, this.h);
+  int area() => b * h ~/ 2;
+  String get name => 'triangle';
+}
+
+class Hexagon extends Shape {
+  final int side;
+  Hexagon(this.side);
+  int area() => 5 * side * side ~/ 2;
+  String get name => 'hexagon';
+}
+
+class UnitSquare extends Square {
+  UnitSquare() : super(1);
+  int area() => -1;
+  String get name => 'unit square';
+}
+
+class NotAShape {
+  String get name => 'not a shape';
+}
+
+@pragma('vm:never-inline')
+int sumAreas(List<Shape> shapes) {
+  int sum = 0;
+  for (final shape in shapes) {
+    sum += shape.area();
+  }
+  return sum;
+}
+
+@pragma('vm:never-inline')
+String describe(dynamic object) {
+  try {
+    return '${object.name}: ${object.area()}';
+  } on NoSuchMethodError {
+    return '${object.name}: no area';
+  }
+}
+
+List<Shape> trainingShapes(int i) => <Shape>[
+      Circle(i % 5),
+      Square(i % 7),
+      Circle(i % 3),
+      if (i % 50 == 0) Rect(i % 4, 2),
+    ];
+
+List<Shape> shiftedShapes(int i) => <Shape>[
+      Triangle(i % 6, 4),
+      Hexagon(i % 3),
+      UnitSquare(),
+      Square(i % 7),
+      Rect(i % 4, 2),
+    ];
+
+void main(List<String> args) {
+  final shifted = args.contains('shifted');
+  int total = 0;
+  final descriptions = <String>{};
+  for (int i = 0; i < 20000; i++) {
+    final shapes = shifted ? shiftedShapes(i) : trainingShapes(i);
+    total += sumAreas(shapes);
+    for (final shape in shapes) {
+      descriptions.add(describe(shape));
+    }
+  }
+  descriptions.add(describe(NotAShape()));
+  print(total);
+  for (final description in descriptions.toList()..sort()) {
+    print(description);
+  }
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// This test ensures that an AOT snapshot compiled with the type feedback of a
+// JIT run computes the same results as the JIT, both for the receivers its
+// polymorphic calls were specialized for and for receivers that only show up
+// when the AOT snapshot runs, which take the fallback calls.
+
+// OtherResources=type_feedback_polymorphic_program.dart
+
+import "dart:io";
+
+import 'package:expect/expect.dart';
+import 'package:path/path.dart' as path;
+
+import 'use_flag_test_helper.dart';
+
+main(List<String> args) async {
+  if (!isAOTRuntime) {
+    return; // Running in JIT: AOT binaries not available.
+  }
+
+  if (Platform.isAndroid) {
+    return; // SDK tree and gen_snapshot not available on the test device.
+  }
+
+  // These are the tools we need to be available to run on a given platform:
+  if (!await testExecutable(genSnapshot)) {
+    throw "Cannot run test as $genSnapshot not available";
+  }
+  if (!await testExecutable(dart)) {
+    throw "Cannot run test as $dart not available";
+  }
+  if (!await testExecutable(dartPrecompiledRuntime)) {
+    throw "Cannot run test as $dartPrecompiledRuntime not available";
+  }
+  if (!File(platformDill).existsSync()) {
+    throw "Cannot run test as $platformDill does not exist";
+  }
+
+  await withTempDir('type-feedback-polymorphic-test', (String tempDir) async {
+    final cwDir = path.dirname(Platform.script.toFilePath());
+    final script = path.join(cwDir, 'type_feedback_polymorphic_program.dart');
+    final scriptDill = path.join(tempDir, 'polymorphic_program.dill');
+    final aotDill = path.join(tempDir, 'polymorphic_program_aot.dill');
+    final feedback = path.join(tempDir, 'polymorphic_program.feedback');
+    final snapshot = path.join(tempDir, 'polymorphic_program.so');
+
+    await run(genKernel, <String>[
+      '--platform=$platformDill',
+      '-o',
+      scriptDill,
+      script,
+    ]);
+    await run(genKernel, <String>[
+      '--aot',
+      '--platform=$platformDill',
+      '-o',
+      aotDill,
+      script,
+    ]);
+
+    // Train the polymorphic calls on circles and squares.
+    final trained = await runOutput(dart, <String>[
+      '--write-type-feedback=$feedback',
+      scriptDill,
+    ]);
+    final calls = File(feedback)
+        .readAsLinesSync()
+        .where((line) => line.startsWith('C\t'))
+        .toList();
+    Expect.isTrue(calls.any((line) =>
+        line.contains('\tarea\t') &&
+        line.contains('\tCircle\t') &&
+        line.contains('\tSquare\t')));
+
+    final result = await runHelper(genSnapshot, <String>[
+      '--type-feedback=$feedback',
+      '--snapshot-kind=app-aot-elf',
+      '--elf=$snapshot',
+      aotDill,
+    ]);
+    Expect.equals(0, result.exitCode, 'gen_snapshot failed');
+    Expect.isFalse(result.stderr.contains('Ignoring type feedback'));
+
+    // The receivers the calls were specialized for.
+    Expect.listEquals(
+        trained, await runOutput(dartPrecompiledRuntime, <String>[snapshot]));
+
+    // Receivers the JIT run has never seen.
+    final shifted = await runOutput(dart, <String>[scriptDill, 'shifted']);
+    Expect.isTrue(shifted.contains('unit square: -1'));
+    Expect.listEquals(
+        shifted,
+        await runOutput(
+            dartPrecompiledRuntime, <String>[snapshot, 'shifted']));
+  });
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// This test ensures that the AOT snapshot generated with
+// --precompiler-compile-tasks does not depend on the number of threads.
+
+// OtherResources=use_save_debugging_info_flag_program.dart
+
+import "dart:io";
+
+import 'package:expect/expect.dart';
+import 'package:path/path.dart' as path;
+
+import 'use_flag_test_helper.dart';
+
+main(List<String> args) async {
+  if (!isAOTRuntime) {
+    return; // Running in JIT: AOT binaries not available.
+  }
+
+  if (Platform.isAndroid) {
+    return; // SDK tree and dart_bootstrap not available on the test device.
+  }
+
+  // These are the tools we need to be available to run on a given platform:
+  if (!await testExecutable(genSnapshot)) {
+    throw "Cannot run test as $genSnapshot not available";
+  }
+  if (!File(platformDill).existsSync()) {
+    throw "Cannot run test as $platformDill does not exist";
+  }
+
+  await withTempDir('precompiler-compile-tasks-flag-test',
+      (String tempDir) async {
+    final cwDir = path.dirname(Platform.script.toFilePath());
+    // We can just reuse the program for the use_save_debugging_info_flag test.
+    final script =
+        path.join(cwDir, 'use_save_debugging_info_flag_program.dart');
+    final scriptDill = path.join(tempDir, 'flag_program.dill');
+
+    // Compile script to Kernel IR.
+    await run(genKernel, <String>[
+      '--aot',
+      '--platform=$platformDill',
+      '-o',
+      scriptDill,
+      script,
+    ]);
+
+    Future<List<int>> generateSnapshot(int tasks) async {
+      final snapshot = path.join(tempDir, 'snapshot_$tasks.so');
+      await run(genSnapshot, <String>[
+        '--precompiler-compile-tasks=$tasks',
+        '--snapshot-kind=app-aot-elf',
+        '--elf=$snapshot',
+        scriptDill,
+      ]);
+      return File(snapshot).readAsBytes();
+    }
+
+    final expected = await generateSnapshot(1);
+    for (final tasks in [2, 4]) {
+      final actual = await generateSnapshot(tasks);
+      Expect.listEquals(expected, actual,
+          'snapshot generated with $tasks tasks differs');
+    }
+  });
+}
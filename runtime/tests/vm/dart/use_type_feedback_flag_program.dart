@@ -0,0 +1,24 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// A program with a few hot functions, whose code is laid out first when
+// precompiling with the type feedback of a JIT run.
+
+@pragma('vm:never-inline')
+int hot(int i) => i.isEven ? i ~/ 2 : 3 * i + 1;
+
+@pragma('vm:never-inline')
+int warm(int i) => i % 7;
+
+@pragma('vm:never-inline')
+int cold(int i) => -i;
+
+void main(List<String> args) {
+  int sum = cold(args.length);
+  for (int i = 0; i < 100000; i++) {
+    sum += hot(i);
+    if (i % 100 == 0) sum += warm(i);
+  }
+  print(sum);
+}
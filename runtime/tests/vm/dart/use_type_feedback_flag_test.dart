@@ -0,0 +1,89 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+// This test ensures that gen_snapshot can lay out the code of an AOT snapshot
+// by the hotness recorded in the type feedback of a JIT run.
+
+// OtherResources=use_type_feedback_flag_program.dart
+
+import "dart:io";
+
+import 'package:expect/expect.dart';
+import 'package:path/path.dart' as path;
+
+import 'use_flag_test_helper.dart';
+
+main(List<String> args) async {
+  if (!isAOTRuntime) {
+    return; // Running in JIT: AOT binaries not available.
+  }
+
+  if (Platform.isAndroid) {
+    return; // SDK tree and gen_snapshot not available on the test device.
+  }
+
+  // These are the tools we need to be available to run on a given platform:
+  if (!await testExecutable(genSnapshot)) {
+    throw "Cannot run test as $genSnapshot not available";
+  }
+  if (!await testExecutable(dart)) {
+    throw "Cannot run test as $dart not available";
+  }
+  if (!await testExecutable(dartPrecompiledRuntime)) {
+    throw "Cannot run test as $dartPrecompiledRuntime not available";
+  }
+  if (!File(platformDill).existsSync()) {
+    throw "Cannot run test as $platformDill does not exist";
+  }
+
+  await withTempDir('use-type-feedback-flag-test', (String tempDir) async {
+    final cwDir = path.dirname(Platform.script.toFilePath());
+    final script = path.join(cwDir, 'use_type_feedback_flag_program.dart');
+    final scriptDill = path.join(tempDir, 'flag_program.dill');
+    final aotDill = path.join(tempDir, 'flag_program_aot.dill');
+    final feedback = path.join(tempDir, 'flag_program.feedback');
+
+    await run(genKernel, <String>[
+      '--platform=$platformDill',
+      '-o',
+      scriptDill,
+      script,
+    ]);
+    await run(genKernel, <String>[
+      '--aot',
+      '--platform=$platformDill',
+      '-o',
+      aotDill,
+      script,
+    ]);
+
+    // Record the type feedback of a JIT run.
+    final expected = await runOutput(dart, <String>[
+      '--write-type-feedback=$feedback',
+      scriptDill,
+    ]);
+    Expect.isTrue(File(feedback).readAsStringSync().contains('\thot\t'));
+
+    for (final order in [
+      '--order-code-by-hotness',
+      '--no-order-code-by-hotness',
+    ]) {
+      final snapshot = path.join(tempDir, 'snapshot.so');
+      final result = await runHelper(genSnapshot, <String>[
+        '--type-feedback=$feedback',
+        order,
+        '--snapshot-kind=app-aot-elf',
+        '--elf=$snapshot',
+        aotDill,
+      ]);
+      Expect.equals(0, result.exitCode, 'gen_snapshot $order failed');
+      Expect.isFalse(result.stderr.contains('Ignoring type feedback'));
+
+      final actual = await runOutput(dartPrecompiledRuntime, <String>[
+        snapshot,
+      ]);
+      Expect.listEquals(expected, actual);
+    }
+  });
+}
@@ -27,10 +27,15 @@
 #include "vm/object_store.h"
 #include "vm/program_visitor.h"
 #include "vm/raw_object_fields.h"
+#include "vm/reverse_pc_lookup_cache.h"
+#include "vm/snapshot_compression.h"
 #include "vm/stub_code.h"
 #include "vm/symbols.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/v8_snapshot_writer.h"
+#include "vm/virtual_memory.h"
 #include "vm/version.h"
 #include "vm/zone_text_buffer.h"
 
@@ -40,6 +45,10 @@
 #include "vm/compiler/relocation.h"
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
+#if defined(DART_PRECOMPILER)
+#include "vm/compiler/type_feedback.h"
+#endif  // defined(DART_PRECOMPILER)
+
 namespace dart {
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -47,8 +56,30 @@ DEFINE_FLAG(bool,
             print_cluster_information,
             false,
             "Print information about clusters written to snapshot");
+DEFINE_FLAG(bool,
+            compress_snapshot_clusters,
+            false,
+            "Compress the clustered part of isolate snapshots.");
 #endif
 
+DEFINE_FLAG(bool,
+            lazy_snapshot_string_hashes,
+            true,
+            "Compute hashes of non-canonical strings read from snapshots on "
+            "first use instead of while reading the snapshot.");
+
+DEFINE_FLAG(int,
+            snapshot_fill_tasks,
+            2,
+            "The number of tasks to use for filling snapshot clusters which "
+            "do not depend on other clusters.");
+
+DEFINE_FLAG(int,
+            snapshot_decompression_tasks,
+            4,
+            "The number of tasks to use for decompressing compressed "
+            "snapshot clusters.");
+
 #if defined(DART_PRECOMPILER)
 DEFINE_FLAG(charp,
             write_v8_snapshot_profile_to,
@@ -59,6 +90,12 @@ DEFINE_FLAG(bool,
             false,
             "Print information about how many array are candidates for Smi and "
             "ROData optimizations.");
+DEFINE_FLAG(bool,
+            order_code_by_hotness,
+            true,
+            "Lay out AOT code from the most to the least frequently executed "
+            "function, using the type feedback given by --type_feedback if "
+            "any.");
 #endif  // defined(DART_PRECOMPILER)
 
 // Forward declarations.
@@ -233,6 +270,19 @@ class DeserializationCluster : public ZoneAllocated {
   // Initialize the cluster's objects. Do not touch the memory of other objects.
   virtual void ReadFill(Deserializer* deserializer) = 0;
 
+  // Whether [ReadFill] only reads the snapshot stream and the ref array, and
+  // therefore can run on a helper thread concurrently with the filling of
+  // other clusters (see [ReadFillRange]).
+  virtual bool CanReadFillConcurrently() const { return false; }
+
+  // Same as [ReadFill], but reads the fill section located at
+  // [start, end) of the snapshot without touching the deserializer's stream.
+  virtual void ReadFillRange(Deserializer* deserializer,
+                             intptr_t start,
+                             intptr_t end) {
+    UNREACHABLE();
+  }
+
   // Complete any action that requires the full graph to be deserialized, such
   // as rehashing.
   virtual void PostLoad(Deserializer* deserializer, const Array& refs) {
@@ -285,6 +335,10 @@ static constexpr intptr_t kUnreachableReference = 0;
 COMPILE_ASSERT(kUnreachableReference == WeakTable::kNoValue);
 static constexpr intptr_t kFirstReference = 1;
 
+#if defined(DEBUG)
+static constexpr int32_t kSectionMarker = 0xABAB;
+#endif
+
 // Reference value for traced objects that have not been allocated their final
 // reference ID.
 static constexpr intptr_t kUnallocatedReference = -1;
@@ -350,6 +404,9 @@ class Serializer : public ThreadStackResource {
   }
 
   void WriteVersionAndFeatures(bool is_vm_snapshot);
+  // Replaces everything written after the version and features with its
+  // compressed form. Must be called before [FillHeader].
+  void CompressClusters();
 
   ZoneGrowableArray<Object*>* Serialize(SerializationRoots* roots);
   void PrintSnapshotSizes();
@@ -570,6 +627,12 @@ class Serializer : public ThreadStackResource {
   bool HasRef(ObjectPtr object) const {
     return IsAllocatedReference(heap_->GetObjectId(object));
   }
+#if defined(DART_PRECOMPILER)
+  // The executed block counts used to order the code, or nullptr (see
+  // [Precompiler::SaveExecutedBlockCounts]).
+  const Array* executed_block_counts() const { return executed_block_counts_; }
+#endif
+
   // Whether the object only appears in the V8 snapshot profile.
   bool HasArtificialRef(ObjectPtr object) const {
     return IsArtificialReference(heap_->GetObjectId(object));
@@ -611,6 +674,7 @@ class Serializer : public ThreadStackResource {
 
   intptr_t dispatch_table_size_ = 0;
   intptr_t bytes_heap_allocated_ = 0;
+  intptr_t compression_format_position_ = -1;
   intptr_t instructions_table_len_ = 0;
   intptr_t instructions_table_rodata_offset_ = 0;
 
@@ -637,6 +701,7 @@ class Serializer : public ThreadStackResource {
 #if defined(DART_PRECOMPILER)
   IntMap<intptr_t> deduped_instructions_sources_;
   IntMap<intptr_t> code_index_;
+  const Array* executed_block_counts_ = nullptr;
 #endif
 
   intptr_t current_loading_unit_id_ = 0;
@@ -681,6 +746,8 @@ class Deserializer : public ThreadStackResource {
   ApiErrorPtr VerifyImageAlignment();
 
   ObjectPtr Allocate(intptr_t size);
+  // The number of heap bytes allocated for the objects read so far.
+  intptr_t bytes_allocated() const { return bytes_allocated_; }
   static void InitializeHeader(ObjectPtr raw,
                                intptr_t cid,
                                intptr_t size,
@@ -761,6 +828,10 @@ class Deserializer : public ThreadStackResource {
 
   DeserializationCluster* ReadCluster();
 
+  // Fills the clusters which allow it concurrently on helper threads, given
+  // the start of each cluster's fill section in [fill_positions].
+  void ReadFillConcurrently(const intptr_t* fill_positions);
+
   void ReadDispatchTable() {
     ReadDispatchTable(&stream_, /*deferred=*/false, InstructionsTable::Handle(),
                       -1, -1);
@@ -782,6 +853,15 @@ class Deserializer : public ThreadStackResource {
 #endif
   }
   bool is_non_root_unit() const { return is_non_root_unit_; }
+  // Whether objects read so far point into the clustered data rather than
+  // holding a copy of it (see [ExternalTypedDataDeserializationCluster]).
+  bool references_clusters() const { return references_clusters_; }
+  void set_references_clusters() { references_clusters_ = true; }
+  // Set when the clustered data is an anonymous mapping, whose pages read
+  // back as zeros rather than the snapshot after [VirtualMemory::DontNeed].
+  void set_clusters_are_anonymous(bool value) {
+    clusters_are_anonymous_ = value;
+  }
   void set_code_start_index(intptr_t value) { code_start_index_ = value; }
   intptr_t code_start_index() const { return code_start_index_; }
   void set_code_stop_index(intptr_t value) { code_stop_index_ = value; }
@@ -800,13 +880,34 @@ class Deserializer : public ThreadStackResource {
         : ReadStream(d->stream_.buffer_, d->stream_.current_, d->stream_.end_),
           d_(d),
           refs_(d->refs_),
-          null_(Object::null()) {
+          null_(Object::null()),
+          is_range_(false) {
 #if defined(DEBUG)
       // Can't mix use of Deserializer::Read*.
       d->stream_.current_ = nullptr;
 #endif
     }
-    ~Local() { d_->stream_.current_ = current_; }
+    // Reads the fill section at [start, end) independently of the
+    // deserializer's own stream.
+    Local(Deserializer* d, intptr_t start, intptr_t end)
+        : ReadStream(d->stream_.buffer_,
+                     d->stream_.buffer_ + start,
+                     d->stream_.buffer_ + end),
+          d_(d),
+          refs_(d->refs_),
+          null_(Object::null()),
+          is_range_(true) {}
+    ~Local() {
+      if (is_range_) {
+#if defined(DEBUG)
+        int32_t section_marker = Read<int32_t>();
+        ASSERT(section_marker == kSectionMarker);
+#endif
+        ASSERT(current_ == end_);
+      } else {
+        d_->stream_.current_ = current_;
+      }
+    }
 
     ObjectPtr Ref(intptr_t index) const {
       ASSERT(index > 0);
@@ -851,6 +952,7 @@ class Deserializer : public ThreadStackResource {
     Deserializer* const d_;
     const ArrayPtr refs_;
     const ObjectPtr null_;
+    const bool is_range_;
   };
 
  private:
@@ -869,13 +971,17 @@ class Deserializer : public ThreadStackResource {
   intptr_t code_start_index_ = 0;
   intptr_t code_stop_index_ = 0;
   intptr_t instructions_index_ = 0;
+  intptr_t bytes_allocated_ = 0;
   DeserializationCluster** clusters_;
   const bool is_non_root_unit_;
+  bool references_clusters_ = false;
+  bool clusters_are_anonymous_ = false;
   InstructionsTable& instructions_table_;
 };
 
 DART_FORCE_INLINE
 ObjectPtr Deserializer::Allocate(intptr_t size) {
+  bytes_allocated_ += size;
   return UntaggedObject::FromAddr(
       old_space_->AllocateSnapshotLocked(freelist_, size));
 }
@@ -2724,6 +2830,7 @@ class CodeSerializationCluster : public SerializationCluster {
     CodePtr code;
     intptr_t not_discarded;  // 1 if this code was not discarded and
                              // 0 otherwise.
+    intptr_t hotness;
     intptr_t instructions_id;
   };
 
@@ -2738,15 +2845,46 @@ class CodeSerializationCluster : public SerializationCluster {
   // there is no way to identify which specific Code object (out of those
   // which point to the specific instructions range) actually corresponds
   // to a particular frame.
+  //
+  // Within these groups code is ordered from the hottest to the coldest, so
+  // that frequently executed code shares cache lines and pages.
   static int CompareCodeOrderInfo(CodeOrderInfo const* a,
                                   CodeOrderInfo const* b) {
     if (a->not_discarded < b->not_discarded) return -1;
     if (a->not_discarded > b->not_discarded) return 1;
+    if (a->hotness > b->hotness) return -1;
+    if (a->hotness < b->hotness) return 1;
     if (a->instructions_id < b->instructions_id) return -1;
     if (a->instructions_id > b->instructions_id) return 1;
     return 0;
   }
 
+  // The hotness of functions executed in the profile is the number of blocks
+  // they executed. Code which was not profiled has hotness 0, and functions
+  // which run at most once or only on errors have hotness -1.
+  static intptr_t Hotness(Serializer* s, CodePtr code) {
+#if defined(DART_PRECOMPILER)
+    if (s->kind() != Snapshot::kFullAOT || !FLAG_order_code_by_hotness) {
+      return 0;
+    }
+    ObjectPtr owner =
+        WeakSerializationReference::Unwrap(code->untag()->owner());
+    if (!owner->IsHeapObject() || owner->GetClassId() != kFunctionCid) {
+      return 0;
+    }
+    const auto& function =
+        Function::Handle(s->zone(), Function::RawCast(owner));
+    if (function.IsFieldInitializer() || function.IsNoSuchMethodDispatcher()) {
+      return -1;
+    }
+    if (s->executed_block_counts() != nullptr) {
+      return TypeFeedback::LookupExecutedBlockCount(
+          *s->executed_block_counts(), function);
+    }
+#endif  // defined(DART_PRECOMPILER)
+    return 0;
+  }
+
   static void Insert(Serializer* s,
                      GrowableArray<CodeOrderInfo>* order_list,
                      IntMap<intptr_t>* order_map,
@@ -2768,6 +2906,7 @@ class CodeSerializationCluster : public SerializationCluster {
     info.code = code;
     info.instructions_id = instructions_id;
     info.not_discarded = Code::IsDiscarded(code) ? 0 : 1;
+    info.hotness = Hotness(s, code);
     order_list->Add(info);
   }
 
@@ -5728,25 +5867,37 @@ class TypedDataDeserializationCluster : public DeserializationCluster {
 
   void ReadFill(Deserializer* d_) override {
     Deserializer::Local d(d_);
+    FillObjects(&d);
+  }
+
+  bool CanReadFillConcurrently() const override { return true; }
+
+  void ReadFillRange(Deserializer* d_,
+                     intptr_t start,
+                     intptr_t end) override {
+    Deserializer::Local d(d_, start, end);
+    FillObjects(&d);
+  }
 
+ private:
+  void FillObjects(Deserializer::Local* d) {
     ASSERT(!is_canonical());  // Never canonical.
     intptr_t element_size = TypedData::ElementSizeInBytes(cid_);
 
     const intptr_t cid = cid_;
     for (intptr_t id = start_index_, n = stop_index_; id < n; id++) {
-      TypedDataPtr data = static_cast<TypedDataPtr>(d.Ref(id));
-      const intptr_t length = d.ReadUnsigned();
+      TypedDataPtr data = static_cast<TypedDataPtr>(d->Ref(id));
+      const intptr_t length = d->ReadUnsigned();
       const intptr_t length_in_bytes = length * element_size;
       Deserializer::InitializeHeader(data, cid,
                                      TypedData::InstanceSize(length_in_bytes));
       data->untag()->length_ = Smi::New(length);
       data->untag()->RecomputeDataField();
       uint8_t* cdata = reinterpret_cast<uint8_t*>(data->untag()->data());
-      d.ReadBytes(cdata, length_in_bytes);
+      d->ReadBytes(cdata, length_in_bytes);
     }
   }
 
- private:
   const intptr_t cid_;
 };
 
@@ -5874,6 +6025,10 @@ class ExternalTypedDataDeserializationCluster : public DeserializationCluster {
 
   void ReadAlloc(Deserializer* d) override {
     ReadAllocFixedSize(d, ExternalTypedData::InstanceSize());
+    if (stop_index_ > start_index_) {
+      // The payloads are used in place, see [ReadFill].
+      d->set_references_clusters();
+    }
   }
 
   void ReadFill(Deserializer* d_) override {
@@ -6498,27 +6653,39 @@ class ArrayDeserializationCluster
 
   void ReadFill(Deserializer* d_) override {
     Deserializer::Local d(d_);
+    FillObjects(&d);
+  }
+
+  bool CanReadFillConcurrently() const override { return true; }
 
+  void ReadFillRange(Deserializer* d_,
+                     intptr_t start,
+                     intptr_t end) override {
+    Deserializer::Local d(d_, start, end);
+    FillObjects(&d);
+  }
+
+ private:
+  void FillObjects(Deserializer::Local* d) {
     const intptr_t cid = cid_;
     const bool stamp_canonical = is_root_unit_ && is_canonical();
     for (intptr_t id = start_index_, n = stop_index_; id < n; id++) {
-      ArrayPtr array = static_cast<ArrayPtr>(d.Ref(id));
-      const intptr_t length = d.ReadUnsigned();
+      ArrayPtr array = static_cast<ArrayPtr>(d->Ref(id));
+      const intptr_t length = d->ReadUnsigned();
       Deserializer::InitializeHeader(array, cid, Array::InstanceSize(length),
                                      stamp_canonical);
       if (Array::UseCardMarkingForAllocation(length)) {
         array->untag()->SetCardRememberedBitUnsynchronized();
       }
       array->untag()->type_arguments_ =
-          static_cast<TypeArgumentsPtr>(d.ReadRef());
+          static_cast<TypeArgumentsPtr>(d->ReadRef());
       array->untag()->length_ = Smi::New(length);
       for (intptr_t j = 0; j < length; j++) {
-        array->untag()->data()[j] = d.ReadRef();
+        array->untag()->data()[j] = d->ReadRef();
       }
     }
   }
 
- private:
   const intptr_t cid_;
 };
 
@@ -6711,10 +6878,39 @@ class StringDeserializationCluster
 
   void ReadFill(Deserializer* d_) override {
     Deserializer::Local d(d_);
+    FillObjects(&d);
+  }
+
+  bool CanReadFillConcurrently() const override { return true; }
+
+  void ReadFillRange(Deserializer* d_,
+                     intptr_t start,
+                     intptr_t end) override {
+    Deserializer::Local d(d_, start, end);
+    FillObjects(&d);
+  }
+
+  void PostLoad(Deserializer* d, const Array& refs) override {
+    if (!table_.IsNull()) {
+      auto object_store = d->isolate_group()->object_store();
+      VerifyCanonicalSet(d, refs,
+                         WeakArray::Handle(object_store->symbol_table()));
+      object_store->set_symbol_table(table_);
+      if (d->isolate_group() == Dart::vm_isolate_group()) {
+        Symbols::InitFromSnapshot(d->isolate_group());
+      }
+#if defined(DEBUG)
+      Symbols::New(Thread::Current(), ":some:new:symbol:");
+      ASSERT(object_store->symbol_table() == table_.ptr());  // Did not rehash.
+#endif
+    }
+  }
 
+ private:
+  void FillObjects(Deserializer::Local* d) {
     for (intptr_t id = start_index_, n = stop_index_; id < n; id++) {
-      StringPtr str = static_cast<StringPtr>(d.Ref(id));
-      const intptr_t encoded = d.ReadUnsigned();
+      StringPtr str = static_cast<StringPtr>(d->Ref(id));
+      const intptr_t encoded = d->ReadUnsigned();
       intptr_t cid = 0;
       const intptr_t length = DecodeLengthAndCid(encoded, &cid);
       const intptr_t instance_size = InstanceSize(length, cid);
@@ -6743,18 +6939,37 @@ class StringDeserializationCluster
 #endif
       str->untag()->length_ = Smi::New(length);
 
+      if (!is_canonical() && FLAG_lazy_snapshot_string_hashes) {
+        // Non-canonical strings are not looked up in any table while the
+        // program is loaded, so their hash is computed when first needed.
+        // Two-byte strings are written as little-endian code units, which
+        // matches the in-heap layout on all supported targets.
+        const intptr_t length_in_bytes =
+            cid == kOneByteStringCid ? length : length * 2;
+        uint8_t* data =
+            cid == kOneByteStringCid
+                ? static_cast<OneByteStringPtr>(str)->untag()->data()
+                : reinterpret_cast<uint8_t*>(
+                      static_cast<TwoByteStringPtr>(str)->untag()->data());
+        d->ReadBytes(data, length_in_bytes);
+#if !defined(HASH_IN_OBJECT_HEADER)
+        str->untag()->hash_ = Smi::New(0);
+#endif
+        continue;
+      }
+
       StringHasher hasher;
       if (cid == kOneByteStringCid) {
         for (intptr_t j = 0; j < length; j++) {
-          uint8_t code_unit = d.Read<uint8_t>();
+          uint8_t code_unit = d->Read<uint8_t>();
           static_cast<OneByteStringPtr>(str)->untag()->data()[j] = code_unit;
           hasher.Add(code_unit);
         }
 
       } else {
         for (intptr_t j = 0; j < length; j++) {
-          uint16_t code_unit = d.Read<uint8_t>();
-          code_unit = code_unit | (d.Read<uint8_t>() << 8);
+          uint16_t code_unit = d->Read<uint8_t>();
+          code_unit = code_unit | (d->Read<uint8_t>() << 8);
           static_cast<TwoByteStringPtr>(str)->untag()->data()[j] = code_unit;
           hasher.Add(code_unit);
         }
@@ -6762,22 +6977,6 @@ class StringDeserializationCluster
       String::SetCachedHash(str, hasher.Finalize());
     }
   }
-
-  void PostLoad(Deserializer* d, const Array& refs) override {
-    if (!table_.IsNull()) {
-      auto object_store = d->isolate_group()->object_store();
-      VerifyCanonicalSet(d, refs,
-                         WeakArray::Handle(object_store->symbol_table()));
-      object_store->set_symbol_table(table_);
-      if (d->isolate_group() == Dart::vm_isolate_group()) {
-        Symbols::InitFromSnapshot(d->isolate_group());
-      }
-#if defined(DEBUG)
-      Symbols::New(Thread::Current(), ":some:new:symbol:");
-      ASSERT(object_store->symbol_table() == table_.ptr());  // Did not rehash.
-#endif
-    }
-  }
 };
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -7046,6 +7245,7 @@ class ProgramSerializationRoots : public SerializationRoots {
   ONLY_IN_PRODUCT(ONLY_IN_AOT(                                                 \
       V(closure_functions, GrowableObjectArray, GrowableObjectArray::null()))) \
   ONLY_IN_AOT(V(closure_functions_table, Array, Array::null()))                \
+  V(closure_functions_indices, Array, Array::null())                           \
   ONLY_IN_AOT(V(canonicalized_stack_map_entries, CompressedStackMaps,          \
                 CompressedStackMaps::null()))
 
@@ -7412,10 +7612,6 @@ class UnitDeserializationRoots : public DeserializationRoots {
   intptr_t deferred_stop_index_;
 };
 
-#if defined(DEBUG)
-static constexpr int32_t kSectionMarker = 0xABAB;
-#endif
-
 Serializer::Serializer(Thread* thread,
                        Snapshot::Kind kind,
                        NonStreamingWriteStream* stream,
@@ -8529,6 +8725,28 @@ void Serializer::WriteVersionAndFeatures(bool is_vm_snapshot) {
   WriteBytes(reinterpret_cast<const uint8_t*>(expected_features),
              features_len + 1);
   free(expected_features);
+
+  // Data aligned in the clusters (see [ExternalTypedData]) is aligned relative
+  // to the start of the snapshot. Start the clusters at an aligned offset, so
+  // the data stays aligned when they are decompressed into a separate buffer.
+  stream_->Align(ExternalTypedData::kDataSerializationAlignment,
+                 ExternalTypedData::kDataSerializationAlignment - 1);
+  compression_format_position_ = bytes_written();
+  stream_->WriteByte(SnapshotCompression::kUncompressed);
+}
+
+void Serializer::CompressClusters() {
+  TIMELINE_DURATION(thread(), Isolate, "CompressClusters");
+  ASSERT(compression_format_position_ >= 0);
+  const intptr_t start = compression_format_position_ + sizeof(uint8_t);
+  const intptr_t length = bytes_written() - start;
+  uint8_t* clusters = reinterpret_cast<uint8_t*>(malloc(length));
+  memmove(clusters, stream_->buffer() + start, length);
+  stream_->buffer()[compression_format_position_] =
+      SnapshotCompression::kBlockLZ77;
+  stream_->SetPosition(start);
+  SnapshotCompression::Compress(clusters, length, stream_);
+  free(clusters);
 }
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
@@ -8558,6 +8776,16 @@ ZoneGrowableArray<Object*>* Serializer::Serialize(SerializationRoots* roots) {
       this, V8SnapshotProfileWriter::kArtificialRootId);
   roots->AddBaseObjects(this);
 
+#if defined(DART_PRECOMPILER)
+  if (kind() == Snapshot::kFullAOT && FLAG_order_code_by_hotness) {
+    const auto& counts = Array::Handle(
+        zone(), isolate_group()->object_store()->executed_block_counts());
+    if (!counts.IsNull()) {
+      executed_block_counts_ = &counts;
+    }
+  }
+#endif  // defined(DART_PRECOMPILER)
+
   NoSafepointScope no_safepoint;
 
   roots->PushRoots(this);
@@ -8709,11 +8937,25 @@ ZoneGrowableArray<Object*>* Serializer::Serialize(SerializationRoots* roots) {
   }
 #endif
 
-  for (SerializationCluster* cluster : clusters) {
-    cluster->WriteAndMeasureFill(this);
+  // Reserve room for the sizes of the fill sections, which allow the
+  // deserializer to fill independent clusters concurrently. The sizes are
+  // written with a fixed width so they can be patched in below.
+  const intptr_t fill_sizes_position = bytes_written();
+  for (intptr_t i = 0; i < clusters.length(); i++) {
+    stream_->WriteFixed<uint32_t>(0);
+  }
+
+  for (intptr_t i = 0; i < clusters.length(); i++) {
+    const intptr_t fill_start = bytes_written();
+    clusters[i]->WriteAndMeasureFill(this);
 #if defined(DEBUG)
     Write<int32_t>(kSectionMarker);
 #endif
+    const intptr_t fill_size = bytes_written() - fill_start;
+    RELEASE_ASSERT(Utils::IsUint(32, fill_size));
+    const uint32_t encoded_size = static_cast<uint32_t>(fill_size);
+    memmove(stream_->buffer() + fill_sizes_position + i * sizeof(uint32_t),
+            &encoded_size, sizeof(uint32_t));
   }
 
   roots->WriteRoots(this);
@@ -9491,6 +9733,9 @@ void Deserializer::EndInstructions() {
     ASSERT((!is_non_root_unit_ && tables.Length() == 0) ||
            (is_non_root_unit_ && tables.Length() > 0));
     tables.Add(instructions_table_, Heap::kOld);
+    // The cache is keyed on pcs only, so drop it whenever the set of tables
+    // searched by ReversePc changes.
+    IsolateGroup::Current()->reverse_pc_cache()->Clear();
   }
 #endif
 }
@@ -9514,6 +9759,99 @@ class HeapLocker : public StackResource {
   FreeList* freelist_;
 };
 
+class ReadFillTask : public ThreadPool::Task {
+ public:
+  ReadFillTask(IsolateGroup* isolate_group,
+               Deserializer* deserializer,
+               DeserializationCluster** clusters,
+               const intptr_t* fill_positions,
+               intptr_t num_clusters,
+               RelaxedAtomic<intptr_t>* next_cluster,
+               ThreadBarrier* barrier)
+      : isolate_group_(isolate_group),
+        deserializer_(deserializer),
+        clusters_(clusters),
+        fill_positions_(fill_positions),
+        num_clusters_(num_clusters),
+        next_cluster_(next_cluster),
+        barrier_(barrier) {}
+
+  void Run() override {
+    if (!barrier_->TryEnter()) {
+      barrier_->Release();
+      return;
+    }
+
+    bool result =
+        Thread::EnterIsolateGroupAsHelper(isolate_group_, Thread::kUnknownTask,
+                                          /*bypass_safepoint=*/true);
+    ASSERT(result);
+
+    RunEnteredIsolateGroup();
+
+    Thread::ExitIsolateGroupAsHelper(/*bypass_safepoint=*/true);
+
+    // This task is done. Notify the original thread.
+    barrier_->Sync();
+    barrier_->Release();
+  }
+
+  void RunEnteredIsolateGroup() {
+    // The clusters only write to their own (already allocated) objects, so
+    // no safepoint may happen until they are all filled.
+    NoSafepointScope no_safepoint;
+    while (true) {
+      const intptr_t i = next_cluster_->fetch_add(1u);
+      if (i >= num_clusters_) break;
+      DeserializationCluster* cluster = clusters_[i];
+      if (!cluster->CanReadFillConcurrently()) continue;
+      cluster->ReadFillRange(deserializer_, fill_positions_[i],
+                             fill_positions_[i + 1]);
+    }
+  }
+
+ private:
+  IsolateGroup* isolate_group_;
+  Deserializer* deserializer_;
+  DeserializationCluster** clusters_;
+  const intptr_t* fill_positions_;
+  const intptr_t num_clusters_;
+  RelaxedAtomic<intptr_t>* next_cluster_;
+  ThreadBarrier* barrier_;
+
+  DISALLOW_COPY_AND_ASSIGN(ReadFillTask);
+};
+
+void Deserializer::ReadFillConcurrently(const intptr_t* fill_positions) {
+  intptr_t num_concurrent_clusters = 0;
+  for (intptr_t i = 0; i < num_clusters_; i++) {
+    if (clusters_[i]->CanReadFillConcurrently()) {
+      num_concurrent_clusters++;
+    }
+  }
+  const intptr_t num_tasks =
+      Utils::Minimum<intptr_t>(FLAG_snapshot_fill_tasks,
+                               num_concurrent_clusters);
+  if (num_tasks == 0) {
+    return;
+  }
+
+  ThreadBarrier* barrier = new ThreadBarrier(num_tasks, 1);
+  RelaxedAtomic<intptr_t> next_cluster = {0};
+  for (intptr_t task_index = 0; task_index < num_tasks - 1; task_index++) {
+    // Begin filling on a helper thread.
+    Dart::thread_pool()->Run<ReadFillTask>(
+        thread()->isolate_group(), this, clusters_, fill_positions,
+        num_clusters_, &next_cluster, barrier);
+  }
+  // Last worker is the main thread.
+  ReadFillTask task(thread()->isolate_group(), this, clusters_,
+                    fill_positions, num_clusters_, &next_cluster, barrier);
+  task.RunEnteredIsolateGroup();
+  barrier->Sync();
+  barrier->Release();
+}
+
 void Deserializer::Deserialize(DeserializationRoots* roots) {
   const void* clustered_start = AddressOfCurrentPosition();
 
@@ -9592,13 +9930,36 @@ void Deserializer::Deserialize(DeserializationRoots* roots) {
 
     {
       TIMELINE_DURATION(thread(), Isolate, "ReadFill");
+      intptr_t* fill_positions = zone_->Alloc<intptr_t>(num_clusters_ + 1);
+      fill_positions[0] = position() + num_clusters_ * sizeof(uint32_t);
+      for (intptr_t i = 0; i < num_clusters_; i++) {
+        uint32_t fill_size;
+        ReadBytes(reinterpret_cast<uint8_t*>(&fill_size), sizeof(uint32_t));
+        fill_positions[i + 1] = fill_positions[i] + fill_size;
+      }
+      ASSERT(position() == fill_positions[0]);
+
+      // The VM snapshot is small and is read before helper threads can enter
+      // its isolate group.
+      const bool fill_concurrently =
+          FLAG_snapshot_fill_tasks > 1 &&
+          !thread()->isolate_group()->is_vm_isolate();
+      if (fill_concurrently) {
+        ReadFillConcurrently(fill_positions);
+      }
       for (intptr_t i = 0; i < num_clusters_; i++) {
+        if (fill_concurrently && clusters_[i]->CanReadFillConcurrently()) {
+          set_position(fill_positions[i + 1]);
+          continue;
+        }
+        ASSERT(position() == fill_positions[i]);
         clusters_[i]->ReadFill(this);
 #if defined(DEBUG)
         int32_t section_marker = Read<int32_t>();
         ASSERT(section_marker == kSectionMarker);
 #endif
       }
+      ASSERT(position() == fill_positions[num_clusters_]);
     }
 
     roots->ReadRoots(this);
@@ -9628,7 +9989,10 @@ void Deserializer::Deserialize(DeserializationRoots* roots) {
     }
   }
 
-  if (isolate_group->snapshot_is_dontneed_safe()) {
+  // Pages of an anonymous mapping would read back as zeros, so keep them if
+  // any payloads are used in place.
+  if (isolate_group->snapshot_is_dontneed_safe() &&
+      !(clusters_are_anonymous_ && references_clusters_)) {
     size_t clustered_length =
         reinterpret_cast<uword>(AddressOfCurrentPosition()) -
         reinterpret_cast<uword>(clustered_start);
@@ -9729,6 +10093,9 @@ void FullSnapshotWriter::WriteProgramSnapshot(
   if (units != nullptr) {
     (*units)[LoadingUnit::kRootId]->set_objects(objects);
   }
+  if (FLAG_compress_snapshot_clusters) {
+    serializer.CompressClusters();
+  }
   serializer.FillHeader(serializer.kind());
   clustered_isolate_size_ = serializer.bytes_written();
   heap_isolate_size_ = serializer.bytes_heap_allocated();
@@ -9768,6 +10135,9 @@ void FullSnapshotWriter::WriteUnitSnapshot(
   UnitSerializationRoots roots(unit);
   unit->set_objects(serializer.Serialize(&roots));
 
+  if (FLAG_compress_snapshot_clusters) {
+    serializer.CompressClusters();
+  }
   serializer.FillHeader(serializer.kind());
   clustered_isolate_size_ = serializer.bytes_written();
 
@@ -9822,6 +10192,91 @@ void FullSnapshotWriter::WriteFullSnapshot(
 }
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 
+// The clustered part of a snapshot, following its version and features. If
+// it was written with --compress_snapshot_clusters, it is decompressed into a
+// temporary buffer which lives as long as this object.
+class ClusteredSnapshotData : public ValueObject {
+ public:
+  ClusteredSnapshotData(const uint8_t* buffer, intptr_t size, intptr_t offset)
+      : buffer_(buffer), size_(size), offset_(offset) {}
+
+  // Returns a malloc'd error message if the clusters cannot be read.
+  char* Initialize(Thread* thread);
+
+  const uint8_t* buffer() const { return buffer_; }
+  intptr_t size() const { return size_; }
+  intptr_t offset() const { return offset_; }
+  bool is_decompressed() const { return decompressed_ != nullptr; }
+
+  // Hands the decompressed clusters over to [isolate_group] if objects read
+  // by [deserializer] point into them, as they would otherwise be freed with
+  // this reader.
+  void RetainIfReferenced(IsolateGroup* isolate_group,
+                          const Deserializer& deserializer) {
+    if (is_decompressed() && deserializer.references_clusters()) {
+      isolate_group->RetainSnapshotClusters(std::move(decompressed_));
+    }
+  }
+
+ private:
+  const uint8_t* buffer_;
+  intptr_t size_;
+  intptr_t offset_;
+  std::unique_ptr<VirtualMemory> decompressed_;
+
+  DISALLOW_COPY_AND_ASSIGN(ClusteredSnapshotData);
+};
+
+char* ClusteredSnapshotData::Initialize(Thread* thread) {
+  // Skip the padding before the format, see
+  // [Serializer::WriteVersionAndFeatures].
+  const intptr_t alignment = ExternalTypedData::kDataSerializationAlignment;
+  offset_ = Utils::RoundUp(offset_, alignment, alignment - 1);
+  if (offset_ >= size_) {
+    return Utils::StrDup("Truncated snapshot");
+  }
+  const uint8_t format = buffer_[offset_++];
+  if (format == SnapshotCompression::kUncompressed) {
+    return nullptr;
+  }
+  if (format != SnapshotCompression::kBlockLZ77) {
+    return Utils::SCreate("Unknown snapshot compression format %u", format);
+  }
+
+  const uint8_t* compressed = buffer_ + offset_;
+  const intptr_t compressed_length = size_ - offset_;
+  const intptr_t length =
+      SnapshotCompression::UncompressedLength(compressed, compressed_length);
+  if (length < 0) {
+    return Utils::StrDup("Malformed compressed snapshot");
+  }
+#if defined(SUPPORT_TIMELINE)
+  TimelineBeginEndScope tbes(thread, Timeline::GetIsolateStream(),
+                             "DecompressClusters");
+  tbes.SetNumArguments(2);
+  tbes.FormatArgument(0, "compressedBytes", "%" Pd, compressed_length);
+  tbes.FormatArgument(1, "uncompressedBytes", "%" Pd, length);
+#endif
+  // Use a separate mapping rather than malloc, so the deserializer may
+  // release the pages it has read, see [Deserializer::Deserialize].
+  decompressed_.reset(VirtualMemory::Allocate(
+      Utils::RoundUp(Utils::Maximum<intptr_t>(length, 1),
+                     VirtualMemory::PageSize()),
+      /*is_executable=*/false, /*is_compressed=*/false, "snapshot-clusters"));
+  if (decompressed_ == nullptr) {
+    return Utils::StrDup("Out of memory decompressing snapshot");
+  }
+  uint8_t* out = reinterpret_cast<uint8_t*>(decompressed_->address());
+  if (!SnapshotCompression::Decompress(compressed, compressed_length, out,
+                                       FLAG_snapshot_decompression_tasks)) {
+    return Utils::StrDup("Malformed compressed snapshot");
+  }
+  buffer_ = out;
+  size_ = length;
+  offset_ = 0;
+  return nullptr;
+}
+
 FullSnapshotReader::FullSnapshotReader(const Snapshot* snapshot,
                                        const uint8_t* instructions_buffer,
                                        Thread* thread)
@@ -9941,15 +10396,21 @@ ApiErrorPtr FullSnapshotReader::ReadVMSnapshot() {
   if (error != nullptr) {
     return ConvertToApiError(error);
   }
+  ClusteredSnapshotData clusters(buffer_, size_, offset);
+  error = clusters.Initialize(thread_);
+  if (error != nullptr) {
+    return ConvertToApiError(error);
+  }
 
   // Even though there's no concurrent threads we have to guard agains, some
   // logic we do in deserialization triggers common code that asserts the
   // program lock is held.
   SafepointWriteRwLocker ml(thread_, isolate_group()->program_lock());
 
-  Deserializer deserializer(thread_, kind_, buffer_, size_, data_image_,
-                            instructions_image_, /*is_non_root_unit=*/false,
-                            offset);
+  Deserializer deserializer(thread_, kind_, clusters.buffer(), clusters.size(),
+                            data_image_, instructions_image_,
+                            /*is_non_root_unit=*/false, clusters.offset());
+  deserializer.set_clusters_are_anonymous(clusters.is_decompressed());
   ApiErrorPtr api_error = deserializer.VerifyImageAlignment();
   if (api_error != ApiError::null()) {
     return api_error;
@@ -9966,6 +10427,7 @@ ApiErrorPtr FullSnapshotReader::ReadVMSnapshot() {
 
   VMDeserializationRoots roots;
   deserializer.Deserialize(&roots);
+  clusters.RetainIfReferenced(isolate_group(), deserializer);
 
 #if defined(DART_PRECOMPILED_RUNTIME)
   // Initialize entries in the VM portion of the BSS segment.
@@ -9979,6 +10441,19 @@ ApiErrorPtr FullSnapshotReader::ReadVMSnapshot() {
   return ApiError::null();
 }
 
+void FullSnapshotReader::UpdateSnapshotMetrics(
+    const Deserializer& deserializer) {
+  auto isolate_group = thread_->isolate_group();
+  auto materialized = isolate_group->GetSnapshotMaterializedMetric();
+  materialized->set_value(materialized->value() +
+                          deserializer.bytes_allocated());
+  if (Snapshot::IncludesCode(kind_)) {
+    // Objects in the read-only data image are used in place.
+    auto in_place = isolate_group->GetSnapshotInPlaceMetric();
+    in_place->set_value(in_place->value() + Image(data_image_).object_size());
+  }
+}
+
 ApiErrorPtr FullSnapshotReader::ReadProgramSnapshot() {
   SnapshotHeaderReader header_reader(kind_, buffer_, size_);
   header_reader.SetCoverageFromSnapshotFeatures(thread_->isolate_group());
@@ -9988,15 +10463,21 @@ ApiErrorPtr FullSnapshotReader::ReadProgramSnapshot() {
   if (error != nullptr) {
     return ConvertToApiError(error);
   }
+  ClusteredSnapshotData clusters(buffer_, size_, offset);
+  error = clusters.Initialize(thread_);
+  if (error != nullptr) {
+    return ConvertToApiError(error);
+  }
 
   // Even though there's no concurrent threads we have to guard agains, some
   // logic we do in deserialization triggers common code that asserts the
   // program lock is held.
   SafepointWriteRwLocker ml(thread_, isolate_group()->program_lock());
 
-  Deserializer deserializer(thread_, kind_, buffer_, size_, data_image_,
-                            instructions_image_, /*is_non_root_unit=*/false,
-                            offset);
+  Deserializer deserializer(thread_, kind_, clusters.buffer(), clusters.size(),
+                            data_image_, instructions_image_,
+                            /*is_non_root_unit=*/false, clusters.offset());
+  deserializer.set_clusters_are_anonymous(clusters.is_decompressed());
   ApiErrorPtr api_error = deserializer.VerifyImageAlignment();
   if (api_error != ApiError::null()) {
     return api_error;
@@ -10013,6 +10494,8 @@ ApiErrorPtr FullSnapshotReader::ReadProgramSnapshot() {
 
   ProgramDeserializationRoots roots(thread_->isolate_group()->object_store());
   deserializer.Deserialize(&roots);
+  clusters.RetainIfReferenced(isolate_group(), deserializer);
+  UpdateSnapshotMetrics(deserializer);
 
   if (Snapshot::IncludesCode(kind_)) {
     const auto& units = Array::Handle(
@@ -10041,10 +10524,18 @@ ApiErrorPtr FullSnapshotReader::ReadUnitSnapshot(const LoadingUnit& unit) {
   if (error != nullptr) {
     return ConvertToApiError(error);
   }
+  ClusteredSnapshotData clusters(buffer_, size_, offset);
+  error = clusters.Initialize(thread_);
+  if (error != nullptr) {
+    return ConvertToApiError(error);
+  }
 
   Deserializer deserializer(
-      thread_, kind_, buffer_, size_, data_image_, instructions_image_,
-      /*is_non_root_unit=*/unit.id() != LoadingUnit::kRootId, offset);
+      thread_, kind_, clusters.buffer(), clusters.size(), data_image_,
+      instructions_image_,
+      /*is_non_root_unit=*/unit.id() != LoadingUnit::kRootId,
+      clusters.offset());
+  deserializer.set_clusters_are_anonymous(clusters.is_decompressed());
   ApiErrorPtr api_error = deserializer.VerifyImageAlignment();
   if (api_error != ApiError::null()) {
     return api_error;
@@ -10073,6 +10564,8 @@ ApiErrorPtr FullSnapshotReader::ReadUnitSnapshot(const LoadingUnit& unit) {
 
   UnitDeserializationRoots roots(unit);
   deserializer.Deserialize(&roots);
+  clusters.RetainIfReferenced(isolate_group(), deserializer);
+  UpdateSnapshotMetrics(deserializer);
 
   InitializeBSS();
 
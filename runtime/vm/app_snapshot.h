@@ -35,6 +35,7 @@ namespace dart {
 // clusters do not require fixups.
 
 // Forward declarations.
+class Deserializer;
 class V8SnapshotProfileWriter;
 class ImageWriter;
 class Heap;
@@ -176,6 +177,9 @@ class FullSnapshotReader {
 
   ApiErrorPtr ConvertToApiError(char* message);
   void InitializeBSS();
+  // Accounts the objects read by [deserializer] in the isolate group's
+  // snapshot metrics.
+  void UpdateSnapshotMetrics(const Deserializer& deserializer);
 
   Snapshot::Kind kind_;
   Thread* thread_;
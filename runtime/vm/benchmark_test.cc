@@ -16,16 +16,22 @@
 #include "platform/utils.h"
 
 #include "vm/app_snapshot.h"
+#include "vm/closure_functions_cache.h"
 #include "vm/dart_api_impl.h"
 #include "vm/datastream.h"
 #include "vm/message_snapshot.h"
+#include "vm/snapshot_compression.h"
 #include "vm/stack_frame.h"
+#include "vm/symbols.h"
 #include "vm/timer.h"
 
 using dart::bin::File;
 
 namespace dart {
 
+DECLARE_FLAG(bool, compress_snapshot_clusters);
+DECLARE_FLAG(int, snapshot_decompression_tasks);
+
 Benchmark* Benchmark::first_ = nullptr;
 Benchmark* Benchmark::tail_ = nullptr;
 const char* Benchmark::executable_ = nullptr;
@@ -426,6 +432,80 @@ BENCHMARK_SIZE(StandaloneSnapshotSize) {
   benchmark->set_score(snapshot->length());
 }
 
+static const char* kCoreSnapshotScriptChars =
+    "import 'dart:async';\n"
+    "import 'dart:core';\n"
+    "import 'dart:collection';\n"
+    "import 'dart:_internal';\n"
+    "import 'dart:math';\n"
+    "import 'dart:isolate';\n"
+    "import 'dart:mirrors';\n"
+    "import 'dart:typed_data';\n"
+    "\n";
+
+BENCHMARK_SIZE(CompressedCoreSnapshotSize) {
+  TestCase::LoadCoreTestScript(kCoreSnapshotScriptChars, nullptr);
+
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+
+  Api::CheckAndFinalizePendingClasses(thread);
+
+  // Write snapshot with compressed object content.
+  FLAG_compress_snapshot_clusters = true;
+  MallocWriteStream vm_snapshot_data(FullSnapshotWriter::kInitialSize);
+  MallocWriteStream isolate_snapshot_data(FullSnapshotWriter::kInitialSize);
+  FullSnapshotWriter writer(
+      Snapshot::kFullCore, &vm_snapshot_data, &isolate_snapshot_data,
+      /*vm_image_writer=*/nullptr, /*iso_image_writer=*/nullptr);
+  writer.WriteFullSnapshot();
+  FLAG_compress_snapshot_clusters = false;
+  const Snapshot* snapshot =
+      Snapshot::SetupFromBuffer(isolate_snapshot_data.buffer());
+  ASSERT(snapshot->kind() == Snapshot::kFullCore);
+  benchmark->set_score(snapshot->length());
+}
+
+//
+// Measure decompression of the clusters of a core snapshot.
+//
+BENCHMARK(CoreSnapshotDecompression) {
+  TestCase::LoadCoreTestScript(kCoreSnapshotScriptChars, nullptr);
+
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+
+  Api::CheckAndFinalizePendingClasses(thread);
+
+  MallocWriteStream vm_snapshot_data(FullSnapshotWriter::kInitialSize);
+  MallocWriteStream isolate_snapshot_data(FullSnapshotWriter::kInitialSize);
+  FullSnapshotWriter writer(
+      Snapshot::kFullCore, &vm_snapshot_data, &isolate_snapshot_data,
+      /*vm_image_writer=*/nullptr, /*iso_image_writer=*/nullptr);
+  writer.WriteFullSnapshot();
+  const Snapshot* snapshot =
+      Snapshot::SetupFromBuffer(isolate_snapshot_data.buffer());
+  const uint8_t* clusters = snapshot->Addr() + Snapshot::kHeaderSize;
+  const intptr_t length = snapshot->length() - Snapshot::kHeaderSize;
+
+  MallocWriteStream compressed(FullSnapshotWriter::kInitialSize);
+  SnapshotCompression::Compress(clusters, length, &compressed);
+  uint8_t* out = reinterpret_cast<uint8_t*>(malloc(length));
+
+  const int kNumIterations = 100;
+  Timer timer;
+  timer.Start();
+  for (int i = 0; i < kNumIterations; i++) {
+    RELEASE_ASSERT(SnapshotCompression::Decompress(
+        compressed.buffer(), compressed.bytes_written(), out,
+        FLAG_snapshot_decompression_tasks));
+  }
+  timer.Stop();
+  ASSERT(memcmp(clusters, out, length) == 0);
+  free(out);
+  benchmark->set_score(timer.TotalElapsedTime() / kNumIterations);
+}
+
 BENCHMARK(CreateMirrorSystem) {
   const char* kScriptChars =
       "import 'dart:mirrors';\n"
@@ -564,6 +644,52 @@ BENCHMARK(LargeMap) {
   benchmark->set_score(elapsed_time);
 }
 
+//
+// Measure the lookup of closure functions and their indices, as done by the
+// compiler, the debugger and the service, among 100k closure functions.
+//
+BENCHMARK(ClosureFunctionsCacheLookup) {
+  const char* kScript = "foo() {}";
+  Dart_Handle h_lib = TestCase::LoadTestScript(kScript, nullptr);
+  EXPECT_VALID(h_lib);
+  TransitionNativeToVM transition(thread);
+  StackZone zone(thread);
+  const Library& lib =
+      Library::Handle(Library::RawCast(Api::UnwrapHandle(h_lib)));
+  const Function& parent = Function::Handle(lib.LookupFunctionAllowPrivate(
+      String::Handle(Symbols::New(thread, "foo"))));
+  EXPECT(!parent.IsNull());
+
+  const intptr_t kNumClosures = 100000;
+  const String& name = String::Handle(Symbols::New(thread, "<anonymous>"));
+  const Array& closures = Array::Handle(Array::New(kNumClosures, Heap::kOld));
+  Function& function = Function::Handle();
+  {
+    SafepointWriteRwLocker ml(thread, thread->isolate_group()->program_lock());
+    for (intptr_t i = 0; i < kNumClosures; i++) {
+      function = Function::NewClosureFunction(name, parent,
+                                              TokenPosition::Deserialize(i));
+      function.set_kernel_offset(i + 1);
+      ClosureFunctionsCache::AddClosureFunctionLocked(function);
+      closures.SetAt(i, function);
+    }
+  }
+
+  Timer timer;
+  timer.Start();
+  intptr_t sum = 0;
+  for (intptr_t i = 0; i < kNumClosures; i++) {
+    function ^= closures.At(i);
+    sum += ClosureFunctionsCache::FindClosureIndex(function);
+    function = ClosureFunctionsCache::LookupClosureFunction(parent, i + 1);
+    EXPECT(function.ptr() == closures.At(i));
+  }
+  timer.Stop();
+  EXPECT(sum > 0);
+  int64_t elapsed_time = timer.TotalElapsedTime();
+  benchmark->set_score(elapsed_time);
+}
+
 BENCHMARK_MEMORY(InitialRSS) {
   benchmark->set_score(bin::Process::MaxRSS());
 }
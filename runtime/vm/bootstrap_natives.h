@@ -120,8 +120,10 @@ namespace dart {
   V(StringBase_substringUnchecked, 3)                                          \
   V(StringBase_joinReplaceAllResult, 4)                                        \
   V(StringBase_intern, 1)                                                      \
+  V(StringBase_internAll, 1)                                                   \
   V(StringBuffer_createStringFromUint16Array, 3)                               \
   V(OneByteString_substringUnchecked, 3)                                       \
+  V(OneByteString_indexOf, 3)                                                  \
   V(OneByteString_allocateFromOneByteList, 3)                                  \
   V(TwoByteString_allocateFromTwoByteList, 3)                                  \
   V(String_getHashCode, 1)                                                     \
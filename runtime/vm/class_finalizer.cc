@@ -29,6 +29,12 @@ namespace dart {
 DEFINE_FLAG(bool, print_classes, false, "Prints details about loaded classes.");
 DEFINE_FLAG(bool, trace_class_finalization, false, "Trace class finalization.");
 DEFINE_FLAG(bool, trace_type_finalization, false, "Trace type finalization.");
+DEFINE_FLAG(bool,
+            sort_abstract_classes_last,
+            false,
+            "When sorting classes, number the abstract classes after all "
+            "concrete ones, so that the concrete subclasses of every class "
+            "have contiguous cids (e.g. for denser dispatch table rows).");
 
 bool ClassFinalizer::AllClassesFinalized() {
   ObjectStore* object_store = IsolateGroup::Current()->object_store();
@@ -963,6 +969,7 @@ void ClassFinalizer::SortClasses() {
 
   intptr_t next_new_cid = kNumPredefinedCids;
   GrowableArray<intptr_t> dfs_stack;
+  GrowableArray<intptr_t> abstract_cids;
   Class& cls = Class::Handle(Z);
   GrowableObjectArray& subclasses = GrowableObjectArray::Handle(Z);
 
@@ -986,10 +993,18 @@ void ClassFinalizer::SortClasses() {
     cls = table->At(cid);
     ASSERT(!cls.IsNull());
     if (old_to_new_cid[cid] == -1) {
-      old_to_new_cid[cid] = next_new_cid++;
-      if (FLAG_trace_class_finalization) {
-        THR_Print("%" Pd ": %s, was %" Pd "\n", old_to_new_cid[cid],
-                  cls.ToCString(), cid);
+      if (FLAG_sort_abstract_classes_last && cls.is_abstract()) {
+        // Numbered below. Instances only have the cids of concrete classes,
+        // so leaving the abstract ones out keeps the cids of the concrete
+        // classes in every subtree contiguous.
+        old_to_new_cid[cid] = -2;
+        abstract_cids.Add(cid);
+      } else {
+        old_to_new_cid[cid] = next_new_cid++;
+        if (FLAG_trace_class_finalization) {
+          THR_Print("%" Pd ": %s, was %" Pd "\n", old_to_new_cid[cid],
+                    cls.ToCString(), cid);
+        }
       }
     }
     subclasses = cls.direct_subclasses();
@@ -1002,6 +1017,16 @@ void ClassFinalizer::SortClasses() {
     }
   }
 
+  for (intptr_t i = 0; i < abstract_cids.length(); i++) {
+    const intptr_t cid = abstract_cids[i];
+    old_to_new_cid[cid] = next_new_cid++;
+    if (FLAG_trace_class_finalization) {
+      cls = table->At(cid);
+      THR_Print("%" Pd ": %s, was %" Pd "\n", old_to_new_cid[cid],
+                cls.ToCString(), cid);
+    }
+  }
+
   // Top-level classes, typedefs, patch classes, etc.
   for (intptr_t cid = kNumPredefinedCids; cid < num_cids; cid++) {
     if (old_to_new_cid[cid] == -1) {
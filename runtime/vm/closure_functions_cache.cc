@@ -23,6 +23,24 @@ class FunctionHashMapTraits {
 
 using FunctionHashMap = UnorderedHashMap<FunctionHashMapTraits>;
 
+static void AddClosureIndex(Zone* zone,
+                            FunctionHashMap* map,
+                            const Function& function,
+                            intptr_t index) {
+  // Keep the first index of functions added more than once, like a linear
+  // search of the list would.
+  map->InsertOrGetValue(function, Smi::Handle(zone, Smi::New(index)));
+}
+
+static intptr_t LookupClosureIndex(Zone* zone,
+                                   const Array& indices,
+                                   const Function& needle) {
+  FunctionHashMap map(zone, indices.ptr());
+  const ObjectPtr index = map.GetOrNull(needle);
+  map.Release();
+  return index == Object::null() ? -1 : Smi::Value(Smi::RawCast(index));
+}
+
 FunctionPtr ClosureFunctionsCache::LookupClosureFunction(
     const Function& member_function,
     intptr_t kernel_offset) {
@@ -86,6 +104,14 @@ void ClosureFunctionsCache::AddClosureFunctionLocked(
          function.IsNonImplicitClosureFunction());
   closures.Add(function, Heap::kOld);
 
+  auto& indices =
+      Array::Handle(zone, object_store->closure_functions_indices());
+  if (!indices.IsNull()) {
+    FunctionHashMap map(zone, indices.ptr());
+    AddClosureIndex(zone, &map, function, closures.Length() - 1);
+    object_store->set_closure_functions_indices(map.Release());
+  }
+
   if (allow_implicit_closure_functions) {
     return;
   }
@@ -116,19 +142,55 @@ intptr_t ClosureFunctionsCache::FindClosureIndex(const Function& needle) {
   auto zone = thread->zone();
   auto object_store = thread->isolate_group()->object_store();
 
-  SafepointReadRwLocker ml(thread, thread->isolate_group()->program_lock());
+  auto& closures_array = GrowableObjectArray::Handle(zone);
+  auto& indices = Array::Handle(zone);
+  {
+    SafepointReadRwLocker ml(thread, thread->isolate_group()->program_lock());
 
-  const auto& closures_array =
-      GrowableObjectArray::Handle(zone, object_store->closure_functions());
-  if (!closures_array.IsNull()) {
-    intptr_t num_closures = closures_array.Length();
-    for (intptr_t i = 0; i < num_closures; i++) {
-      if (closures_array.At(i) == needle.ptr()) {
-        return i;
+    closures_array = object_store->closure_functions();
+    if (closures_array.IsNull()) {
+      return -1;
+    }
+    indices = object_store->closure_functions_indices();
+    if (!indices.IsNull()) {
+      return LookupClosureIndex(zone, indices, needle);
+    }
+    if (Compiler::IsBackgroundCompilation()) {
+      // Leave building the index to the mutator.
+      const intptr_t num_closures = closures_array.Length();
+      for (intptr_t i = 0; i < num_closures; i++) {
+        if (closures_array.At(i) == needle.ptr()) {
+          return i;
+        }
       }
+      return -1;
+    }
+  }
+
+  SafepointWriteRwLocker ml(thread, thread->isolate_group()->program_lock());
+  indices = object_store->closure_functions_indices();
+  if (indices.IsNull()) {
+    closures_array = object_store->closure_functions();
+    const intptr_t num_closures = closures_array.Length();
+    FunctionHashMap map(
+        zone, HashTables::New<FunctionHashMap>(num_closures, Heap::kOld));
+    auto& function = Function::Handle(zone);
+    for (intptr_t i = 0; i < num_closures; i++) {
+      function ^= closures_array.At(i);
+      AddClosureIndex(zone, &map, function, i);
     }
+    indices = map.Release().ptr();
+    object_store->set_closure_functions_indices(indices);
   }
-  return -1;
+  return LookupClosureIndex(zone, indices, needle);
+}
+
+void ClosureFunctionsCache::ResetClosureIndicesLocked() {
+  auto thread = Thread::Current();
+  DEBUG_ASSERT(
+      thread->isolate_group()->program_lock()->IsCurrentThreadWriter());
+  thread->isolate_group()->object_store()->set_closure_functions_indices(
+      Object::null_array());
 }
 
 FunctionPtr ClosureFunctionsCache::ClosureFunctionFromIndex(intptr_t idx) {
@@ -31,6 +31,10 @@ class FunctionPtr;
 //   * closure functions list can grow while iterating
 //   * the index of closure function must be stable
 //
+// The indices of the closure functions in that list are looked up in a
+// Map<ClosureFunction, Index>, which is built on the first lookup (e.g. after
+// loading a snapshot) and then kept up to date as closure functions are added.
+//
 class ClosureFunctionsCache : public AllStatic {
  public:
   static FunctionPtr LookupClosureFunction(const Function& member_function,
@@ -47,9 +51,18 @@ class ClosureFunctionsCache : public AllStatic {
       const Function& function,
       bool allow_implicit_closure_functions = false);
 
+  // Returns the index of [needle] in the list of closure functions, or -1.
+  //
+  // Must not be called with the program lock held for reading, as building
+  // the index needs it for writing.
   static intptr_t FindClosureIndex(const Function& needle);
   static FunctionPtr ClosureFunctionFromIndex(intptr_t idx);
 
+  // Drops the index of the closure functions, e.g. after the list has been
+  // replaced or the hashes of the functions may have changed. It is rebuilt
+  // on the next lookup.
+  static void ResetClosureIndicesLocked();
+
   // Visits all closure functions registered in the object store.
   //
   // Iterates in-order, thereby allowing new closures being added during the
@@ -19,6 +19,7 @@
 #include "vm/compiler/frontend/flow_graph_builder.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/compiler/jit/jit_call_specializer.h"
+#include "vm/compiler/type_feedback.h"
 #include "vm/cpu.h"
 #include "vm/dart_entry.h"
 #include "vm/exceptions.h"
@@ -39,6 +40,12 @@ DEFINE_FLAG(int,
             "If a call receiver is known to be of at most this many classes, "
             "generate exhaustive class tests instead of a megamorphic call");
 
+DEFINE_FLAG(int,
+            type_feedback_min_receiver_percent,
+            10,
+            "Receiver classes seen in fewer than this percentage of the calls "
+            "recorded in the type feedback are not checked for");
+
 // Quick access to the current isolate and zone.
 #define IG (isolate_group())
 #define Z (zone())
@@ -982,6 +989,10 @@ void AotCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
     }
   }
 
+  if (targets.is_empty() && TryReplaceWithProfiledPolymorphicCall(instr)) {
+    return;
+  }
+
   // More than one target. Generate generic polymorphic call without
   // deoptimization.
   if (targets.length() > 0) {
@@ -996,6 +1007,67 @@ void AotCallSpecializer::VisitInstanceCall(InstanceCallInstr* instr) {
   }
 }
 
+bool AotCallSpecializer::TryReplaceWithProfiledPolymorphicCall(
+    InstanceCallInstr* instr) {
+  const TypeFeedback* feedback = precompiler_->type_feedback();
+  if (feedback == nullptr) {
+    return false;
+  }
+  // Calls of inlined functions have the token positions of the inlined
+  // function. They were specialized before they were inlined.
+  if (instr->has_inlining_id() && instr->inlining_id() != 0) {
+    return false;
+  }
+  const Function& function = flow_graph()->function();
+  const auto function_feedback = feedback->Lookup(function);
+  if (function_feedback == nullptr) {
+    return false;
+  }
+  const auto call_site = feedback->LookupCall(
+      *function_feedback, instr->token_pos(), instr->function_name());
+  if (call_site == nullptr || call_site->receivers->is_empty()) {
+    return false;
+  }
+
+  const Array& args_desc_array =
+      Array::Handle(Z, instr->GetArgumentsDescriptor());
+  const ICData& ic_data = ICData::Handle(
+      Z, ICData::New(function, instr->function_name(), args_desc_array,
+                     DeoptId::kNone, /*num_args_tested=*/1,
+                     ICData::kOptimized));
+  Class& cls = Class::Handle(Z);
+  Function& target = Function::Handle(Z);
+  intptr_t num_checks = 0;
+  for (const auto& receiver : *call_site->receivers) {
+    // Receivers are sorted by their counts.
+    if (receiver.count * 100 <
+        call_site->count * FLAG_type_feedback_min_receiver_percent) {
+      break;
+    }
+    if (num_checks == FLAG_max_polymorphic_checks) {
+      break;
+    }
+    cls = isolate_group()->class_table()->At(receiver.cid);
+    target = instr->ResolveForReceiverClass(cls);
+    if (target.IsNull()) {
+      continue;
+    }
+    ic_data.AddReceiverCheck(receiver.cid, target, receiver.count);
+    num_checks++;
+  }
+  if (num_checks == 0) {
+    return false;
+  }
+
+  // The receivers seen by the JIT are not all possible receivers, so the
+  // call stays incomplete: the inliner keeps a call for the other receivers.
+  const CallTargets* targets = CallTargets::Create(Z, ic_data);
+  PolymorphicInstanceCallInstr* call = PolymorphicInstanceCallInstr::FromCall(
+      Z, instr, *targets, /*complete=*/false);
+  instr->ReplaceWith(call, current_iterator());
+  return true;
+}
+
 void AotCallSpecializer::VisitStaticCall(StaticCallInstr* instr) {
   if (TryInlineFieldAccess(instr)) {
     return;
@@ -1127,7 +1199,7 @@ bool AotCallSpecializer::TryReplaceInstanceOfWithRangeCheck(
 
   intptr_t lower_limit, upper_limit;
   if (!hi->InstanceOfHasClassRange(type, &lower_limit, &upper_limit)) {
-    return false;
+    return TryReplaceInstanceOfWithBitsetCheck(call, type);
   }
 
   Definition* left = call->ArgumentAt(0);
@@ -1153,6 +1225,58 @@ bool AotCallSpecializer::TryReplaceInstanceOfWithRangeCheck(
   return true;
 }
 
+bool AotCallSpecializer::TryReplaceInstanceOfWithBitsetCheck(
+    InstanceCallInstr* call,
+    const AbstractType& type) {
+  if (type.IsNullable()) {
+    return false;
+  }
+  const TypedData* bitset = thread()->hierarchy_info()->SubtypeBitsetFor(type);
+  if (bitset == nullptr) {
+    return false;
+  }
+
+  // Tests bit (cid & 7) of byte (cid >> 3) of the bitset.
+  Definition* left = call->ArgumentAt(0);
+  LoadClassIdInstr* load_cid =
+      new (Z) LoadClassIdInstr(new (Z) Value(left), kTagged);
+  InsertBefore(call, load_cid, nullptr, FlowGraph::kValue);
+
+  Definition* byte_index = BinaryIntegerOpInstr::Make(
+      kTagged, Token::kSHR, new (Z) Value(load_cid),
+      new (Z) Value(flow_graph()->GetConstant(
+          Smi::Handle(Z, Smi::New(kBitsPerByteLog2)))),
+      DeoptId::kNone, Instruction::kNotSpeculative);
+  InsertBefore(call, byte_index, nullptr, FlowGraph::kValue);
+  Definition* byte = new (Z) LoadIndexedInstr(
+      new (Z) Value(flow_graph()->GetConstant(*bitset)),
+      new (Z) Value(byte_index), /*index_unboxed=*/false, /*index_scale=*/1,
+      kTypedDataUint8ArrayCid, kAlignedAccess, DeoptId::kNone, call->source());
+  InsertBefore(call, byte, nullptr, FlowGraph::kValue);
+
+  Definition* bit_index = BinaryIntegerOpInstr::Make(
+      kTagged, Token::kBIT_AND, new (Z) Value(load_cid),
+      new (Z) Value(flow_graph()->GetConstant(
+          Smi::Handle(Z, Smi::New(kBitsPerByte - 1)))),
+      DeoptId::kNone, Instruction::kNotSpeculative);
+  InsertBefore(call, bit_index, nullptr, FlowGraph::kValue);
+  Definition* mask = new (Z) LoadIndexedInstr(
+      new (Z) Value(flow_graph()->GetConstant(
+          Precompiler::Instance()->subtype_bit_masks())),
+      new (Z) Value(bit_index), /*index_unboxed=*/false, /*index_scale=*/1,
+      kTypedDataUint8ArrayCid, kAlignedAccess, DeoptId::kNone, call->source());
+  InsertBefore(call, mask, nullptr, FlowGraph::kValue);
+
+  const Representation representation =
+      TestIntInstr::IsSupported(kUnboxedInt64) ? kUnboxedInt64 : kTagged;
+  ReplaceCall(call,
+              new (Z) TestIntInstr(call->source(), Token::kNE, representation,
+                                   new (Z) Value(byte), new (Z) Value(mask)));
+  Precompiler::Instance()->RecordSubtypeBitsetCheck(/*in_stub=*/false);
+
+  return true;
+}
+
 void AotCallSpecializer::ReplaceInstanceCallsWithDispatchTableCalls() {
   ASSERT(current_iterator_ == nullptr);
   const intptr_t max_block_id = flow_graph()->max_block_id();
@@ -33,6 +33,11 @@ class AotCallSpecializer : public CallSpecializer {
                                                   const AbstractType& type);
 
  private:
+  // Replaces an instance-of test against a type whose subtypes span many
+  // class id ranges with a test of the type's subtype bitset.
+  bool TryReplaceInstanceOfWithBitsetCheck(InstanceCallInstr* call,
+                                           const AbstractType& type);
+
   // Attempt to build ICData for call using propagated class-ids.
   virtual bool TryCreateICData(InstanceCallInstr* call);
 
@@ -73,6 +78,10 @@ class AotCallSpecializer : public CallSpecializer {
   // RelationalOpInstr)
   bool TryOptimizeDoubleOperation(TemplateDartCall<0>* call, Token::Kind kind);
 
+  // If the type feedback recorded the receivers of [instr], replace it by a
+  // polymorphic call checking for the most frequent of them.
+  bool TryReplaceWithProfiledPolymorphicCall(InstanceCallInstr* instr);
+
   // Check if o.m(...) [call] is actually an invocation through a getter
   // o.get:m().call(...) given that the receiver of the call is a subclass
   // of the [receiver_class]. If it is - then expand it into
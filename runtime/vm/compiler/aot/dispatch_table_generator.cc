@@ -10,12 +10,24 @@
 
 #include "vm/compiler/frontend/kernel_translation_helper.h"
 #include "vm/dispatch_table.h"
+#include "vm/flags.h"
 #include "vm/stub_code.h"
 #include "vm/thread.h"
 
 #define Z zone_
 
 namespace dart {
+
+DEFINE_FLAG(bool,
+            print_dispatch_table_stats,
+            false,
+            "Print the size and fill ratio of the dispatch table.");
+DEFINE_FLAG(bool,
+            dispatch_table_dense_packing,
+            false,
+            "Allocate the dispatch table rows at large offsets in decreasing "
+            "order of the cid ranges they span, so that narrow rows fill the "
+            "holes of wide ones.");
 namespace compiler {
 
 class Interval {
@@ -104,6 +116,9 @@ class SelectorRow {
 
   int32_t total_size() const { return total_size_; }
 
+  // The number of cids from the first to the last entry of the row.
+  int32_t span() const { return ranges_.Last().end() - ranges_[0].begin(); }
+
   const GrowableArray<Interval>& ranges() const { return ranges_; }
 
   const GrowableArray<CidInterval>& class_ranges() const {
@@ -649,13 +664,28 @@ void DispatchTableGenerator::ComputeSelectorOffsets() {
     fitter.FitAndAllocate(table_rows_[i], 0, max_offset);
   }
 
-  // Sort the table rows according to size, descending.
-  struct SizeSorter {
-    static int Compare(SelectorRow* const* a, SelectorRow* const* b) {
-      return (*b)->total_size() - (*a)->total_size();
-    }
-  };
-  table_rows_.Sort(SizeSorter::Compare);
+  if (FLAG_dispatch_table_dense_packing) {
+    // Sort the table rows according to span, then size, descending. Wide rows
+    // fit at the fewest offsets, and their holes are then filled by the
+    // narrow rows.
+    struct SpanSorter {
+      static int Compare(SelectorRow* const* a, SelectorRow* const* b) {
+        if ((*a)->span() != (*b)->span()) {
+          return (*b)->span() - (*a)->span();
+        }
+        return (*b)->total_size() - (*a)->total_size();
+      }
+    };
+    table_rows_.Sort(SpanSorter::Compare);
+  } else {
+    // Sort the table rows according to size, descending.
+    struct SizeSorter {
+      static int Compare(SelectorRow* const* a, SelectorRow* const* b) {
+        return (*b)->total_size() - (*a)->total_size();
+      }
+    };
+    table_rows_.Sort(SizeSorter::Compare);
+  }
 
   // Allocate remaining rows at large offsets.
   const int32_t min_large_offset = DispatchTable::kLargestSmallOffset + 1;
@@ -664,6 +694,33 @@ void DispatchTableGenerator::ComputeSelectorOffsets() {
   }
 
   table_size_ = fitter.TableSize();
+
+  if (FLAG_print_dispatch_table_stats) {
+    PrintStats();
+  }
+}
+
+void DispatchTableGenerator::PrintStats() const {
+  intptr_t used_entries = 0;
+  intptr_t small_offset_rows = 0;
+  intptr_t small_offset_entries = 0;
+  for (intptr_t i = 0; i < table_rows_.length(); i++) {
+    const SelectorRow* row = table_rows_[i];
+    used_entries += row->total_size();
+    if (row->selector()->offset <= DispatchTable::kLargestSmallOffset) {
+      small_offset_rows++;
+      small_offset_entries += row->total_size();
+    }
+  }
+  THR_Print("Dispatch table: %" Pd " classes, %" Pd " selector rows (%" Pd
+            " at small offsets)\n",
+            static_cast<intptr_t>(num_classes_), table_rows_.length(),
+            small_offset_rows);
+  THR_Print("Dispatch table: %" Pd32 " entries, %" Pd " used (%.1f%% full, %" Pd
+            " by rows at small offsets)\n",
+            table_size_, used_entries,
+            table_size_ == 0 ? 0.0 : 100.0 * used_entries / table_size_,
+            small_offset_entries);
 }
 
 ArrayPtr DispatchTableGenerator::BuildCodeArray() {
@@ -104,6 +104,7 @@ class DispatchTableGenerator {
   void NumberSelectors();
   void SetupSelectorRows();
   void ComputeSelectorOffsets();
+  void PrintStats() const;
 
   Zone* const zone_;
   ClassTable* classes_;
@@ -16,6 +16,7 @@
 #include "vm/compiler/aot/precompiler_tracer.h"
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/compiler/assembler/disassembler.h"
+#include "vm/compiler/backend/block_scheduler.h"
 #include "vm/compiler/backend/branch_optimizer.h"
 #include "vm/compiler/backend/constant_propagator.h"
 #include "vm/compiler/backend/flow_graph.h"
@@ -34,6 +35,8 @@
 #include "vm/compiler/frontend/flow_graph_builder.h"
 #include "vm/compiler/frontend/kernel_to_il.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/compiler/type_feedback.h"
+#include "vm/dart.h"
 #include "vm/dart_entry.h"
 #include "vm/exceptions.h"
 #include "vm/ffi/native_assets.h"
@@ -54,6 +57,7 @@
 #include "vm/stack_trace.h"
 #include "vm/symbols.h"
 #include "vm/tags.h"
+#include "vm/thread_pool.h"
 #include "vm/timeline.h"
 #include "vm/timer.h"
 #include "vm/type_testing_stubs.h"
@@ -71,6 +75,11 @@ DEFINE_FLAG(bool,
             false,
             "Print per-phase breakdown of time spent precompiling");
 DEFINE_FLAG(bool, print_unique_targets, false, "Print unique dynamic targets");
+DEFINE_FLAG(bool,
+            print_subtype_bitset_stats,
+            false,
+            "Print how many type tests use class id bitsets instead of "
+            "class id ranges");
 DEFINE_FLAG(charp,
             print_object_layout_to,
             nullptr,
@@ -85,6 +94,13 @@ DEFINE_FLAG(charp,
             write_retained_reasons_to,
             nullptr,
             "Print reasons for retaining objects to the given file");
+DEFINE_FLAG(int,
+            precompiler_compile_tasks,
+            0,
+            "Number of threads compiling functions in parallel. If 0, "
+            "functions are compiled one at a time in the order they are "
+            "found. Otherwise the output does not depend on the number of "
+            "threads.");
 
 DECLARE_FLAG(bool, print_flow_graph);
 DECLARE_FLAG(bool, print_flow_graph_optimized);
@@ -102,6 +118,7 @@ DECLARE_FLAG(int, inlining_caller_size_threshold);
 DECLARE_FLAG(int, inlining_constant_arguments_max_size_threshold);
 DECLARE_FLAG(int, inlining_constant_arguments_min_size_threshold);
 DECLARE_FLAG(bool, print_instruction_stats);
+DECLARE_FLAG(bool, order_code_by_hotness);
 
 Precompiler* Precompiler::singleton_ = nullptr;
 
@@ -337,10 +354,12 @@ class PrecompileParsedFunctionHelper : public ValueObject {
  public:
   PrecompileParsedFunctionHelper(Precompiler* precompiler,
                                  ParsedFunction* parsed_function,
-                                 bool optimized)
+                                 bool optimized,
+                                 PrecompileBatchEntry* batch_entry)
       : precompiler_(precompiler),
         parsed_function_(parsed_function),
         optimized_(optimized),
+        batch_entry_(batch_entry),
         thread_(Thread::Current()) {}
 
   bool Compile(CompilationPipeline* pipeline);
@@ -358,11 +377,246 @@ class PrecompileParsedFunctionHelper : public ValueObject {
   Precompiler* precompiler_;
   ParsedFunction* parsed_function_;
   const bool optimized_;
+  PrecompileBatchEntry* const batch_entry_;
   Thread* const thread_;
 
   DISALLOW_COPY_AND_ASSIGN(PrecompileParsedFunctionHelper);
 };
 
+class PrecompileBatch;
+
+// A function compiled as part of a [PrecompileBatch]. Instead of updating
+// the precompiler's worklists directly, its compilation records what it
+// found here, and the mutator applies it once the batch is done.
+struct PrecompileBatchEntry {
+  PrecompileBatch* batch = nullptr;
+  intptr_t index = -1;
+  const Function* function = nullptr;
+  Error* error = nullptr;
+
+  // Set while the compilation has its turn to update shared state.
+  bool has_turn = false;
+  bool installed_type_usage_info = false;
+  // The entries the compilation added to the global object pool.
+  intptr_t pool_start = -1;
+  intptr_t pool_end = -1;
+
+  ZoneGrowableArray<const Field*>* used_static_fields = nullptr;
+  ZoneGrowableArray<const compiler::TableSelector*>* call_selectors = nullptr;
+  ZoneGrowableArray<CompilerState::FunctionSize>* function_sizes = nullptr;
+  ZoneGrowableArray<const Function*>* non_inlinable_functions = nullptr;
+
+  void EnterTurn(Thread* thread);
+  void LeaveTurn(Thread* thread);
+
+  // Records the static fields and table selectors used by the generated
+  // code and the inliner's size estimates and inlinability decisions, for
+  // the mutator to add once the batch is done. Must be called during the
+  // turn.
+  void RecordUses(FlowGraphCompiler* graph_compiler,
+                  const ZoneGrowableArray<CompilerState::FunctionSize>& sizes,
+                  const ZoneGrowableArray<const Function*>& non_inlinable);
+};
+
+// Compiles the pending functions of the precompiler on several threads.
+//
+// The flow graphs are built and optimized concurrently. Everything which
+// updates state shared by all compilations (generating stubs, adding
+// entries to the global object pool, installing code, updating the
+// precompiler's tables) happens in turns, in the order of the entries. The
+// inliner's size estimates are only published once the batch is done. So
+// the output does not depend on the number of threads or their scheduling.
+class PrecompileBatch : public ValueObject {
+ public:
+  PrecompileBatch(Precompiler* precompiler, intptr_t length)
+      : precompiler_(precompiler),
+        type_usage_info_(precompiler->thread()->type_usage_info()),
+        length_(length),
+        entries_(precompiler->zone()->Alloc<PrecompileBatchEntry>(length)) {
+    for (intptr_t i = 0; i < length; i++) {
+      new (&entries_[i]) PrecompileBatchEntry();
+    }
+  }
+
+  intptr_t length() const { return length_; }
+  PrecompileBatchEntry* EntryAt(intptr_t i) const { return &entries_[i]; }
+  Precompiler* precompiler() const { return precompiler_; }
+
+  // Compiles all entries using up to [num_tasks] threads, including the
+  // current one.
+  void CompileAll(intptr_t num_tasks);
+
+  // Compiles entries until there are none left.
+  void CompileEntries(Thread* thread);
+
+  void TaskDone() {
+    MonitorLocker ml(&monitor_);
+    running_tasks_--;
+    ml.NotifyAll();
+  }
+
+ private:
+  friend struct PrecompileBatchEntry;
+
+  Precompiler* const precompiler_;
+  TypeUsageInfo* const type_usage_info_;
+  const intptr_t length_;
+  PrecompileBatchEntry* const entries_;
+
+  RelaxedAtomic<intptr_t> next_entry_ = {0};
+
+  Monitor monitor_;
+  // The index of the entry whose turn it is.
+  intptr_t turn_ = 0;
+  intptr_t running_tasks_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(PrecompileBatch);
+};
+
+void PrecompileBatchEntry::EnterTurn(Thread* thread) {
+  if (has_turn) return;
+  {
+    MonitorLocker ml(&batch->monitor_);
+    while (batch->turn_ != index) {
+      ml.WaitWithSafepointCheck(thread);
+    }
+  }
+  has_turn = true;
+  pool_start =
+      batch->precompiler_->global_object_pool_builder()->CurrentLength();
+  // Code generation records the types used in type tests in the mutator's
+  // [TypeUsageInfo].
+  installed_type_usage_info = thread->type_usage_info() == nullptr;
+  if (installed_type_usage_info) {
+    thread->set_type_usage_info(batch->type_usage_info_);
+  }
+}
+
+void PrecompileBatchEntry::LeaveTurn(Thread* thread) {
+  ASSERT(has_turn);
+  pool_end =
+      batch->precompiler_->global_object_pool_builder()->CurrentLength();
+  if (installed_type_usage_info) {
+    thread->set_type_usage_info(nullptr);
+  }
+  has_turn = false;
+  MonitorLocker ml(&batch->monitor_);
+  batch->turn_++;
+  ml.NotifyAll();
+}
+
+void PrecompileBatchEntry::RecordUses(
+    FlowGraphCompiler* graph_compiler,
+    const ZoneGrowableArray<CompilerState::FunctionSize>& sizes,
+    const ZoneGrowableArray<const Function*>& non_inlinable) {
+  ASSERT(has_turn);
+  Zone* zone = batch->precompiler_->zone();
+  const auto& fields = graph_compiler->used_static_fields();
+  used_static_fields =
+      new (zone) ZoneGrowableArray<const Field*>(zone, fields.length());
+  for (intptr_t i = 0; i < fields.length(); i++) {
+    used_static_fields->Add(&Field::ZoneHandle(zone, fields[i]->ptr()));
+  }
+  const auto& selectors = graph_compiler->dispatch_table_call_targets();
+  call_selectors = new (zone)
+      ZoneGrowableArray<const compiler::TableSelector*>(zone,
+                                                        selectors.length());
+  for (intptr_t i = 0; i < selectors.length(); i++) {
+    call_selectors->Add(selectors[i]);
+  }
+  function_sizes = new (zone)
+      ZoneGrowableArray<CompilerState::FunctionSize>(zone, sizes.length());
+  for (const auto& size : sizes) {
+    function_sizes->Add({&Function::ZoneHandle(zone, size.function->ptr()),
+                         size.instruction_count, size.call_site_count,
+                         size.force});
+  }
+  non_inlinable_functions = new (zone)
+      ZoneGrowableArray<const Function*>(zone, non_inlinable.length());
+  for (const Function* function : non_inlinable) {
+    non_inlinable_functions->Add(&Function::ZoneHandle(zone, function->ptr()));
+  }
+}
+
+void PrecompileBatch::CompileEntries(Thread* thread) {
+  while (true) {
+    const intptr_t index = next_entry_.fetch_add(1);
+    if (index >= length_) break;
+    PrecompileBatchEntry* entry = &entries_[index];
+    // The precompiler's zone is only used by the thread whose turn it is, so
+    // compile in a zone of our own even on the mutator.
+    StackZone stack_zone(thread);
+    Zone* zone = stack_zone.GetZone();
+    const Error& error = Error::Handle(
+        zone, Precompiler::CompileFunction(precompiler_, thread, zone,
+                                           *entry->function, entry));
+    // Compilations which failed before generating code still take their
+    // turn, so the ones after them can proceed.
+    entry->EnterTurn(thread);
+    *entry->error = error.ptr();
+    entry->LeaveTurn(thread);
+  }
+}
+
+class PrecompileBatchTask : public ThreadPool::Task {
+ public:
+  PrecompileBatchTask(PrecompileBatch* batch, intptr_t task_index)
+      : batch_(batch), task_index_(task_index) {}
+
+  void Run() override {
+    const bool kBypassSafepoint = false;
+    Precompiler* precompiler = batch_->precompiler();
+    if (Thread::EnterIsolateGroupAsHelper(
+            precompiler->thread()->isolate_group(), Thread::kPrecompilerTask,
+            kBypassSafepoint)) {
+      Thread* thread = Thread::Current();
+      CompilerTimings* timings = precompiler->CompileTaskTimings(task_index_);
+      if (timings != nullptr) {
+        timings->Resume();
+        thread->set_compiler_timings(timings);
+      }
+      {
+        StackZone stack_zone(thread);
+        HierarchyInfo hierarchy_info(thread);
+        CompilerState state(thread, /*is_aot=*/true, /*is_optimizing=*/true);
+        batch_->CompileEntries(thread);
+      }
+      if (timings != nullptr) {
+        thread->set_compiler_timings(nullptr);
+        timings->Pause();
+      }
+      Thread::ExitIsolateGroupAsHelper(kBypassSafepoint);
+    }
+    batch_->TaskDone();
+  }
+
+ private:
+  PrecompileBatch* const batch_;
+  const intptr_t task_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(PrecompileBatchTask);
+};
+
+void PrecompileBatch::CompileAll(intptr_t num_tasks) {
+  Thread* thread = precompiler_->thread();
+  num_tasks = Utils::Minimum(num_tasks, length_);
+  {
+    MonitorLocker ml(&monitor_);
+    running_tasks_ = num_tasks - 1;
+  }
+  for (intptr_t task_index = 1; task_index < num_tasks; task_index++) {
+    if (!Dart::thread_pool()->Run<PrecompileBatchTask>(this, task_index)) {
+      TaskDone();
+    }
+  }
+  // The mutator is one of the compiling threads.
+  CompileEntries(thread);
+  MonitorLocker ml(&monitor_);
+  while (running_tasks_ > 0) {
+    ml.WaitWithSafepointCheck(thread);
+  }
+}
+
 static void Jump(const Error& error) {
   Thread::Current()->long_jump_base()->Jump(1, error);
 }
@@ -380,11 +634,26 @@ ErrorPtr Precompiler::CompileAll() {
 }
 
 void Precompiler::ReportStats() {
+  if (FLAG_print_subtype_bitset_stats) {
+    THR_Print("Subtype bitsets: %" Pd " (%" Pd " bytes)\n",
+              subtype_bitset_count_, subtype_bitset_bytes_);
+    THR_Print("  in optimized code: %" Pd " type tests\n",
+              subtype_bitset_check_count_.load());
+    THR_Print("  in type testing stubs: %" Pd " type tests\n",
+              subtype_bitset_stub_count_.load());
+  }
+
   if (!FLAG_print_precompiler_timings) {
     return;
   }
 
   thread()->compiler_timings()->Print();
+  for (intptr_t i = 1; i < compile_task_timings_.length(); i++) {
+    if (compile_task_timings_[i] != nullptr) {
+      compile_task_timings_[i]->Print(
+          OS::SCreate(thread()->zone(), "Compile task %" Pd, i));
+    }
+  }
 }
 
 Precompiler::Precompiler(Thread* thread)
@@ -450,6 +719,33 @@ Precompiler::~Precompiler() {
 
   delete thread()->compiler_timings();
   thread()->set_compiler_timings(nullptr);
+  for (intptr_t i = 0; i < compile_task_timings_.length(); i++) {
+    delete compile_task_timings_[i];
+  }
+}
+
+TypedDataPtr Precompiler::LookupSubtypeBitset(intptr_t cid) {
+  MutexLocker ml(&subtype_bitsets_mutex_);
+  return TypedData::RawCast(subtype_bitsets_->At(cid));
+}
+
+TypedDataPtr Precompiler::InsertOrGetSubtypeBitset(intptr_t cid,
+                                                   const TypedData& bitset) {
+  MutexLocker ml(&subtype_bitsets_mutex_);
+  if (subtype_bitsets_->At(cid) == Object::null()) {
+    subtype_bitsets_->SetAt(cid, bitset);
+    subtype_bitset_count_++;
+    subtype_bitset_bytes_ += bitset.LengthInBytes();
+  }
+  return TypedData::RawCast(subtype_bitsets_->At(cid));
+}
+
+CompilerTimings* Precompiler::CompileTaskTimings(intptr_t task_index) {
+  if (!FLAG_print_precompiler_timings) {
+    return nullptr;
+  }
+  ASSERT(task_index > 0 && task_index < compile_task_timings_.length());
+  return compile_task_timings_[task_index];
 }
 
 void Precompiler::DoCompileAll() {
@@ -483,6 +779,14 @@ void Precompiler::DoCompileAll() {
 
       ClassFinalizer::SortClasses();
 
+      // Receiver classes in the type feedback are resolved to class ids, so
+      // it can only be read once the classes have their final ids.
+      type_feedback_ = TypeFeedback::Load(T);
+      if (FLAG_trace_precompiler && type_feedback_ != nullptr) {
+        THR_Print("Read type feedback for %" Pd " functions, %" Pd " calls.\n",
+                  type_feedback_->num_functions(), type_feedback_->num_calls());
+      }
+
       // Collects type usage information which allows us to decide when/how to
       // optimize runtime type tests.
       TypeUsageInfo type_usage_info(T);
@@ -491,6 +795,17 @@ void Precompiler::DoCompileAll() {
       // as well as other type checks.
       HierarchyInfo hierarchy_info(T);
 
+      // Classes are not added or renumbered from here on, so the subtype
+      // bitsets can cover all class ids.
+      subtype_bitsets_ = &Array::ZoneHandle(
+          Z, Array::New(IG->class_table()->NumCids(), Heap::kOld));
+      subtype_bit_masks_ = &TypedData::ZoneHandle(
+          Z, TypedData::New(kTypedDataUint8ArrayCid, kBitsPerByte,
+                            Heap::kOld));
+      for (intptr_t i = 0; i < kBitsPerByte; i++) {
+        subtype_bit_masks_->SetUint8(i, 1 << i);
+      }
+
       dispatch_table_generator_ = new compiler::DispatchTableGenerator(Z);
       dispatch_table_generator_->Initialize(IG->class_table());
 
@@ -633,6 +948,10 @@ void Precompiler::DoCompileAll() {
       DropLibraries();
     }
 
+    // The feedback identifies functions by name, so the counts must be
+    // looked up before obfuscation.
+    SaveExecutedBlockCounts();
+
     {
       PRECOMPILER_TIMER_SCOPE(this, Obfuscate);
       Obfuscate();
@@ -660,6 +979,7 @@ void Precompiler::DoCompileAll() {
       retained_reasons_writer_ = nullptr;
     }
 
+    type_feedback_ = nullptr;
     zone_ = nullptr;
   }
 
@@ -773,6 +1093,10 @@ void Precompiler::Iterate() {
     changed_ = false;
 
     while (pending_functions_.Length() > 0) {
+      if (FLAG_precompiler_compile_tasks > 0) {
+        CompilePendingFunctionsInParallel();
+        continue;
+      }
       function ^= pending_functions_.RemoveLast();
       ProcessFunction(function);
     }
@@ -880,10 +1204,83 @@ void Precompiler::ProcessFunction(const Function& function) {
 
   // Used in the JIT to save type-feedback across compilations.
   function.ClearICDataArray();
-  AddCalleesOf(function, gop_offset);
+  AddCalleesOf(function, gop_offset,
+               global_object_pool_builder()->CurrentLength());
+}
+
+void Precompiler::CompilePendingFunctionsInParallel() {
+  HANDLESCOPE(T);
+  // All pending functions form the batch, in the order in which they would
+  // be compiled one at a time. The functions they reach are compiled in the
+  // next batch.
+  const intptr_t num_functions = pending_functions_.Length();
+  PrecompileBatch batch(this, num_functions);
+  {
+    TracingScope tracing_scope(this);
+    for (intptr_t i = 0; i < num_functions; i++) {
+      auto& function = Function::Handle(Z);
+      function ^= pending_functions_.RemoveLast();
+      RELEASE_ASSERT(!function.HasCode());
+      ASSERT(!function.is_abstract());
+      function_count_++;
+      if (FLAG_trace_precompiler) {
+        THR_Print("Precompiling %" Pd " %s (%s, %s)\n", function_count_,
+                  function.ToLibNamePrefixedQualifiedCString(),
+                  function.token_pos().ToCString(),
+                  Function::KindToCString(function.kind()));
+      }
+      if (is_tracing()) {
+        tracer_->WriteCompileFunctionEvent(function);
+      }
+      PrecompileBatchEntry* entry = batch.EntryAt(i);
+      entry->batch = &batch;
+      entry->index = i;
+      entry->function = &function;
+      entry->error = &Error::Handle(Z);
+    }
+  }
+
+  const intptr_t num_tasks = FLAG_precompiler_compile_tasks;
+  if (FLAG_print_precompiler_timings) {
+    while (compile_task_timings_.length() < num_tasks) {
+      // Task 0 is the mutator, which keeps using its own timings.
+      CompilerTimings* timings = nullptr;
+      if (compile_task_timings_.length() > 0) {
+        timings = new CompilerTimings();
+        timings->Pause();
+      }
+      compile_task_timings_.Add(timings);
+    }
+  }
+  batch.CompileAll(num_tasks);
+
+  TracingScope tracing_scope(this);
+  for (intptr_t i = 0; i < num_functions; i++) {
+    PrecompileBatchEntry* entry = batch.EntryAt(i);
+    if (!entry->error->IsNull()) {
+      Jump(*entry->error);
+    }
+  }
+  for (intptr_t i = 0; i < num_functions; i++) {
+    PrecompileBatchEntry* entry = batch.EntryAt(i);
+    const Function& function = *entry->function;
+    function.ClearICDataArray();
+    FlowGraphInliner::PublishFunctionSizes(*entry->function_sizes);
+    FlowGraphInliner::PublishNonInlinableFunctions(
+        *entry->non_inlinable_functions);
+    for (const Field* field : *entry->used_static_fields) {
+      AddField(*field);
+    }
+    for (const compiler::TableSelector* selector : *entry->call_selectors) {
+      AddTableSelector(selector);
+    }
+    AddCalleesOf(function, entry->pool_start, entry->pool_end);
+  }
 }
 
-void Precompiler::AddCalleesOf(const Function& function, intptr_t gop_offset) {
+void Precompiler::AddCalleesOf(const Function& function,
+                               intptr_t gop_start,
+                               intptr_t gop_end) {
   PRECOMPILER_TIMER_SCOPE(this, AddCalleesOf);
   ASSERT(function.HasCode());
 
@@ -950,8 +1347,7 @@ void Precompiler::AddCalleesOf(const Function& function, intptr_t gop_offset) {
   // *all* outgoing references into the trace. Scanning GOP would exclude
   // references that have been deduplicated.
   if (!is_tracing()) {
-    for (intptr_t i = gop_offset;
-         i < global_object_pool_builder()->CurrentLength(); i++) {
+    for (intptr_t i = gop_start; i < gop_end; i++) {
       const auto& wrapper_entry = global_object_pool_builder()->EntryAt(i);
       if (wrapper_entry.type() ==
           compiler::ObjectPoolBuilderEntry::kTaggedObject) {
@@ -2310,6 +2706,7 @@ void Precompiler::DropFunctions() {
   // Note: in PRODUCT mode snapshotter will drop this field when serializing.
   // This is done in ProgramSerializationRoots.
   IG->object_store()->set_closure_functions(retained_functions);
+  ClosureFunctionsCache::ResetClosureIndicesLocked();
 
   // Only needed during compilation.
   IG->object_store()->set_closure_functions_table(Object::null_array());
@@ -3305,6 +3702,21 @@ FunctionPtr Precompiler::FindUnvisitedRetainedFunction() {
 }
 #endif
 
+// Records the executed block counts of the compiled functions for the
+// snapshot writer, which orders the code by them (see
+// --order_code_by_hotness) but must not allocate while it does.
+void Precompiler::SaveExecutedBlockCounts() {
+  if (type_feedback_ == nullptr || !FLAG_order_code_by_hotness) return;
+  GrowableArray<const Function*> functions;
+  FunctionSet::Iterator it(&seen_functions_);
+  while (it.MoveNext()) {
+    functions.Add(&Function::Handle(
+        Z, Function::RawCast(seen_functions_.GetKey(it.Current()))));
+  }
+  IG->object_store()->set_executed_block_counts(
+      Array::Handle(Z, type_feedback_->ExecutedBlockCounts(functions)));
+}
+
 void Precompiler::Obfuscate() {
   if (!IG->obfuscate()) {
     return;
@@ -3430,7 +3842,7 @@ void PrecompileParsedFunctionHelper::FinalizeCompilation(
 
   if (optimized()) {
     // Installs code while at safepoint.
-    ASSERT(thread()->IsDartMutatorThread());
+    ASSERT(thread()->IsDartMutatorThread() || batch_entry_ != nullptr);
     function.InstallOptimizedCode(code);
   } else {  // not optimized.
     function.set_unoptimized_code(code);
@@ -3487,6 +3899,12 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       CompilerState compiler_state(thread(), /*is_aot=*/true, optimized(),
                                    CompilerState::ShouldTrace(function));
       compiler_state.set_function(function);
+      if (batch_entry_ != nullptr) {
+        compiler_state.set_deferred_function_sizes(
+            new (zone) ZoneGrowableArray<CompilerState::FunctionSize>());
+        compiler_state.set_deferred_non_inlinable_functions(
+            new (zone) ZoneGrowableArray<const Function*>());
+      }
 
       {
         ic_data_array = new (zone) ZoneGrowableArray<const ICData*>();
@@ -3500,6 +3918,9 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 
       if (optimized()) {
         flow_graph->PopulateWithICData(function);
+        if (flow_graph->should_reorder_blocks()) {
+          BlockScheduler::AssignEdgeWeights(flow_graph);
+        }
       }
 
       const bool print_flow_graph =
@@ -3529,6 +3950,12 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 
       ASSERT(precompiler_ != nullptr);
 
+      // From here on the compilation updates state shared with other
+      // compilations of its batch.
+      if (batch_entry_ != nullptr) {
+        batch_entry_->EnterTurn(thread());
+      }
+
       // When generating code in bare instruction mode all code objects
       // share the same global object pool. To reduce interleaving of
       // unrelated object pool entries from different code objects
@@ -3572,13 +3999,19 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
       {
         COMPILER_TIMINGS_TIMER_SCOPE(thread(), FinalizeCode);
         TIMELINE_DURATION(thread(), CompilerVerbose, "FinalizeCompilation");
-        ASSERT(thread()->IsDartMutatorThread());
+        ASSERT(thread()->IsDartMutatorThread() || batch_entry_ != nullptr);
         FinalizeCompilation(&assembler, &graph_compiler, flow_graph,
                             function_stats);
       }
 
-      if (precompiler_->phase() ==
-          Precompiler::Phase::kFixpointCodeGeneration) {
+      if (batch_entry_ != nullptr) {
+        RELEASE_ASSERT(precompiler_->phase() ==
+                       Precompiler::Phase::kFixpointCodeGeneration);
+        batch_entry_->RecordUses(
+            &graph_compiler, *compiler_state.deferred_function_sizes(),
+            *compiler_state.deferred_non_inlinable_functions());
+      } else if (precompiler_->phase() ==
+                 Precompiler::Phase::kFixpointCodeGeneration) {
         for (intptr_t i = 0; i < graph_compiler.used_static_fields().length();
              i++) {
           precompiler_->AddField(*graph_compiler.used_static_fields().At(i));
@@ -3667,7 +4100,8 @@ bool PrecompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 static ErrorPtr PrecompileFunctionHelper(Precompiler* precompiler,
                                          CompilationPipeline* pipeline,
                                          const Function& function,
-                                         bool optimized) {
+                                         bool optimized,
+                                         PrecompileBatchEntry* batch_entry) {
   // Check that we optimize, except if the function is not optimizable.
   ASSERT(CompilerState::Current().is_aot());
   ASSERT(!function.IsOptimizable() || optimized);
@@ -3696,7 +4130,7 @@ static ErrorPtr PrecompileFunctionHelper(Precompiler* precompiler,
     }
 
     PrecompileParsedFunctionHelper helper(precompiler, parsed_function,
-                                          optimized);
+                                          optimized, batch_entry);
     const bool success = helper.Compile(pipeline);
     if (!success) {
       // We got an error during compilation.
@@ -3742,8 +4176,9 @@ static ErrorPtr PrecompileFunctionHelper(Precompiler* precompiler,
 ErrorPtr Precompiler::CompileFunction(Precompiler* precompiler,
                                       Thread* thread,
                                       Zone* zone,
-                                      const Function& function) {
-  PRECOMPILER_TIMER_SCOPE(precompiler, CompileFunction);
+                                      const Function& function,
+                                      PrecompileBatchEntry* batch_entry) {
+  COMPILER_TIMINGS_TIMER_SCOPE(thread, CompileFunction);
   NoActiveIsolateScope no_isolate_scope;
 
   VMTagScope tagScope(thread, VMTag::kCompileUnoptimizedTagId);
@@ -3756,7 +4191,8 @@ ErrorPtr Precompiler::CompileFunction(Precompiler* precompiler,
     precompiler->tracer_->WriteCompileFunctionEvent(function);
   }
 
-  return PrecompileFunctionHelper(precompiler, &pipeline, function, optimized);
+  return PrecompileFunctionHelper(precompiler, &pipeline, function, optimized,
+                                  batch_entry);
 }
 
 Obfuscator::Obfuscator(Thread* thread, const String& private_key)
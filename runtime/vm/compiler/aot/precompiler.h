@@ -9,12 +9,14 @@
 #error "AOT runtime should not use compiler sources (including header files)"
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 
+#include "platform/atomic.h"
 #include "vm/allocation.h"
 #include "vm/compiler/aot/dispatch_table_generator.h"
 #include "vm/compiler/assembler/assembler.h"
 #include "vm/hash_map.h"
 #include "vm/hash_table.h"
 #include "vm/object.h"
+#include "vm/os_thread.h"
 #include "vm/symbols.h"
 #include "vm/timer.h"
 
@@ -22,6 +24,7 @@ namespace dart {
 
 // Forward declarations.
 class Class;
+class CompilerTimings;
 class Error;
 class Field;
 class Function;
@@ -31,6 +34,8 @@ class Precompiler;
 class FlowGraph;
 class PrecompilerTracer;
 class RetainedReasonsWriter;
+class TypeFeedback;
+struct PrecompileBatchEntry;
 
 class TableSelectorKeyValueTrait {
  public:
@@ -243,10 +248,13 @@ class Precompiler : public ValueObject {
  public:
   static ErrorPtr CompileAll();
 
+  // If [batch_entry] is given, [function] is compiled as part of a batch of
+  // functions compiled in parallel (see [CompilePendingFunctionsInParallel]).
   static ErrorPtr CompileFunction(Precompiler* precompiler,
                                   Thread* thread,
                                   Zone* zone,
-                                  const Function& function);
+                                  const Function& function,
+                                  PrecompileBatchEntry* batch_entry = nullptr);
 
   // Returns true if get:runtimeType is not overloaded by any class.
   bool get_runtime_type_is_unique() const {
@@ -280,6 +288,36 @@ class Precompiler : public ValueObject {
   Thread* thread() const { return thread_; }
   Zone* zone() const { return zone_; }
 
+  // The type feedback given by --type_feedback, or nullptr.
+  const TypeFeedback* type_feedback() const { return type_feedback_; }
+
+  // Returns the timings of the [task_index]th compile task, or nullptr if
+  // timings are not collected.
+  CompilerTimings* CompileTaskTimings(intptr_t task_index);
+
+  // Class id bitsets of the concrete subtypes of classes, which are shared by
+  // all compilations (see HierarchyInfo::SubtypeBitsetFor).
+  //
+  // Returns the bitset of the class with id [cid], or null if it has none yet.
+  TypedDataPtr LookupSubtypeBitset(intptr_t cid);
+
+  // Adds [bitset] as the bitset of the class with id [cid] unless another
+  // compilation added one first, and returns the bitset of the class.
+  TypedDataPtr InsertOrGetSubtypeBitset(intptr_t cid, const TypedData& bitset);
+
+  // The masks of the bits of a byte, indexed by bit.
+  const TypedData& subtype_bit_masks() const { return *subtype_bit_masks_; }
+
+  // Counts a type test which tests a subtype bitset instead of class id
+  // ranges, either in optimized code or in a type testing stub.
+  void RecordSubtypeBitsetCheck(bool in_stub) {
+    if (in_stub) {
+      subtype_bitset_stub_count_.fetch_add(1);
+    } else {
+      subtype_bitset_check_count_.fetch_add(1);
+    }
+  }
+
  private:
   static Precompiler* singleton_;
 
@@ -315,7 +353,11 @@ class Precompiler : public ValueObject {
   void AddTypesOf(const Function& function);
   void AddTypeParameters(const TypeParameters& params);
   void AddTypeArguments(const TypeArguments& args);
-  void AddCalleesOf(const Function& function, intptr_t gop_offset);
+  // Adds the callees of [function], whose code added the entries in
+  // [gop_start, gop_end) to the global object pool.
+  void AddCalleesOf(const Function& function,
+                    intptr_t gop_start,
+                    intptr_t gop_end);
   void AddCalleesOfHelper(const Object& entry,
                           String* temp_selector,
                           Class* temp_cls);
@@ -333,6 +375,9 @@ class Precompiler : public ValueObject {
   bool HasApiUse(const Object& obj);
 
   void ProcessFunction(const Function& function);
+  // Compiles all pending functions, using --precompiler_compile_tasks
+  // threads.
+  void CompilePendingFunctionsInParallel();
   void CheckForNewDynamicFunctions();
   void CollectCallbackFields();
 
@@ -357,6 +402,7 @@ class Precompiler : public ValueObject {
 
   DEBUG_ONLY(FunctionPtr FindUnvisitedRetainedFunction());
 
+  void SaveExecutedBlockCounts();
   void Obfuscate();
 
   void CollectDynamicFunctionNames();
@@ -413,7 +459,20 @@ class Precompiler : public ValueObject {
   Phase phase_ = Phase::kPreparation;
   PrecompilerTracer* tracer_ = nullptr;
   RetainedReasonsWriter* retained_reasons_writer_ = nullptr;
+  TypeFeedback* type_feedback_ = nullptr;
   bool is_tracing_ = false;
+
+  // Timings of the helper threads compiling in parallel, by task index.
+  MallocGrowableArray<CompilerTimings*> compile_task_timings_;
+
+  // The subtype bitsets by class id, guarded by [subtype_bitsets_mutex_].
+  Mutex subtype_bitsets_mutex_;
+  Array* subtype_bitsets_ = nullptr;
+  TypedData* subtype_bit_masks_ = nullptr;
+  intptr_t subtype_bitset_count_ = 0;
+  intptr_t subtype_bitset_bytes_ = 0;
+  RelaxedAtomic<intptr_t> subtype_bitset_check_count_ = {0};
+  RelaxedAtomic<intptr_t> subtype_bitset_stub_count_ = {0};
 };
 
 class FunctionsTraits {
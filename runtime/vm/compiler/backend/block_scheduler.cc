@@ -6,8 +6,10 @@
 
 #include "vm/allocation.h"
 #include "vm/code_patcher.h"
+#include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/backend/flow_graph.h"
 #include "vm/compiler/jit/compiler.h"
+#include "vm/compiler/type_feedback.h"
 
 namespace dart {
 
@@ -50,21 +52,30 @@ void BlockScheduler::AssignEdgeWeights(FlowGraph* flow_graph) {
   if (!FLAG_reorder_basic_blocks) {
     return;
   }
-  if (CompilerState::Current().is_aot()) {
-    return;
-  }
-
   const Function& function = flow_graph->parsed_function().function();
-  const Array& ic_data_array =
-      Array::Handle(flow_graph->zone(), function.ic_data_array());
-  if (ic_data_array.IsNull()) {
-    DEBUG_ASSERT(IsolateGroup::Current()->HasAttemptedReload() ||
-                 function.ForceOptimize());
-    return;
-  }
   Array& edge_counters = Array::Handle();
-  edge_counters ^=
-      ic_data_array.At(Function::ICDataArrayIndices::kEdgeCounters);
+  if (CompilerState::Current().is_aot()) {
+#if defined(DART_PRECOMPILER)
+    // The AOT compiler has edge counters only if they were recorded by a
+    // JIT run of the program, see TypeFeedback.
+    auto precompiler = Precompiler::Instance();
+    if (precompiler == nullptr || precompiler->type_feedback() == nullptr) {
+      return;
+    }
+    edge_counters = precompiler->type_feedback()->EdgeCounters(
+        function, flow_graph->preorder().length());
+#endif  // defined(DART_PRECOMPILER)
+  } else {
+    const Array& ic_data_array =
+        Array::Handle(flow_graph->zone(), function.ic_data_array());
+    if (ic_data_array.IsNull()) {
+      DEBUG_ASSERT(IsolateGroup::Current()->HasAttemptedReload() ||
+                   function.ForceOptimize());
+      return;
+    }
+    edge_counters ^=
+        ic_data_array.At(Function::ICDataArrayIndices::kEdgeCounters);
+  }
   if (edge_counters.IsNull()) {
     return;
   }
@@ -240,12 +251,15 @@ void BlockScheduler::ReorderBlocksJIT(FlowGraph* flow_graph) {
   }
 }
 
-// AOT block order is based on reverse post order but with two changes:
+// AOT block order is based on reverse post order but with a few changes:
 //
 // - Blocks which always throw and their direct predecessors are considered
-// *cold* and moved to the end of the order.
+// *cold* and moved to the end of the order. So are branch targets which were
+// never taken according to the profile, if the AOT compiler has one.
 // - Blocks which belong to the same loop are kept together (where possible)
 // and not interspersed with other blocks.
+// - Otherwise the more frequent successor of a branch is placed right after
+// it, if the AOT compiler has a profile.
 //
 namespace {
 class AOTBlockScheduler {
@@ -255,7 +269,8 @@ class AOTBlockScheduler {
         block_count_(flow_graph->reverse_postorder().length()),
         marks_(block_count_),
         postorder_(block_count_),
-        cold_postorder_(10) {
+        cold_postorder_(10),
+        has_edge_weights_(flow_graph->graph_entry()->entry_count() > 0) {
     marks_.FillWith(0, 0, block_count_);
   }
 
@@ -292,15 +307,27 @@ class AOTBlockScheduler {
           // When visiting a block inside a loop with two successors
           // push the successor with lesser nesting *last*, so that it is
           // visited first. This helps to keep blocks which belong to the
-          // same loop together.
+          // same loop together. Otherwise, if edge weights are known, push
+          // the less frequent successor last, so that the more frequent one
+          // is placed right after the block.
           //
           // This is the main difference from |DiscoverBlocks| which always
           // visits successors in reverse order.
-          if (successor_count == 2 && block->loop_info() != nullptr) {
+          if (successor_count == 2) {
             auto succ0 = last->SuccessorAt(0);
             auto succ1 = last->SuccessorAt(1);
 
-            if (succ0->NestingDepth() < succ1->NestingDepth()) {
+            bool succ1_first;
+            if (block->loop_info() != nullptr &&
+                succ0->NestingDepth() != succ1->NestingDepth()) {
+              succ1_first = succ0->NestingDepth() < succ1->NestingDepth();
+            } else {
+              succ1_first = EdgeWeight(succ1) > EdgeWeight(succ0);
+            }
+            MarkNeverTaken(succ0, succ1);
+            MarkNeverTaken(succ1, succ0);
+
+            if (succ1_first) {
               PushBlock(succ1);
               PushBlock(succ0);
             } else {
@@ -359,6 +386,23 @@ class AOTBlockScheduler {
     return marks_[block->preorder_number()];
   }
 
+  // The weight of the edge to [successor] of a branch, or 0 if the weights
+  // are not known.
+  double EdgeWeight(BlockEntryInstr* successor) const {
+    if (!has_edge_weights_) return 0.0;
+    auto target = successor->AsTargetEntry();
+    return target != nullptr ? target->edge_weight() : 0.0;
+  }
+
+  // A successor of a branch which was never taken in the profile while the
+  // other successor was is treated like a block which throws.
+  void MarkNeverTaken(BlockEntryInstr* successor, BlockEntryInstr* other) {
+    if (EdgeWeight(other) > 0.0 && EdgeWeight(successor) == 0.0 &&
+        successor->IsTargetEntry()) {
+      MarksOf(successor) |= kColdMark;
+    }
+  }
+
   void PushBlock(BlockEntryInstr* block) {
     auto& marks = MarksOf(block);
     if ((marks & kSeenMark) == 0) {
@@ -382,6 +426,9 @@ class AOTBlockScheduler {
 
   GrowableArray<BlockEntryInstr*> postorder_;
   GrowableArray<BlockEntryInstr*> cold_postorder_;
+
+  // Whether the edge weights were assigned from a profile.
+  const bool has_edge_weights_;
 };
 }  // namespace
 
@@ -10,6 +10,7 @@
 #include "vm/bootstrap.h"
 #include "vm/code_entry_kind.h"
 #include "vm/compiler/aot/dispatch_table_generator.h"
+#include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/assembler/object_pool_builder.h"
 #include "vm/compiler/backend/code_statistics.h"
 #include "vm/compiler/backend/constant_propagator.h"
@@ -58,6 +59,12 @@ DEFINE_FLAG(bool,
             two_args_smi_icd,
             true,
             "Generate special IC stubs for two args Smi operations");
+DEFINE_FLAG(int,
+            subtype_bitset_threshold,
+            4,
+            "Test for the subtypes of a class with a class id bitset instead "
+            "of class id ranges if they need more ranges than this "
+            "(precompilation only). Negative values disable bitsets.");
 
 DECLARE_FLAG(bool, inline_alloc);
 DECLARE_FLAG(bool, use_slow_path);
@@ -437,6 +444,53 @@ bool HierarchyInfo::InstanceOfHasClassRange(const AbstractType& type,
   return false;
 }
 
+const TypedData* HierarchyInfo::SubtypeBitsetFor(const AbstractType& type) {
+#if defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+  Precompiler* precompiler = Precompiler::Instance();
+  if (precompiler == nullptr || FLAG_subtype_bitset_threshold < 0 ||
+      !CanUseSubtypeRangeCheckFor(type)) {
+    return nullptr;
+  }
+  Zone* zone = thread()->zone();
+  const Class& type_class = Class::Handle(zone, type.type_class());
+  const CidRangeVector& ranges =
+      SubtypeRangesForClass(type_class,
+                            /*include_abstract=*/false,
+                            /*exclude_null=*/true);
+  if (ranges.length() <= FLAG_subtype_bitset_threshold) {
+    return nullptr;
+  }
+  auto& bitset = TypedData::ZoneHandle(
+      zone, precompiler->LookupSubtypeBitset(type_class.id()));
+  if (bitset.IsNull()) {
+    bitset = BuildSubtypeBitset(
+        ranges, thread()->isolate_group()->class_table()->NumCids());
+    bitset = precompiler->InsertOrGetSubtypeBitset(type_class.id(), bitset);
+  }
+  return &bitset;
+#else
+  return nullptr;
+#endif  // defined(DART_PRECOMPILER) && !defined(TARGET_ARCH_IA32)
+}
+
+TypedDataPtr HierarchyInfo::BuildSubtypeBitset(const CidRangeVector& ranges,
+                                               intptr_t num_cids) {
+  const auto& bitset = TypedData::Handle(
+      TypedData::New(kTypedDataUint8ArrayCid,
+                     Utils::RoundUp(num_cids, kBitsPerByte) / kBitsPerByte,
+                     Heap::kOld));
+  for (intptr_t i = 0; i < ranges.length(); i++) {
+    const CidRangeValue& range = ranges[i];
+    ASSERT(range.cid_end < num_cids);
+    for (intptr_t cid = range.cid_start; cid <= range.cid_end; cid++) {
+      const intptr_t byte = cid >> kBitsPerByteLog2;
+      bitset.SetUint8(byte, bitset.GetUint8(byte) |
+                                (1 << (cid & (kBitsPerByte - 1))));
+    }
+  }
+  return bitset.ptr();
+}
+
 // The set of supported non-integer unboxed representations.
 // Format: (unboxed representations suffix, boxed class type)
 #define FOR_EACH_NON_INT_BOXED_REPRESENTATION(M)                               \
@@ -289,6 +289,21 @@ class HierarchyInfo : public ThreadStackResource {
                                intptr_t* lower_limit,
                                intptr_t* upper_limit);
 
+  // Returns a bitset in which the bits of the class ids of the concrete
+  // subtypes of [type] are set, if [type] can be tested with cid ranges but
+  // needs more than --subtype_bitset_threshold of them. Otherwise, and when
+  // not precompiling, returns nullptr.
+  //
+  // Null is not in the bitset, even if it is a subtype of [type]. Bit k of
+  // byte i of the bitset is the bit of class id 8 * i + k, so testing it uses
+  // the masks in Precompiler::subtype_bit_masks.
+  const TypedData* SubtypeBitsetFor(const AbstractType& type);
+
+  // Returns a bitset covering [num_cids] class ids in which the bits of the
+  // class ids in [ranges] are set.
+  static TypedDataPtr BuildSubtypeBitset(const CidRangeVector& ranges,
+                                         intptr_t num_cids);
+
   // Returns `true` if a simple [CidRange]-based subtype-check can be used to
   // determine if a given instance's type is a subtype of [type].
   //
@@ -1398,6 +1413,7 @@ class Instruction : public ZoneAllocated {
   // GetDeoptId and/or CopyDeoptIdFrom.
   friend class CallSiteInliner;
   friend class LICM;
+  friend class LoopUnroller;
   friend class ComparisonInstr;
   friend class Scheduler;
   friend class BlockEntryInstr;
@@ -6429,6 +6445,9 @@ class StoreFieldInstr : public TemplateInstruction<2, NoThrow> {
 
   virtual TokenPosition token_pos() const { return token_pos_; }
   bool is_initialization() const { return is_initialization_; }
+  compiler::Assembler::MemoryOrder memory_order() const {
+    return memory_order_;
+  }
 
   bool ShouldEmitStoreBarrier() const {
     if (slot().has_untagged_instance()) {
@@ -6803,6 +6822,7 @@ class LoadIndexedInstr : public TemplateDefinition<2, NoThrow> {
 
   Value* array() const { return inputs_[kArrayPos]; }
   Value* index() const { return inputs_[kIndexPos]; }
+  bool index_unboxed() const { return index_unboxed_; }
   intptr_t index_scale() const { return index_scale_; }
   intptr_t class_id() const { return class_id_; }
   bool aligned() const { return alignment_ == kAlignedAccess; }
@@ -7086,6 +7106,7 @@ class StoreIndexedInstr : public TemplateInstruction<3, NoThrow> {
   Value* index() const { return inputs_[kIndexPos]; }
   Value* value() const { return inputs_[kValuePos]; }
 
+  bool index_unboxed() const { return index_unboxed_; }
   intptr_t index_scale() const { return index_scale_; }
   intptr_t class_id() const { return class_id_; }
   bool aligned() const { return alignment_ == kAlignedAccess; }
@@ -652,6 +652,31 @@ ISOLATE_UNIT_TEST_CASE(HierarchyInfo_String_Subtype) {
   RANGES_CONTAIN_EXPECTED_CIDS(abstract_range, expected_cids);
 }
 
+ISOLATE_UNIT_TEST_CASE(HierarchyInfo_SubtypeBitset) {
+  HierarchyInfo hi(thread);
+  const auto& type = Type::Handle(Type::Number());
+  const auto& cls = Class::Handle(type.type_class());
+  const CidRangeVector& ranges = hi.SubtypeRangesForClass(
+      cls, /*include_abstract=*/false, /*exclude_null=*/true);
+  const intptr_t num_cids = IsolateGroup::Current()->class_table()->NumCids();
+  const auto& bitset = TypedData::Handle(
+      HierarchyInfo::BuildSubtypeBitset(ranges, num_cids));
+  EXPECT_EQ(Utils::RoundUp(num_cids, kBitsPerByte) / kBitsPerByte,
+            bitset.LengthInBytes());
+
+  intptr_t num_set = 0;
+  for (intptr_t cid = 0; cid < num_cids; cid++) {
+    const bool in_ranges = CidRangeVectorUtils::ContainsCid(ranges, cid);
+    const bool is_set =
+        (bitset.GetUint8(cid / kBitsPerByte) & (1 << (cid % kBitsPerByte))) !=
+        0;
+    EXPECT_EQ(in_ranges, is_set);
+    if (is_set) num_set++;
+  }
+  EXPECT(num_set >= 3);  // _Smi, _Mint and _Double.
+  EXPECT(hi.SubtypeBitsetFor(type) == nullptr);  // Only when precompiling.
+}
+
 // This test verifies that double == Smi is recognized and
 // implemented using EqualityCompare.
 // Regression test for https://github.com/dart-lang/sdk/issues/47031.
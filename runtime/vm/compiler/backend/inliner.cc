@@ -61,6 +61,11 @@ DEFINE_FLAG(int,
             inlining_small_leaf_size_threshold,
             50,
             "Do not inline leaf callees larger than threshold");
+DEFINE_FLAG(int,
+            inlining_closure_argument_size_threshold,
+            100,
+            "Inline functions up to threshold which call a closure passed to "
+            "them whose function is known at the call site.");
 DEFINE_FLAG(int,
             inlining_caller_size_threshold,
             50000,
@@ -112,6 +117,89 @@ static bool IsCallRecursive(const Function& function, Definition* call) {
   return false;
 }
 
+// Returns the function of the closure [defn] evaluates to if it is known, or
+// null otherwise. Looks through phis whose inputs are all closures of the
+// same function, such as closures allocated on both sides of a branch.
+static FunctionPtr KnownClosureFunction(Definition* defn, intptr_t depth = 0) {
+  const intptr_t kMaxPhiDepth = 2;
+  defn = defn->OriginalDefinition();
+  if (auto alloc = defn->AsAllocateClosure()) {
+    return alloc->known_function().ptr();
+  } else if (auto constant = defn->AsConstant()) {
+    if (constant->value().IsClosure()) {
+      return Closure::Cast(constant->value()).function();
+    }
+  } else if (auto phi = defn->AsPhi()) {
+    // The depth limit also stops at loop phis.
+    if (depth >= kMaxPhiDepth) return Function::null();
+    FunctionPtr result = Function::null();
+    for (intptr_t i = 0; i < phi->InputCount(); i++) {
+      const FunctionPtr function =
+          KnownClosureFunction(phi->InputAt(i)->definition(), depth + 1);
+      if (function == Function::null() ||
+          (result != Function::null() && result != function)) {
+        return Function::null();
+      }
+      result = function;
+    }
+    return result;
+  }
+  return Function::null();
+}
+
+// Returns the counts cached for [function] by CollectGraphInfo, which may
+// not be stored on the function yet (see
+// [CompilerState::deferred_function_sizes]).
+static const CompilerState::FunctionSize* FindDeferredFunctionSize(
+    const Function& function) {
+  auto const sizes = CompilerState::Current().deferred_function_sizes();
+  if (sizes == nullptr) return nullptr;
+  for (intptr_t i = sizes->length() - 1; i >= 0; i--) {
+    if (sizes->At(i).function->ptr() == function.ptr()) {
+      return &sizes->At(i);
+    }
+  }
+  return nullptr;
+}
+
+static intptr_t OptimizedInstructionCount(const Function& function) {
+  auto const size = FindDeferredFunctionSize(function);
+  return size != nullptr ? size->instruction_count
+                         : function.optimized_instruction_count();
+}
+
+static intptr_t OptimizedCallSiteCount(const Function& function) {
+  auto const size = FindDeferredFunctionSize(function);
+  return size != nullptr ? size->call_site_count
+                         : function.optimized_call_site_count();
+}
+
+// Whether [function] was found not to be inlinable by this compilation, which
+// may not be marked on the function yet (see
+// [CompilerState::deferred_non_inlinable_functions]).
+static bool IsDeferredNonInlinable(const Function& function) {
+  auto const functions =
+      CompilerState::Current().deferred_non_inlinable_functions();
+  if (functions == nullptr) return false;
+  for (intptr_t i = 0; i < functions->length(); i++) {
+    if (functions->At(i)->ptr() == function.ptr()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void FlowGraphInliner::MarkNonInlinable(const Function& function) {
+  if (auto const functions =
+          CompilerState::Current().deferred_non_inlinable_functions()) {
+    functions->Add(&Function::ZoneHandle(function.ptr()));
+    return;
+  }
+  // Functions compiled concurrently must not observe each other's results.
+  ASSERT(Thread::Current()->task_kind() != Thread::kPrecompilerTask);
+  function.set_is_inlinable(false);
+}
+
 // Pair of an argument name and its value.
 struct NamedArgument {
   String* name;
@@ -682,7 +770,7 @@ static bool IsSmallLeafOrReduction(int inlining_depth,
       }
       if (current->IsStaticCall()) {
         const Function& function = current->AsStaticCall()->function();
-        const intptr_t inl_size = function.optimized_instruction_count();
+        const intptr_t inl_size = OptimizedInstructionCount(function);
         const bool always_inline =
             FlowGraphInliner::FunctionHasPreferInlinePragma(function);
         // Accept a static call that is always inlined in some way and add the
@@ -1015,9 +1103,14 @@ class CallSiteInliner : public ValueObject {
   };
 
   // Inlining heuristics based on Cooper et al. 2008.
+  //
+  // [known_closure_calls] is the number of calls in [callee] of closures
+  // passed to it whose function is known at the call site. Inlining the
+  // callee turns them into calls which can be inlined in turn.
   InliningDecision ShouldWeInline(const Function& callee,
                                   intptr_t instr_count,
-                                  intptr_t call_site_count) {
+                                  intptr_t call_site_count,
+                                  intptr_t known_closure_calls = 0) {
     // Pragma or size heuristics.
     if (inliner_->AlwaysInline(callee)) {
       return InliningDecision::Yes("AlwaysInline");
@@ -1044,6 +1137,10 @@ class CallSiteInliner : public ValueObject {
       return InliningDecision::Yes("--inlining-size-threshold");
     } else if (call_site_count <= FLAG_inlining_callee_call_sites_threshold) {
       return InliningDecision::Yes("--inlining-callee-call-sites-threshold");
+    } else if (known_closure_calls > 0 &&
+               instr_count <= FLAG_inlining_closure_argument_size_threshold) {
+      return InliningDecision::Yes(
+          "--inlining-closure-argument-size-threshold");
     }
     return InliningDecision::No("default");
   }
@@ -1163,7 +1260,7 @@ class CallSiteInliner : public ValueObject {
     }
 
     // Abort if the inlinable bit on the function is low.
-    if (!function.CanBeInlined()) {
+    if (!function.CanBeInlined() || IsDeferredNonInlinable(function)) {
       TRACE_INLINING(THR_Print(
           "     Bailout: not inlinable due to !function.CanBeInlined()\n"));
       PRINT_INLINING_TREE("Not inlinable", &call_data->caller, &function,
@@ -1210,7 +1307,7 @@ class CallSiteInliner : public ValueObject {
     // Abort if this function has deoptimized too much.
     if (function.deoptimization_counter() >=
         FLAG_max_deoptimization_counter_threshold) {
-      function.set_is_inlinable(false);
+      FlowGraphInliner::MarkNonInlinable(function);
       TRACE_INLINING(THR_Print("     Bailout: deoptimization threshold\n"));
       PRINT_INLINING_TREE("Deoptimization threshold exceeded",
                           &call_data->caller, &function, call_data->call);
@@ -1218,16 +1315,19 @@ class CallSiteInliner : public ValueObject {
     }
 
     // Apply early heuristics. For a specialized case
-    // (constants_arg_counts > 0), don't use a previously
-    // estimate of the call site and instruction counts.
+    // (constants_arg_counts > 0 or closure arguments with known functions),
+    // don't use a previously estimate of the call site and instruction
+    // counts.
     // Note that at this point, optional constant parameters
     // are not counted yet, which makes this decision approximate.
     GrowableArray<Value*>* arguments = call_data->arguments;
     const intptr_t constant_arg_count = CountConstants(*arguments);
+    const bool is_specialized =
+        constant_arg_count > 0 || HasKnownClosureArguments(*arguments);
     const intptr_t instruction_count =
-        constant_arg_count == 0 ? function.optimized_instruction_count() : 0;
+        !is_specialized ? OptimizedInstructionCount(function) : 0;
     const intptr_t call_site_count =
-        constant_arg_count == 0 ? function.optimized_call_site_count() : 0;
+        !is_specialized ? OptimizedCallSiteCount(function) : 0;
     InliningDecision decision =
         ShouldWeInline(function, instruction_count, call_site_count);
     if (!decision.value) {
@@ -1382,7 +1482,7 @@ class CallSiteInliner : public ValueObject {
           if (!AdjustForOptionalParameters(
                   *parsed_function, first_actual_param_index, argument_names,
                   arguments, param_stubs, callee_graph)) {
-            function.set_is_inlinable(false);
+            FlowGraphInliner::MarkNonInlinable(function);
             TRACE_INLINING(THR_Print("     Bailout: optional arg mismatch\n"));
             PRINT_INLINING_TREE("Optional arg mismatch", &call_data->caller,
                                 &function, call_data->call);
@@ -1474,28 +1574,38 @@ class CallSiteInliner : public ValueObject {
         }
         intptr_t instruction_count = 0;
         intptr_t call_site_count = 0;
-        FlowGraphInliner::CollectGraphInfo(callee_graph, constants_count,
-                                           /*force*/ false, &instruction_count,
-                                           &call_site_count);
+        FlowGraphInliner::CollectGraphInfo(
+            callee_graph,
+            constants_count + CountKnownClosureArguments(*arguments),
+            /*force*/ false, &instruction_count, &call_site_count);
+        intptr_t closure_parameter_calls = 0;
+        const intptr_t known_closure_calls = CountClosureParameterCalls(
+            callee_graph, *arguments, *param_stubs, &closure_parameter_calls);
 
         // Use heuristics do decide if this call should be inlined.
         {
           COMPILER_TIMINGS_TIMER_SCOPE(thread(), MakeInliningDecision);
           InliningDecision decision =
-              ShouldWeInline(function, instruction_count, call_site_count);
+              ShouldWeInline(function, instruction_count, call_site_count,
+                             known_closure_calls);
           if (!decision.value) {
-            // If size is larger than all thresholds, don't consider it again.
+            // If size is larger than all thresholds, don't consider it again,
+            // unless the function calls closures passed to it and another
+            // call site may pass closures with known functions.
 
             // TODO(dartbug.com/49665): Make compiler smart enough so it itself
             // can identify highly-specialized functions that should always
             // be considered for inlining, without relying on a pragma.
             if ((instruction_count > FLAG_inlining_size_threshold) &&
-                (call_site_count > FLAG_inlining_callee_call_sites_threshold)) {
+                (call_site_count > FLAG_inlining_callee_call_sites_threshold) &&
+                (closure_parameter_calls == 0 ||
+                 instruction_count >
+                     FLAG_inlining_closure_argument_size_threshold)) {
               // Will keep trying to inline the function if it can be
               // specialized based on argument types.
               if (!FlowGraphInliner::FunctionHasAlwaysConsiderInliningPragma(
                       function)) {
-                function.set_is_inlinable(false);
+                FlowGraphInliner::MarkNonInlinable(function);
                 TRACE_INLINING(THR_Print("     Mark not inlinable\n"));
               }
             }
@@ -1718,6 +1828,65 @@ class CallSiteInliner : public ValueObject {
     return count;
   }
 
+  static bool IsKnownClosure(Value* value) {
+    return value != nullptr &&
+           KnownClosureFunction(value->definition()) != Function::null();
+  }
+
+  static bool HasKnownClosureArguments(const GrowableArray<Value*>& arguments) {
+    for (intptr_t i = 0; i < arguments.length(); i++) {
+      if (IsKnownClosure(arguments[i])) return true;
+    }
+    return false;
+  }
+
+  // The number of closures with known functions passed as non-constant
+  // arguments, which specialize the callee like constant arguments.
+  static intptr_t CountKnownClosureArguments(
+      const GrowableArray<Value*>& arguments) {
+    intptr_t count = 0;
+    for (intptr_t i = 0; i < arguments.length(); i++) {
+      if (IsKnownClosure(arguments[i]) && !arguments[i]->BindsToConstant()) {
+        count++;
+      }
+    }
+    return count;
+  }
+
+  // Returns the number of closure calls in [callee_graph] whose closure is a
+  // parameter passed a closure with a known function, and sets
+  // [*closure_parameter_calls] to the number of closure calls whose closure
+  // is any parameter. [arguments] and [param_stubs] are in one-to-one
+  // correspondence with the parameters at their ends, but only [arguments]
+  // contains the type arguments passed to non-generic functions.
+  static intptr_t CountClosureParameterCalls(
+      FlowGraph* callee_graph,
+      const GrowableArray<Value*>& arguments,
+      const ZoneGrowableArray<Definition*>& param_stubs,
+      intptr_t* closure_parameter_calls) {
+    const intptr_t offset = arguments.length() - param_stubs.length();
+    intptr_t known_calls = 0;
+    *closure_parameter_calls = 0;
+    for (BlockIterator block_it = callee_graph->postorder_iterator();
+         !block_it.Done(); block_it.Advance()) {
+      for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+           it.Advance()) {
+        ClosureCallInstr* call = it.Current()->AsClosureCall();
+        if (call == nullptr) continue;
+        Definition* closure =
+            call->Receiver()->definition()->OriginalDefinition();
+        for (intptr_t i = Utils::Maximum<intptr_t>(0, -offset);
+             i < param_stubs.length(); i++) {
+          if (param_stubs[i] != closure) continue;
+          (*closure_parameter_calls)++;
+          if (IsKnownClosure(arguments[i + offset])) known_calls++;
+          break;
+        }
+      }
+    }
+    return known_calls;
+  }
+
   // Parse a function reusing the cache if possible.
   ParsedFunction* GetParsedFunction(const Function& function, bool* in_cache) {
     // TODO(zerny): Use a hash map for the cache.
@@ -1794,15 +1963,7 @@ class CallSiteInliner : public ValueObject {
       ASSERT(call->ArgumentCount() > 0);
       Function& target = Function::ZoneHandle(call->target_function().ptr());
       if (target.IsNull()) {
-        Definition* receiver =
-            call->Receiver()->definition()->OriginalDefinition();
-        if (const auto* alloc = receiver->AsAllocateClosure()) {
-          target = alloc->known_function().ptr();
-        } else if (ConstantInstr* constant = receiver->AsConstant()) {
-          if (constant->value().IsClosure()) {
-            target = Closure::Cast(constant->value()).function();
-          }
-        }
+        target = KnownClosureFunction(call->Receiver()->definition());
       }
 
       if (target.IsNull()) {
@@ -1840,8 +2001,10 @@ class CallSiteInliner : public ValueObject {
                              call_info.length()));
     for (intptr_t call_idx = 0; call_idx < call_info.length(); ++call_idx) {
       PolymorphicInstanceCallInstr* call = call_info[call_idx].call;
-      // PolymorphicInliner introduces deoptimization paths.
-      if (!call->complete() && !FLAG_polymorphic_with_deopt) {
+      // PolymorphicInliner introduces deoptimization paths, except in AOT
+      // where incomplete calls keep a fallback call instead.
+      if (!call->complete() && !FLAG_polymorphic_with_deopt &&
+          !CompilerState::Current().is_aot()) {
         TRACE_INLINING(THR_Print("  => %s\n     Bailout: call with checks\n",
                                  call->function_name().ToCString()));
         continue;
@@ -2136,13 +2299,17 @@ TargetEntryInstr* PolymorphicInliner::BuildDecisionGraph() {
       new (Z) LoadClassIdInstr(new (Z) Value(receiver), cid_representation);
   owner_->caller_graph()->AllocateSSAIndex(load_cid);
   cursor = AppendInstruction(cursor, load_cid);
+  // An incomplete call cannot deoptimize in AOT, so receivers which match
+  // none of the inlined variants fall back to a call.
+  const bool needs_fallback =
+      !call_->complete() && CompilerState::Current().is_aot();
   for (intptr_t i = 0; i < inlined_variants_.length(); ++i) {
     const CidRange& variant = inlined_variants_[i];
     bool is_last_test = (i == inlined_variants_.length() - 1);
     // 1. Guard the body with a class id check.  We don't need any check if
     // it's the last test and global analysis has told us that the call is
     // complete.
-    if (is_last_test && non_inlined_variants_->is_empty()) {
+    if (is_last_test && non_inlined_variants_->is_empty() && !needs_fallback) {
       // If it is the last variant use a check class id instruction which can
       // deoptimize, followed unconditionally by the body. Omit the check if
       // we know that we have covered all possible classes.
@@ -2280,9 +2447,14 @@ TargetEntryInstr* PolymorphicInliner::BuildDecisionGraph() {
   ASSERT(!call_->HasMoveArguments());
 
   // Handle any non-inlined variants.
-  if (!non_inlined_variants_->is_empty()) {
+  if (!non_inlined_variants_->is_empty() || needs_fallback) {
+    // A call has to have at least one target, so a fallback for receivers
+    // which were not seen at all keeps the targets of the inlined variants.
+    const CallTargets& fallback_targets = non_inlined_variants_->is_empty()
+                                              ? variants_
+                                              : *non_inlined_variants_;
     PolymorphicInstanceCallInstr* fallback_call =
-        PolymorphicInstanceCallInstr::FromCall(Z, call_, *non_inlined_variants_,
+        PolymorphicInstanceCallInstr::FromCall(Z, call_, fallback_targets,
                                                call_->complete());
     owner_->caller_graph()->AllocateSSAIndex(fallback_call);
     fallback_call->InheritDeoptTarget(zone(), call_);
@@ -2335,7 +2507,7 @@ bool PolymorphicInliner::Inline() {
     const bool try_harder = (var_idx >= variants_.length() - 2) &&
                             non_inlined_variants_->length() == 0;
 
-    intptr_t size = target.optimized_instruction_count();
+    intptr_t size = OptimizedInstructionCount(target);
     bool small = (size != 0 && size < FLAG_inlining_size_threshold);
 
     // If it's less than 3% of the dispatches, we won't even consider
@@ -2436,14 +2608,41 @@ void FlowGraphInliner::CollectGraphInfo(FlowGraph* flow_graph,
   }
   // Non-specialized case: unless forced, only recompute on a cache miss.
   ASSERT(constants_count == 0);
-  if (force || (function.optimized_instruction_count() == 0)) {
+  if (force || (OptimizedInstructionCount(function) == 0)) {
     GraphInfoCollector info;
     info.Collect(*flow_graph);
-    function.SetOptimizedInstructionCountClamped(info.instruction_count());
-    function.SetOptimizedCallSiteCountClamped(info.call_site_count());
+    if (auto const sizes = CompilerState::Current().deferred_function_sizes()) {
+      sizes->Add({&Function::ZoneHandle(function.ptr()),
+                  Utils::Minimum(info.instruction_count(),
+                                 Function::kMaxInstructionCount),
+                  Utils::Minimum(info.call_site_count(),
+                                 Function::kMaxInstructionCount),
+                  force});
+    } else {
+      function.SetOptimizedInstructionCountClamped(info.instruction_count());
+      function.SetOptimizedCallSiteCountClamped(info.call_site_count());
+    }
+  }
+  *instruction_count = OptimizedInstructionCount(function);
+  *call_site_count = OptimizedCallSiteCount(function);
+}
+
+void FlowGraphInliner::PublishFunctionSizes(
+    const ZoneGrowableArray<CompilerState::FunctionSize>& sizes) {
+  for (const auto& size : sizes) {
+    const Function& function = *size.function;
+    if (size.force || (function.optimized_instruction_count() == 0)) {
+      function.SetOptimizedInstructionCountClamped(size.instruction_count);
+      function.SetOptimizedCallSiteCountClamped(size.call_site_count);
+    }
+  }
+}
+
+void FlowGraphInliner::PublishNonInlinableFunctions(
+    const ZoneGrowableArray<const Function*>& functions) {
+  for (const Function* function : functions) {
+    function->set_is_inlinable(false);
   }
-  *instruction_count = function.optimized_instruction_count();
-  *call_site_count = function.optimized_call_site_count();
 }
 
 void FlowGraphInliner::SetInliningId(FlowGraph* flow_graph,
@@ -2540,7 +2739,7 @@ bool FlowGraphInliner::AlwaysInline(const Function& function) {
   if (function.IsGetterFunction() || function.IsSetterFunction() ||
       IsInlineableOperator(function) ||
       (function.kind() == UntaggedFunction::kConstructor)) {
-    const intptr_t count = function.optimized_instruction_count();
+    const intptr_t count = OptimizedInstructionCount(function);
     if ((count != 0) && (count < FLAG_inline_getters_setters_smaller_than)) {
       return true;
     }
@@ -10,6 +10,7 @@
 #endif  // defined(DART_PRECOMPILED_RUNTIME)
 
 #include "vm/allocation.h"
+#include "vm/compiler/compiler_state.h"
 #include "vm/growable_array.h"
 #include "vm/token_position.h"
 
@@ -117,6 +118,21 @@ class FlowGraphInliner : ValueObject {
                                intptr_t* instruction_count,
                                intptr_t* call_site_count);
 
+  // Caches the counts recorded in [sizes] on their functions, as if they were
+  // computed by [CollectGraphInfo] in order.
+  static void PublishFunctionSizes(
+      const ZoneGrowableArray<CompilerState::FunctionSize>& sizes);
+
+  // Marks the functions in [functions] as not inlinable, as if they were
+  // marked by the inliner in order.
+  static void PublishNonInlinableFunctions(
+      const ZoneGrowableArray<const Function*>& functions);
+
+  // Marks [function] as not inlinable, or records it to be marked later if
+  // the current compilation defers it (see
+  // [CompilerState::deferred_non_inlinable_functions]).
+  static void MarkNonInlinable(const Function& function);
+
   static void SetInliningId(FlowGraph* flow_graph, intptr_t inlining_id);
 
   bool AlwaysInline(const Function& function);
@@ -17,6 +17,13 @@
 
 namespace dart {
 
+DEFINE_FLAG(int,
+            fast_register_allocation_threshold,
+            10000,
+            "Allocate registers with fewer heuristics in JIT compiled "
+            "functions with more virtual registers than this, or never if "
+            "negative.");
+
 #if !defined(PRODUCT)
 #define INCLUDE_LINEAR_SCAN_TRACING_CODE
 #endif
@@ -115,7 +122,11 @@ FlowGraphAllocator::FlowGraphAllocator(const FlowGraph& flow_graph,
       quad_spill_slots_(),
       untagged_spill_slots_(),
       cpu_spill_slot_count_(0),
-      intrinsic_mode_(intrinsic_mode) {
+      intrinsic_mode_(intrinsic_mode),
+      fast_mode_(!intrinsic_mode && !CompilerState::Current().is_aot() &&
+                 FLAG_fast_register_allocation_threshold >= 0 &&
+                 flow_graph.max_vreg() >
+                     FLAG_fast_register_allocation_threshold) {
   for (intptr_t i = 0; i < vreg_count_; i++) {
     live_ranges_.Add(nullptr);
   }
@@ -610,7 +621,8 @@ void FlowGraphAllocator::BuildLiveRanges() {
     }
 
     LoopInfo* loop_info = block->loop_info();
-    if ((loop_info != nullptr) && (loop_info->IsBackEdge(block))) {
+    if ((loop_info != nullptr) && (loop_info->IsBackEdge(block)) &&
+        !fast_mode_) {
       BitVector* backedge_interference =
           extra_loop_info_[loop_info->id()]->backedge_interference;
       if (backedge_interference != nullptr) {
@@ -1985,8 +1997,11 @@ LiveRange* FlowGraphAllocator::SplitBetween(LiveRange* range,
     //     def------------use     -----------
     //            ^      ^        ^
     //            H      S        X
+    //
+    // In fast mode only the loops containing the block itself are considered,
+    // as finding the loop which S linearly appears in visits all loops.
     LoopInfo* loop_info = split_block_entry->loop_info();
-    if (loop_info == nullptr) {
+    if (loop_info == nullptr && !fast_mode_) {
       const LoopHierarchy& loop_hierarchy = flow_graph_.loop_hierarchy();
       const intptr_t num_loops = loop_hierarchy.num_loops();
       for (intptr_t i = 0; i < num_loops; i++) {
@@ -2381,9 +2396,9 @@ bool FlowGraphAllocator::AllocateFreeRegister(LiveRange* unallocated) {
   // We have a very good candidate (either hinted to us or completely free).
   // If we are in a loop try to reduce number of moves on the back edge by
   // searching for a candidate that does not interfere with phis on the back
-  // edge.
+  // edge. Fast mode does not compute the interference on back edges.
   LoopInfo* loop_info = BlockEntryAt(unallocated->Start())->loop_info();
-  if ((unallocated->vreg() >= 0) && (loop_info != nullptr) &&
+  if (!fast_mode_ && (unallocated->vreg() >= 0) && (loop_info != nullptr) &&
       (free_until >= extra_loop_info_[loop_info->id()]->end) &&
       extra_loop_info_[loop_info->id()]->backedge_interference->Contains(
           unallocated->vreg())) {
@@ -2526,11 +2541,12 @@ void FlowGraphAllocator::AllocateAnyRegister(LiveRange* unallocated) {
   // to the register to reduce amount of memory moves on the back edge.
   // This is possible if there is a register blocked by a range that can be
   // cheaply evicted i.e. it has no register beneficial uses inside the
-  // loop.
+  // loop. Fast mode always spills them.
   UsePosition* register_use =
       unallocated->finger()->FirstRegisterUse(unallocated->Start());
   if ((register_use == nullptr) &&
-      !(unallocated->is_loop_phi() && HasCheapEvictionCandidate(unallocated))) {
+      !(unallocated->is_loop_phi() && !fast_mode_ &&
+        HasCheapEvictionCandidate(unallocated))) {
     Spill(unallocated);
     return;
   }
@@ -2839,22 +2855,24 @@ static inline bool ShouldBeAllocatedBefore(LiveRange* a, LiveRange* b) {
   return a->Start() <= b->Start();
 }
 
+// The list is sorted so that the next range to allocate is the last one.
 static void AddToSortedListOfRanges(GrowableArray<LiveRange*>* list,
                                     LiveRange* range) {
   range->finger()->Initialize(range);
 
-  if (list->is_empty()) {
-    list->Add(range);
-    return;
-  }
-
-  for (intptr_t i = list->length() - 1; i >= 0; i--) {
-    if (ShouldBeAllocatedBefore(range, (*list)[i])) {
-      list->InsertAt(i + 1, range);
-      return;
+  // Split tails start after most of the pending ranges, so a linear search
+  // from the end would visit most of the list.
+  intptr_t lo = 0;
+  intptr_t hi = list->length();
+  while (lo < hi) {
+    const intptr_t mid = lo + (hi - lo) / 2;
+    if (ShouldBeAllocatedBefore(range, (*list)[mid])) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
     }
   }
-  list->InsertAt(0, range);
+  list->InsertAt(lo, range);
 }
 
 void FlowGraphAllocator::AddToUnallocated(LiveRange* range) {
@@ -3441,6 +3459,9 @@ void FlowGraphAllocator::ScheduleParallelMoves() {
 }
 
 void FlowGraphAllocator::AllocateRegisters() {
+  TRACE_ALLOC(THR_Print("Allocating registers in %s mode\n",
+                        fast_mode_ ? "fast" : "regular"));
+
   CollectRepresentations();
 
   liveness_.Analyze();
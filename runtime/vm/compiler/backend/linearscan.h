@@ -378,6 +378,10 @@ class FlowGraphAllocator : public ValueObject {
 
   const bool intrinsic_mode_;
 
+  // Whether heuristics which are slow for large functions are skipped, see
+  // --fast_register_allocation_threshold. Used by the JIT only.
+  const bool fast_mode_;
+
   DISALLOW_COPY_AND_ASSIGN(FlowGraphAllocator);
 };
 
@@ -0,0 +1,719 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include <utility>
+
+#include "vm/bit_vector.h"
+#include "vm/compiler/backend/flow_graph.h"
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/range_analysis.h"
+#include "vm/flags.h"
+
+namespace dart {
+
+DEFINE_FLAG(bool,
+            loop_vectorization,
+            true,
+            "Vectorize element-wise loops over typed data.");
+
+// The number of bytes processed by one iteration of a vector loop.
+static constexpr intptr_t kVectorSize = 16;
+
+// Returns the class id of the vector accesses to typed data with the given
+// class id, or kIllegalCid if its elements cannot be vectorized.
+static classid_t VectorClassId(classid_t cid) {
+  switch (cid) {
+    case kTypedDataInt8ArrayCid:
+    case kTypedDataUint8ArrayCid:
+    case kTypedDataInt32ArrayCid:
+    case kTypedDataUint32ArrayCid:
+      return kTypedDataInt32x4ArrayCid;
+    case kTypedDataFloat32ArrayCid:
+      return kTypedDataFloat32x4ArrayCid;
+    default:
+      return kIllegalCid;
+  }
+}
+
+static intptr_t ElementSize(classid_t cid) {
+  return RepresentationUtils::ValueSize(
+      RepresentationUtils::RepresentationOfArrayElement(cid));
+}
+
+static bool IsInvariant(LoopInfo* loop, Definition* def) {
+  return !loop->Contains(def->GetBlock());
+}
+
+static bool IsInt64Constant(Definition* def, int64_t* value) {
+  ConstantInstr* constant = def->AsConstant();
+  if (constant == nullptr || !constant->value().IsInteger()) {
+    return false;
+  }
+  *value = Integer::Cast(constant->value()).AsInt64Value();
+  return true;
+}
+
+// Returns true if def is a double constant which is exactly representable
+// as a float.
+static bool IsFloatConstant(Definition* def) {
+  ConstantInstr* constant = def->AsConstant();
+  if (constant == nullptr || !constant->value().IsDouble()) {
+    return false;
+  }
+  const double value = Double::Cast(constant->value()).value();
+  return static_cast<double>(static_cast<float>(value)) == value;
+}
+
+// Returns true if def is a double holding a float value. A single addition,
+// subtraction, multiplication or division of two such values rounded to a
+// float gives the same result as the operation in single precision, which
+// does not hold for chains of double operations.
+static bool IsFloatOperand(Definition* def) {
+  return def->IsFloatToDouble() || IsFloatConstant(def);
+}
+
+// Returns true if all uses of def round it to a float.
+static bool HasOnlyFloatUses(Definition* def) {
+  if (def->env_use_list() != nullptr) {
+    return false;
+  }
+  for (Value* use = def->input_use_list(); use != nullptr;
+       use = use->next_use()) {
+    if (!use->instruction()->IsDoubleToFloat()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if the loop bound def is small enough for the index of the
+// last element of a vector to be computed without overflow.
+static bool IsSmallLimit(Definition* def) {
+  int64_t value = 0;
+  if (IsInt64Constant(def, &value)) {
+    return value <= kMaxInt64 - kVectorSize;
+  }
+  return RangeUtils::IsWithin(def->range(), kMinInt64,
+                              kMaxInt64 - kVectorSize);
+}
+
+// Maps a double comparison to a Float32x4 comparison. Greater than
+// comparisons swap their operands, so that lanes with NaN compare false.
+static bool FloatCompareKind(Token::Kind kind,
+                             SimdOpInstr::Kind* simd_kind,
+                             bool* swap) {
+  *swap = false;
+  switch (kind) {
+    case Token::kEQ:
+      *simd_kind = SimdOpInstr::kFloat32x4Equal;
+      return true;
+    case Token::kNE:
+      *simd_kind = SimdOpInstr::kFloat32x4NotEqual;
+      return true;
+    case Token::kLT:
+      *simd_kind = SimdOpInstr::kFloat32x4LessThan;
+      return true;
+    case Token::kLTE:
+      *simd_kind = SimdOpInstr::kFloat32x4LessThanOrEqual;
+      return true;
+    case Token::kGT:
+      *simd_kind = SimdOpInstr::kFloat32x4LessThan;
+      *swap = true;
+      return true;
+    case Token::kGTE:
+      *simd_kind = SimdOpInstr::kFloat32x4LessThanOrEqual;
+      *swap = true;
+      return true;
+    default:
+      return false;
+  }
+}
+
+LoopVectorizer::LoopVectorizer(FlowGraph* flow_graph)
+    : flow_graph_(flow_graph),
+      zone_(flow_graph->zone()),
+      vectors_(),
+      index_(nullptr),
+      next_index_(nullptr),
+      element_size_(0),
+      has_stores_(false),
+      arrays_(),
+      array_cids_(),
+      limits_() {}
+
+bool LoopVectorizer::Optimize() {
+  // Vector accesses use unboxed 64-bit indices.
+  if (!FLAG_loop_vectorization || flow_graph_->IsCompiledForOsr() ||
+      !FlowGraphCompiler::SupportsUnboxedSimd128() ||
+      compiler::target::kWordSize != 8) {
+    return false;
+  }
+  const ZoneGrowableArray<BlockEntryInstr*>& loop_headers =
+      flow_graph_->GetLoopHierarchy().headers();
+
+  bool changed = false;
+  for (intptr_t i = 0; i < loop_headers.length(); ++i) {
+    LoopInfo* loop = loop_headers[i]->loop_info();
+    if (loop->inner() == nullptr) {
+      changed = Vectorize(loop) || changed;
+    }
+  }
+  if (changed) {
+    // The vector loops changed the predecessors of the original loops.
+    flow_graph_->DiscoverBlocks();
+    GrowableArray<BitVector*> dominance_frontier;
+    flow_graph_->ComputeDominators(&dominance_frontier);
+  }
+  return changed;
+}
+
+bool LoopVectorizer::Vectorize(LoopInfo* loop) {
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  if (header == nullptr || header->InsideTryBlock() ||
+      header->PredecessorCount() != 2 || loop->back_edges().length() != 1) {
+    return false;
+  }
+  BlockEntryInstr* body = loop->back_edges()[0];
+  if (body == header || body->PredecessorCount() != 1 ||
+      body->PredecessorAt(0) != header ||
+      !body->last_instruction()->IsGoto()) {
+    return false;
+  }
+  BlockEntryInstr* preheader = header->PredecessorAt(0) == body
+                                   ? header->PredecessorAt(1)
+                                   : header->PredecessorAt(0);
+
+  // The header may only test i < n.
+  CheckStackOverflowInstr* check = nullptr;
+  for (ForwardInstructionIterator it(header); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->IsCheckStackOverflow() && check == nullptr) {
+      check = current->AsCheckStackOverflow();
+    } else if (current != header->last_instruction()) {
+      return false;
+    }
+  }
+  BranchInstr* branch = header->last_instruction()->AsBranch();
+  if (branch == nullptr || branch->true_successor() != body) {
+    return false;
+  }
+  RelationalOpInstr* compare = branch->comparison()->AsRelationalOp();
+  if (compare == nullptr || compare->kind() != Token::kLT ||
+      compare->operation_cid() != kMintCid) {
+    return false;
+  }
+  index_ = compare->left()->definition()->AsPhi();
+  Definition* limit = compare->right()->definition();
+  if (index_ == nullptr || index_->block() != header ||
+      index_->representation() != kUnboxedInt64 ||
+      !IsInvariant(loop, limit)) {
+    return false;
+  }
+  // The vector loop only computes the index, so it has to be the only value
+  // carried between iterations.
+  intptr_t num_phis = 0;
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    num_phis++;
+  }
+  if (num_phis != 1) {
+    return false;
+  }
+
+  const intptr_t entry_index = header->IndexOfPredecessor(preheader);
+  Definition* initial = index_->InputAt(entry_index)->definition();
+  Value* back_edge_input = index_->InputAt(1 - entry_index);
+  BinaryInt64OpInstr* next = back_edge_input->definition()->AsBinaryInt64Op();
+  int64_t stride = 0;
+  if (next == nullptr || next->GetBlock() != body ||
+      next->op_kind() != Token::kADD || next->left()->definition() != index_ ||
+      !IsInt64Constant(next->right()->definition(), &stride) || stride != 1 ||
+      !next->HasOnlyUse(back_edge_input)) {
+    return false;
+  }
+  next_index_ = next;
+
+  // Vectors are only accessed at indices the original loop would access,
+  // which requires a non-negative start.
+  int64_t initial_value = 0;
+  if (IsInt64Constant(initial, &initial_value)
+          ? (initial_value < 0 || initial_value > kMaxInt64 - kVectorSize)
+          : !RangeUtils::IsWithin(initial->range(), 0,
+                                  kMaxInt64 - kVectorSize)) {
+    return false;
+  }
+
+  element_size_ = 0;
+  has_stores_ = false;
+  arrays_.Clear();
+  array_cids_.Clear();
+  limits_.Clear();
+  limits_.Add(limit);
+  if (!CollectAccesses(loop, body)) {
+    return false;
+  }
+  // The vector index is bounded by the smallest limit, so one of them has to
+  // be small enough.
+  bool has_small_limit = false;
+  for (Definition* def : limits_) {
+    has_small_limit = has_small_limit || IsSmallLimit(def);
+  }
+  if (!has_small_limit) {
+    return false;
+  }
+
+  // A store to one array could change elements of another array which are
+  // loaded in a different vector. This cannot happen if all arrays are
+  // internal typed data, which only share elements if they are identical.
+  GrowableArray<intptr_t> guarded;
+  if (has_stores_ && arrays_.length() > 1) {
+    for (intptr_t i = 0; i < arrays_.length(); ++i) {
+      if (arrays_[i]->representation() != kTagged) {
+        return false;
+      }
+      const intptr_t cid = arrays_[i]->Type()->ToCid();
+      if (cid == kDynamicCid) {
+        guarded.Add(i);
+      } else if (cid != array_cids_[i]) {
+        return false;
+      }
+    }
+  }
+
+  // Compute the vector body before changing the graph, so a loop with an
+  // unsupported instruction is left untouched.
+  JoinEntryInstr* vector_header = new (zone_) JoinEntryInstr(
+      flow_graph_->allocate_block_id(), kInvalidTryIndex, DeoptId::kNone);
+  PhiInstr* vector_index = new (zone_) PhiInstr(vector_header, 2);
+  vectors_.Clear();
+  GrowableArray<Instruction*> vector_instrs;
+  for (ForwardInstructionIterator it(body); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current == next || current == body->last_instruction() ||
+        (current->IsDefinition() && IsIndex(current->AsDefinition()))) {
+      continue;
+    }
+    if (!VectorizeInstruction(current, vector_index, &vector_instrs)) {
+      return false;
+    }
+  }
+
+  const intptr_t factor = kVectorSize / element_size_;
+  const InstructionSource& source = compare->source();
+  GrowableArray<TargetEntryInstr*> exits;
+  GrowableArray<Definition*> exit_values;
+
+  // Check the arrays in the preheader and enter the vector loop.
+  BlockEntryInstr* current_block = preheader;
+  Instruction* cursor = preheader->last_instruction()->previous();
+  for (intptr_t i : guarded) {
+    LoadClassIdInstr* load_cid = new (zone_)
+        LoadClassIdInstr(new (zone_) Value(arrays_[i]), kUnboxedUword);
+    cursor =
+        flow_graph_->AppendTo(cursor, load_cid, nullptr, FlowGraph::kValue);
+    ConstantInstr* cid = flow_graph_->GetConstant(
+        Smi::ZoneHandle(zone_, Smi::New(array_cids_[i])), kUnboxedUword);
+    ComparisonInstr* is_internal = new (zone_) EqualityCompareInstr(
+        source, Token::kEQ, new (zone_) Value(load_cid),
+        new (zone_) Value(cid), kIntegerCid, DeoptId::kNone, false,
+        Instruction::kNotSpeculative);
+    current_block = AppendBranch(current_block, cursor, is_internal, &exits);
+    cursor = current_block;
+    exit_values.Add(initial);
+  }
+  GotoInstr* enter = new (zone_) GotoInstr(vector_header, DeoptId::kNone);
+  flow_graph_->AppendTo(cursor, enter, nullptr, FlowGraph::kEffect);
+  current_block->set_last_instruction(enter);
+
+  // The vector header checks that all elements of the next vector are
+  // within the limits.
+  flow_graph_->AllocateSSAIndex(vector_index);
+  vector_index->set_representation(kUnboxedInt64);
+  vector_index->mark_alive();
+  vector_header->InsertPhi(vector_index);
+  cursor = vector_header;
+  if (check != nullptr) {
+    cursor = flow_graph_->AppendTo(
+        cursor,
+        new (zone_) CheckStackOverflowInstr(
+            check->source(), check->stack_depth(), check->loop_depth(),
+            DeoptId::kNone, CheckStackOverflowInstr::kOsrAndPreemption),
+        nullptr, FlowGraph::kEffect);
+  }
+  Definition* last_index = new (zone_) BinaryInt64OpInstr(
+      Token::kADD, new (zone_) Value(vector_index),
+      new (zone_) Value(flow_graph_->GetConstant(
+          Integer::Handle(zone_, Integer::NewCanonical(factor - 1)),
+          kUnboxedInt64)),
+      DeoptId::kNone, Instruction::kNotSpeculative);
+  cursor =
+      flow_graph_->AppendTo(cursor, last_index, nullptr, FlowGraph::kValue);
+  current_block = vector_header;
+  for (Definition* def : limits_) {
+    ComparisonInstr* in_bounds = new (zone_) RelationalOpInstr(
+        source, Token::kLT, new (zone_) Value(last_index),
+        new (zone_) Value(def), kMintCid, DeoptId::kNone,
+        Instruction::kNotSpeculative);
+    current_block = AppendBranch(current_block, cursor, in_bounds, &exits);
+    cursor = current_block;
+    exit_values.Add(vector_index);
+  }
+
+  // The vector body.
+  BlockEntryInstr* vector_body = current_block;
+  for (Instruction* instr : vector_instrs) {
+    cursor = flow_graph_->AppendTo(
+        cursor, instr, nullptr,
+        instr->IsDefinition() ? FlowGraph::kValue : FlowGraph::kEffect);
+  }
+  Definition* vector_next = new (zone_) BinaryInt64OpInstr(
+      Token::kADD, new (zone_) Value(vector_index),
+      new (zone_) Value(flow_graph_->GetConstant(
+          Integer::Handle(zone_, Integer::NewCanonical(factor)),
+          kUnboxedInt64)),
+      DeoptId::kNone, Instruction::kNotSpeculative);
+  cursor =
+      flow_graph_->AppendTo(cursor, vector_next, nullptr, FlowGraph::kValue);
+  GotoInstr* back_edge = new (zone_) GotoInstr(vector_header, DeoptId::kNone);
+  flow_graph_->AppendTo(cursor, back_edge, nullptr, FlowGraph::kEffect);
+  vector_body->set_last_instruction(back_edge);
+
+  // The predecessors of a join are ordered by block id, so the entry comes
+  // before the back edge.
+  Value* input = new (zone_) Value(initial);
+  vector_index->SetInputAt(0, input);
+  initial->AddInputUse(input);
+  input = new (zone_) Value(vector_next);
+  vector_index->SetInputAt(1, input);
+  vector_next->AddInputUse(input);
+
+  // The original loop processes the remaining elements, starting with the
+  // first one the vector loop did not process.
+  JoinEntryInstr* resume = nullptr;
+  Definition* resume_index = nullptr;
+  if (exits.length() == 1) {
+    resume_index = exit_values[0];
+  } else {
+    resume = new (zone_) JoinEntryInstr(flow_graph_->allocate_block_id(),
+                                        kInvalidTryIndex, DeoptId::kNone);
+    if (guarded.is_empty()) {
+      resume_index = vector_index;
+    } else {
+      PhiInstr* phi = new (zone_) PhiInstr(resume, exits.length());
+      flow_graph_->AllocateSSAIndex(phi);
+      phi->set_representation(kUnboxedInt64);
+      phi->mark_alive();
+      for (intptr_t i = 0; i < exits.length(); ++i) {
+        input = new (zone_) Value(exit_values[i]);
+        phi->SetInputAt(i, input);
+        exit_values[i]->AddInputUse(input);
+      }
+      resume->InsertPhi(phi);
+      resume_index = phi;
+    }
+    GotoInstr* goto_header = new (zone_) GotoInstr(header, DeoptId::kNone);
+    flow_graph_->AppendTo(resume, goto_header, nullptr, FlowGraph::kEffect);
+    resume->set_last_instruction(goto_header);
+  }
+  for (TargetEntryInstr* exit : exits) {
+    GotoInstr* goto_resume = new (zone_) GotoInstr(
+        resume != nullptr ? resume : header, DeoptId::kNone);
+    flow_graph_->AppendTo(exit, goto_resume, nullptr, FlowGraph::kEffect);
+    exit->set_last_instruction(goto_resume);
+  }
+
+  // The body of the original loop now comes before the new entry.
+  index_->InputAt(0)->BindTo(next);
+  index_->InputAt(1)->BindTo(resume_index);
+
+  if (FLAG_trace_optimization && flow_graph_->should_print()) {
+    THR_Print("Vectorized loop B%" Pd " into B%" Pd " (%" Pd
+              " elements per iteration)\n",
+              header->block_id(), vector_header->block_id(), factor);
+  }
+  return true;
+}
+
+bool LoopVectorizer::IsIndex(Definition* def) const {
+  if (def == index_) {
+    return true;
+  }
+  if (auto box = def->AsBoxInt64()) {
+    return IsIndex(box->value()->definition());
+  }
+  if (auto check = def->AsGenericCheckBound()) {
+    return IsIndex(check->index()->definition());
+  }
+  return false;
+}
+
+bool LoopVectorizer::CollectAccesses(LoopInfo* loop, BlockEntryInstr* body) {
+  for (ForwardInstructionIterator it(body); !it.Done(); it.Advance()) {
+    Instruction* current = it.Current();
+    if (current->env() != nullptr) {
+      return false;
+    }
+    Definition* array = nullptr;
+    Value* index = nullptr;
+    classid_t cid = kIllegalCid;
+    if (auto load = current->AsLoadIndexed()) {
+      array = load->array()->definition();
+      index = load->index();
+      cid = load->class_id();
+    } else if (auto store = current->AsStoreIndexed()) {
+      if (store->ShouldEmitStoreBarrier()) {
+        return false;
+      }
+      array = store->array()->definition();
+      index = store->index();
+      cid = store->class_id();
+      has_stores_ = true;
+    } else if (auto check = current->AsGenericCheckBound()) {
+      Definition* length = check->length()->definition();
+      if (!IsIndex(check->index()->definition()) ||
+          !IsInvariant(loop, length)) {
+        return false;
+      }
+      if (!limits_.Contains(length)) {
+        limits_.Add(length);
+      }
+      continue;
+    } else {
+      // Other uses of the index cannot be vectorized.
+      const bool uses_index = current == next_index_ || current->IsBoxInt64();
+      for (intptr_t i = 0; i < current->InputCount(); ++i) {
+        if (IsIndex(current->InputAt(i)->definition()) && !uses_index) {
+          return false;
+        }
+      }
+      continue;
+    }
+    if (VectorClassId(cid) == kIllegalCid || !IsInvariant(loop, array) ||
+        !IsIndex(index->definition())) {
+      return false;
+    }
+    const intptr_t element_size = ElementSize(cid);
+    if (element_size_ == 0) {
+      element_size_ = element_size;
+    } else if (element_size != element_size_) {
+      return false;
+    }
+    if (!arrays_.Contains(array)) {
+      arrays_.Add(array);
+      array_cids_.Add(cid);
+    }
+  }
+  // Loops without stores are left to dead code elimination.
+  return has_stores_;
+}
+
+bool LoopVectorizer::VectorizeInstruction(
+    Instruction* instr,
+    Definition* vector_index,
+    GrowableArray<Instruction*>* vector_instrs) {
+  Definition* vector = nullptr;
+  if (auto load = instr->AsLoadIndexed()) {
+    vector = new (zone_) LoadIndexedInstr(
+        new (zone_) Value(load->array()->definition()),
+        new (zone_) Value(vector_index), /*index_unboxed=*/true,
+        element_size_, VectorClassId(load->class_id()), kAlignedAccess,
+        DeoptId::kNone, load->source());
+    vector_instrs->Add(vector);
+  } else if (auto store = instr->AsStoreIndexed()) {
+    const classid_t cid = VectorClassId(store->class_id());
+    Definition* value = cid == kTypedDataFloat32x4ArrayCid
+                            ? FloatVector(store->value()->definition(),
+                                          /*exact=*/false)
+                            : IntVector(store->value()->definition());
+    if (value == nullptr) {
+      return false;
+    }
+    vector_instrs->Add(new (zone_) StoreIndexedInstr(
+        new (zone_) Value(store->array()->definition()),
+        new (zone_) Value(vector_index), new (zone_) Value(value),
+        kNoStoreBarrier, /*index_unboxed=*/true, element_size_, cid,
+        kAlignedAccess, DeoptId::kNone, store->source(),
+        Instruction::kNotSpeculative));
+    return true;
+  } else if (auto conv = instr->AsFloatToDouble()) {
+    vector = FloatVector(conv->value()->definition(), /*exact=*/false);
+  } else if (auto conv = instr->AsDoubleToFloat()) {
+    vector = FloatVector(conv->value()->definition(), /*exact=*/false);
+  } else if (auto conv = instr->AsIntConverter()) {
+    if (RepresentationUtils::IsUnboxedInteger(conv->from()) &&
+        RepresentationUtils::IsUnboxedInteger(conv->to())) {
+      vector = IntVector(conv->value()->definition());
+    }
+  } else if (auto unbox = instr->AsUnboxInteger()) {
+    vector = IntVector(unbox->value()->definition());
+  } else if (auto op = instr->AsBinaryIntegerOp()) {
+    // Lanes only hold the low bits of the result, which are all that is
+    // stored. Carries would cross the lanes of byte elements.
+    switch (op->op_kind()) {
+      case Token::kADD:
+      case Token::kSUB:
+        if (element_size_ != 4) {
+          return false;
+        }
+        FALL_THROUGH;
+      case Token::kBIT_AND:
+      case Token::kBIT_OR:
+      case Token::kBIT_XOR: {
+        Definition* left = IntVector(op->left()->definition());
+        Definition* right = IntVector(op->right()->definition());
+        if (left != nullptr && right != nullptr) {
+          vector = NewSimdOp(
+              SimdOpInstr::KindForOperator(kInt32x4Cid, op->op_kind()), left,
+              right);
+          vector_instrs->Add(vector);
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  } else if (auto op = instr->AsBinaryDoubleOp()) {
+    Definition* left = op->left()->definition();
+    Definition* right = op->right()->definition();
+    if (op->representation() == kUnboxedDouble &&
+        (!IsFloatOperand(left) || !IsFloatOperand(right) ||
+         !HasOnlyFloatUses(op))) {
+      return false;
+    }
+    switch (op->op_kind()) {
+      case Token::kADD:
+      case Token::kSUB:
+      case Token::kMUL:
+      case Token::kDIV:
+        left = FloatVector(left, /*exact=*/true);
+        right = FloatVector(right, /*exact=*/true);
+        if (left != nullptr && right != nullptr) {
+          vector = NewSimdOp(
+              SimdOpInstr::KindForOperator(kFloat32x4Cid, op->op_kind()), left,
+              right);
+          vector_instrs->Add(vector);
+        }
+        break;
+      default:
+        break;
+    }
+  } else if (auto op = instr->AsUnaryDoubleOp()) {
+    Definition* value = op->value()->definition();
+    if (op->op_kind() == Token::kSQUARE &&
+        (op->representation() != kUnboxedDouble ||
+         (IsFloatOperand(value) && HasOnlyFloatUses(op)))) {
+      value = FloatVector(value, /*exact=*/true);
+      if (value != nullptr) {
+        vector = NewSimdOp(SimdOpInstr::kFloat32x4Mul, value, value);
+        vector_instrs->Add(vector);
+      }
+    }
+  } else if (auto select = instr->AsIfThenElse()) {
+    ComparisonInstr* comparison = select->comparison();
+    Definition* left = comparison->left()->definition();
+    Definition* right = comparison->right()->definition();
+    SimdOpInstr::Kind kind = SimdOpInstr::kIllegalSimdOp;
+    bool swap = false;
+    if (comparison->operation_cid() != kDoubleCid ||
+        !FloatCompareKind(comparison->kind(), &kind, &swap) ||
+        !IsFloatOperand(left) || !IsFloatOperand(right)) {
+      return false;
+    }
+    left = FloatVector(left, /*exact=*/true);
+    right = FloatVector(right, /*exact=*/true);
+    if (left == nullptr || right == nullptr) {
+      return false;
+    }
+    if (swap) {
+      std::swap(left, right);
+    }
+    // Select the lanes of the result with the mask of the comparison:
+    // (mask & (if_true ^ if_false)) ^ if_false.
+    SimdOpInstr* mask = NewSimdOp(kind, left, right);
+    SimdOpInstr* masked =
+        NewSimdOp(SimdOpInstr::kInt32x4BitAnd, mask,
+                  IntSplat(select->if_true() ^ select->if_false()));
+    vector = NewSimdOp(SimdOpInstr::kInt32x4BitXor, masked,
+                       IntSplat(select->if_false()));
+    vector_instrs->Add(mask);
+    vector_instrs->Add(masked);
+    vector_instrs->Add(vector);
+  }
+  if (vector == nullptr) {
+    return false;
+  }
+  vectors_.Insert(DefinitionKV::Pair(instr->AsDefinition(), vector));
+  return true;
+}
+
+Definition* LoopVectorizer::FloatVector(Definition* def, bool exact) {
+  ConstantInstr* constant = def->AsConstant();
+  if (constant != nullptr) {
+    if (!constant->value().IsDouble() || (exact && !IsFloatConstant(def))) {
+      return nullptr;
+    }
+    const float value =
+        static_cast<float>(Double::Cast(constant->value()).value());
+    Float32x4& splat = Float32x4::Handle(
+        zone_, Float32x4::New(value, value, value, value, Heap::kOld));
+    splat ^= splat.Canonicalize(Thread::Current());
+    return flow_graph_->GetConstant(splat, kUnboxedFloat32x4);
+  }
+  Definition* vector = vectors_.LookupValue(def);
+  return (vector != nullptr && vector->representation() == kUnboxedFloat32x4)
+             ? vector
+             : nullptr;
+}
+
+Definition* LoopVectorizer::IntVector(Definition* def) {
+  int64_t value = 0;
+  if (IsInt64Constant(def, &value)) {
+    return IntSplat(value);
+  }
+  Definition* vector = vectors_.LookupValue(def);
+  return (vector != nullptr && vector->representation() == kUnboxedInt32x4)
+             ? vector
+             : nullptr;
+}
+
+Definition* LoopVectorizer::IntSplat(int64_t value) {
+  // Every element of a lane holds the low bits of the value.
+  uint32_t lane = static_cast<uint32_t>(value);
+  if (element_size_ == 1) {
+    lane = (lane & 0xff) * 0x01010101;
+  }
+  const int32_t element = static_cast<int32_t>(lane);
+  Int32x4& splat = Int32x4::Handle(
+      zone_, Int32x4::New(element, element, element, element, Heap::kOld));
+  splat ^= splat.Canonicalize(Thread::Current());
+  return flow_graph_->GetConstant(splat, kUnboxedInt32x4);
+}
+
+SimdOpInstr* LoopVectorizer::NewSimdOp(SimdOpInstr::Kind kind,
+                                       Definition* left,
+                                       Definition* right) {
+  return SimdOpInstr::Create(kind, new (zone_) Value(left),
+                             new (zone_) Value(right), DeoptId::kNone);
+}
+
+TargetEntryInstr* LoopVectorizer::AppendBranch(
+    BlockEntryInstr* block,
+    Instruction* cursor,
+    ComparisonInstr* compare,
+    GrowableArray<TargetEntryInstr*>* exits) {
+  BranchInstr* branch = new (zone_) BranchInstr(compare, DeoptId::kNone);
+  flow_graph_->AppendTo(cursor, branch, nullptr, FlowGraph::kEffect);
+  block->set_last_instruction(branch);
+  TargetEntryInstr* true_target = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), kInvalidTryIndex, DeoptId::kNone);
+  TargetEntryInstr* false_target = new (zone_) TargetEntryInstr(
+      flow_graph_->allocate_block_id(), kInvalidTryIndex, DeoptId::kNone);
+  *branch->true_successor_address() = true_target;
+  *branch->false_successor_address() = false_target;
+  exits->Add(false_target);
+  return true_target;
+}
+
+}  // namespace dart
@@ -0,0 +1,104 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+#define RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/compiler/backend/il.h"
+#include "vm/compiler/backend/loops.h"
+
+namespace dart {
+
+// Rewrites element-wise loops over typed data to process 16 bytes of
+// elements per iteration with SIMD operations.
+//
+// A loop qualifies if it consists of a header and a single body block, is
+// controlled by a unit stride induction i < n, and every access in the body
+// is a load or store of element i of a loop-invariant Float32List, Int32List,
+// Uint32List, Int8List or Uint8List with the same element size. The values
+// computed by the body have to map to lanes of a Float32x4 or Int32x4:
+//
+//   - float arithmetic and comparisons whose operands are floats, so
+//     computing them in single precision gives the same result,
+//   - integer additions, subtractions and bitwise operations whose results
+//     are only stored, so they are only needed modulo the element size
+//     (bitwise operations only for byte elements).
+//
+// The vector loop is inserted in front of the original loop and runs while
+// all elements of the next vector are within the bounds of the loop and of
+// the arrays. The original loop then processes the remaining elements, so
+// bounds checks and the order of exceptions are unchanged. If the loop
+// stores to one of several arrays, the vector loop only runs if all arrays
+// are internal typed data, which cannot overlap unless they are identical.
+//
+// Reductions are not vectorized: reassociating float sums changes their
+// result and integer sums need more than 32 bits.
+class LoopVectorizer : public ValueObject {
+ public:
+  explicit LoopVectorizer(FlowGraph* flow_graph);
+
+  // Returns true if the flow graph was changed.
+  bool Optimize();
+
+ private:
+  typedef RawPointerKeyValueTrait<Definition, Definition*> DefinitionKV;
+
+  bool Vectorize(LoopInfo* loop);
+
+  // Checks the element accesses in the body of the loop, collecting the
+  // arrays and the lengths the vector index has to be checked against.
+  bool CollectAccesses(LoopInfo* loop, BlockEntryInstr* body);
+
+  // Adds the vector instructions computing the given instruction of the loop
+  // body to [vector_instrs]. Returns false if it has no vector equivalent.
+  bool VectorizeInstruction(Instruction* instr,
+                            Definition* vector_index,
+                            GrowableArray<Instruction*>* vector_instrs);
+
+  // Returns true if def is the index of the loop, or a boxed or bounds
+  // checked version of it.
+  bool IsIndex(Definition* def) const;
+
+  // Returns the vector holding the lanes of the given value, or nullptr if
+  // there is none. Constants are splat into all lanes, float constants only
+  // if they are [exact] floats.
+  Definition* FloatVector(Definition* def, bool exact);
+  Definition* IntVector(Definition* def);
+  Definition* IntSplat(int64_t value);
+
+  SimdOpInstr* NewSimdOp(SimdOpInstr::Kind kind,
+                         Definition* left,
+                         Definition* right);
+
+  // Ends [block] after [cursor] with a branch on [compare]. Returns the true
+  // successor and adds the false successor to [exits].
+  TargetEntryInstr* AppendBranch(BlockEntryInstr* block,
+                                 Instruction* cursor,
+                                 ComparisonInstr* compare,
+                                 GrowableArray<TargetEntryInstr*>* exits);
+
+  FlowGraph* const flow_graph_;
+  Zone* const zone_;
+  DirectChainedHashMap<DefinitionKV> vectors_;
+
+  // The loop being vectorized.
+  PhiInstr* index_;
+  Definition* next_index_;
+  intptr_t element_size_;
+  bool has_stores_;
+  GrowableArray<Definition*> arrays_;
+  GrowableArray<classid_t> array_cids_;
+  GrowableArray<Definition*> limits_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopVectorizer);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_BACKEND_LOOP_VECTORIZER_H_
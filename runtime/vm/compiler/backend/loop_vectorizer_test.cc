@@ -0,0 +1,152 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/backend/loop_vectorizer.h"
+
+#include "vm/compiler/backend/flow_graph_compiler.h"
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/compiler/compiler_pass.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+#if defined(DART_PRECOMPILER) && defined(TARGET_ARCH_IS_64_BIT)
+
+// Counts the SIMD operations and vector accesses in the AOT compiled foo.
+static void CountVectorInstructions(Thread* thread,
+                                    const char* script_chars,
+                                    GrowableArray<SimdOpInstr::Kind>* ops,
+                                    intptr_t* num_accesses) {
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+
+  *num_accesses = 0;
+  for (auto block : flow_graph->reverse_postorder()) {
+    for (auto instr : block->instructions()) {
+      if (auto op = instr->AsSimdOp()) {
+        ops->Add(op->kind());
+      } else if (auto load = instr->AsLoadIndexed()) {
+        if (load->class_id() == kTypedDataFloat32x4ArrayCid ||
+            load->class_id() == kTypedDataInt32x4ArrayCid) {
+          (*num_accesses)++;
+        }
+      } else if (auto store = instr->AsStoreIndexed()) {
+        if (store->class_id() == kTypedDataFloat32x4ArrayCid ||
+            store->class_id() == kTypedDataInt32x4ArrayCid) {
+          (*num_accesses)++;
+        }
+      }
+    }
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorization_Float32Map) {
+  if (!FlowGraphCompiler::SupportsUnboxedSimd128()) return;
+  const char* script_chars =
+      R"(
+      import 'dart:typed_data';
+      @pragma('vm:never-inline')
+      void foo(Float32List a, Float32List b) {
+        for (int i = 0; i < a.length; i++) {
+          b[i] = a[i] * 2.0;
+        }
+      }
+      main() {
+        foo(Float32List(10), Float32List(10));
+      }
+    )";
+  GrowableArray<SimdOpInstr::Kind> ops;
+  intptr_t num_accesses;
+  CountVectorInstructions(thread, script_chars, &ops, &num_accesses);
+  EXPECT_EQ(1, ops.length());
+  EXPECT(ops.Contains(SimdOpInstr::kFloat32x4Mul));
+  EXPECT_EQ(2, num_accesses);
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorization_Float32Compare) {
+  if (!FlowGraphCompiler::SupportsUnboxedSimd128()) return;
+  const char* script_chars =
+      R"(
+      import 'dart:typed_data';
+      @pragma('vm:never-inline')
+      void foo(Float32List a, Float32List b, Int32List c) {
+        for (int i = 0; i < c.length; i++) {
+          c[i] = a[i] > b[i] ? 7 : -1;
+        }
+      }
+      main() {
+        foo(Float32List(10), Float32List(10), Int32List(10));
+      }
+    )";
+  GrowableArray<SimdOpInstr::Kind> ops;
+  intptr_t num_accesses;
+  CountVectorInstructions(thread, script_chars, &ops, &num_accesses);
+  EXPECT(ops.Contains(SimdOpInstr::kFloat32x4LessThan));
+  EXPECT(ops.Contains(SimdOpInstr::kInt32x4BitAnd));
+  EXPECT(ops.Contains(SimdOpInstr::kInt32x4BitXor));
+  EXPECT_EQ(3, num_accesses);
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorization_Bytes) {
+  if (!FlowGraphCompiler::SupportsUnboxedSimd128()) return;
+  const char* script_chars =
+      R"(
+      import 'dart:typed_data';
+      @pragma('vm:never-inline')
+      void foo(Uint8List a, Uint8List b) {
+        for (int i = 0; i < a.length; i++) {
+          b[i] = (a[i] ^ 0x55) | 1;
+        }
+      }
+      main() {
+        foo(Uint8List(10), Uint8List(10));
+      }
+    )";
+  GrowableArray<SimdOpInstr::Kind> ops;
+  intptr_t num_accesses;
+  CountVectorInstructions(thread, script_chars, &ops, &num_accesses);
+  EXPECT(ops.Contains(SimdOpInstr::kInt32x4BitXor));
+  EXPECT(ops.Contains(SimdOpInstr::kInt32x4BitOr));
+  EXPECT_EQ(2, num_accesses);
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopVectorization_NotVectorized) {
+  if (!FlowGraphCompiler::SupportsUnboxedSimd128()) return;
+  const char* script_chars =
+      R"(
+      import 'dart:typed_data';
+      @pragma('vm:never-inline')
+      void foo(Float32List a, Uint8List b, Int32List c) {
+        // Rounding the intermediate double would change the result.
+        for (int i = 0; i < a.length; i++) {
+          a[i] = a[i] * 3.0 + 1.0;
+        }
+        // Byte additions would carry into the next element.
+        for (int i = 0; i < b.length; i++) {
+          b[i] = b[i] + 1;
+        }
+        // Reductions are not vectorized.
+        int sum = 0;
+        for (int i = 0; i < c.length; i++) {
+          sum += c[i];
+        }
+        c[0] = sum;
+      }
+      main() {
+        foo(Float32List(10), Uint8List(10), Int32List(10));
+      }
+    )";
+  GrowableArray<SimdOpInstr::Kind> ops;
+  intptr_t num_accesses;
+  CountVectorInstructions(thread, script_chars, &ops, &num_accesses);
+  EXPECT_EQ(0, ops.length());
+  EXPECT_EQ(0, num_accesses);
+}
+
+#endif  // defined(DART_PRECOMPILER) && defined(TARGET_ARCH_IS_64_BIT)
+
+}  // namespace dart
@@ -5,10 +5,18 @@
 #include "vm/compiler/backend/loops.h"
 
 #include "vm/bit_vector.h"
+#include "vm/compiler/backend/flow_graph.h"
 #include "vm/compiler/backend/il.h"
+#include "vm/flags.h"
 
 namespace dart {
 
+DEFINE_FLAG(bool, loop_unrolling, true, "Unroll small counted loops.");
+DEFINE_FLAG(int,
+            loop_unrolling_max_size,
+            64,
+            "Maximum number of instructions in an unrolled loop body.");
+
 // Private class to perform induction variable analysis on a single loop
 // or a full loop hierarchy. The analysis implementation is based on the
 // paper by M. Gerlek et al. "Beyond Induction Variables: Detecting and
@@ -1208,4 +1216,346 @@ void LoopHierarchy::ComputeInduction() const {
   InductionVarAnalysis(preorder_).VisitHierarchy(top_);
 }
 
+// Largest factor by which a loop body is unrolled.
+static constexpr intptr_t kMaxUnrollFactor = 4;
+
+// Returns true if every update of the given header phi wraps around
+// on overflow, so that its value stays at a fixed offset from another
+// induction with the same stride.
+static bool HasWrappingUpdates(LoopInfo* loop, PhiInstr* phi) {
+  BlockEntryInstr* header = loop->header();
+  for (intptr_t i = 0, n = header->PredecessorCount(); i < n; ++i) {
+    if (loop->Contains(header->PredecessorAt(i)) &&
+        !phi->InputAt(i)->definition()->IsBinaryInt64Op()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Collects the instructions of the given loop block that have to be copied
+// for every unrolled iteration, which excludes the control flow and the
+// stack overflow checks. Returns false if one of them has an environment.
+static bool CollectIterationInstructions(BlockEntryInstr* block,
+                                         GrowableArray<Instruction*>* instrs) {
+  for (ForwardInstructionIterator it(block); !it.Done(); it.Advance()) {
+    Instruction* instr = it.Current();
+    if (instr->IsCheckStackOverflow() || instr->IsBranch() ||
+        instr->IsGoto()) {
+      continue;
+    }
+    if (instr->env() != nullptr) {
+      return false;
+    }
+    instrs->Add(instr);
+  }
+  return true;
+}
+
+// Returns true if the body of the given loop runs a constant number of
+// times whenever the loop is entered. Sets the trip count on success.
+static bool ComputeTripCount(LoopInfo* loop, uint64_t* trip_count) {
+  InductionVar* control = loop->control();
+  int64_t stride = 0;
+  int64_t begin = 0;
+  int64_t end = 0;
+  if (!InductionVar::IsLinear(control, &stride) ||
+      !InductionVar::IsConstant(control->initial(), &begin)) {
+    return false;
+  }
+  for (auto bound : control->bounds()) {
+    // Control bounds are strict bounds on a unit stride induction.
+    if (bound.branch_ == loop->header()->last_instruction() &&
+        InductionVar::IsConstant(bound.limit_, &end)) {
+      if (stride == 1 && begin < end) {
+        *trip_count =
+            static_cast<uint64_t>(end) - static_cast<uint64_t>(begin);
+        return true;
+      } else if (stride == -1 && begin > end) {
+        *trip_count =
+            static_cast<uint64_t>(begin) - static_cast<uint64_t>(end);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+LoopUnroller::LoopUnroller(FlowGraph* flow_graph)
+    : flow_graph_(flow_graph), zone_(flow_graph->zone()), copies_() {}
+
+bool LoopUnroller::Optimize() {
+  if (!FLAG_loop_unrolling || flow_graph_->IsCompiledForOsr()) {
+    return false;
+  }
+  const LoopHierarchy& loop_hierarchy = flow_graph_->GetLoopHierarchy();
+  const ZoneGrowableArray<BlockEntryInstr*>& loop_headers =
+      loop_hierarchy.headers();
+  loop_hierarchy.ComputeInduction();
+
+  bool changed = false;
+  for (intptr_t i = 0; i < loop_headers.length(); ++i) {
+    LoopInfo* loop = loop_headers[i]->loop_info();
+    if (loop->inner() != nullptr || !loop->header()->IsJoinEntry()) {
+      continue;
+    }
+    // Merging inductions keeps the control induction of the loop,
+    // so the trip count can still be computed afterwards.
+    changed = MergeInductions(loop) || changed;
+    changed = Unroll(loop) || changed;
+  }
+  if (changed) {
+    // The induction of the changed loops is stale now.
+    flow_graph_->ResetLoopHierarchy();
+  }
+  return changed;
+}
+
+bool LoopUnroller::MergeInductions(LoopInfo* loop) {
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+
+  // Collect the linear induction phis, with the control induction first
+  // so that it is never replaced.
+  GrowableArray<PhiInstr*> phis;
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    int64_t stride = 0;
+    if (loop->IsHeaderPhi(phi) && phi->representation() == kUnboxedInt64 &&
+        InductionVar::IsLinear(loop->LookupInduction(phi), &stride) &&
+        HasWrappingUpdates(loop, phi)) {
+      phis.Add(phi);
+      if (loop->LookupInduction(phi) == loop->control()) {
+        phis.Swap(0, phis.length() - 1);
+      }
+    }
+  }
+
+  bool changed = false;
+  for (intptr_t i = 1; i < phis.length(); ++i) {
+    PhiInstr* phi = phis[i];
+    InductionVar* induc = loop->LookupInduction(phi);
+    for (intptr_t j = 0; j < i; ++j) {
+      PhiInstr* other = phis[j];
+      int64_t diff = 0;
+      if (other == nullptr ||
+          !loop->LookupInduction(other)->CanComputeDifferenceWith(induc,
+                                                                  &diff)) {
+        continue;
+      }
+      // Replace phi by other + diff.
+      Definition* replacement = other;
+      if (diff != 0) {
+        ConstantInstr* offset = flow_graph_->GetConstant(
+            Integer::Handle(zone_, Integer::NewCanonical(diff)),
+            kUnboxedInt64);
+        replacement = new (zone_) BinaryInt64OpInstr(
+            Token::kADD, new (zone_) Value(other), new (zone_) Value(offset),
+            DeoptId::kNone, Instruction::kNotSpeculative);
+        if (phi->range() != nullptr) {
+          replacement->set_range(*phi->range());
+        }
+        flow_graph_->InsertAfter(header, replacement, nullptr,
+                                 FlowGraph::kValue);
+      }
+      if (FLAG_trace_optimization && flow_graph_->should_print()) {
+        THR_Print("Merged induction v%" Pd " into v%" Pd " in loop B%" Pd "\n",
+                  phi->ssa_temp_index(), other->ssa_temp_index(),
+                  header->block_id());
+      }
+      phi->ReplaceUsesWith(replacement);
+      phi->UnuseAllInputs();
+      header->RemovePhi(phi);
+      phis[i] = nullptr;
+      changed = true;
+      break;
+    }
+  }
+  return changed;
+}
+
+bool LoopUnroller::Unroll(LoopInfo* loop) {
+  JoinEntryInstr* header = loop->header()->AsJoinEntry();
+  if (loop->back_edges().length() != 1) {
+    return false;
+  }
+  BlockEntryInstr* body = loop->back_edges()[0];
+  if (body == header || body->PredecessorCount() != 1 ||
+      !body->last_instruction()->IsGoto()) {
+    return false;
+  }
+  intptr_t num_blocks = 0;
+  for (BitVector::Iterator it(loop->blocks()); !it.Done(); it.Advance()) {
+    num_blocks++;
+  }
+  if (num_blocks != 2) {
+    return false;
+  }
+  uint64_t trip_count = 0;
+  if (!ComputeTripCount(loop, &trip_count)) {
+    return false;
+  }
+  GrowableArray<Instruction*> instrs;
+  if (!CollectIterationInstructions(header, &instrs) ||
+      !CollectIterationInstructions(body, &instrs)) {
+    return false;
+  }
+  intptr_t factor = kMaxUnrollFactor;
+  while (factor > 1 &&
+         (trip_count < static_cast<uint64_t>(factor) ||
+          trip_count % factor != 0 ||
+          instrs.length() * factor > FLAG_loop_unrolling_max_size)) {
+    factor /= 2;
+  }
+  if (factor == 1) {
+    return false;
+  }
+
+  // The values of the header phis at the start of the next copy.
+  const intptr_t back_edge_index = header->IndexOfPredecessor(body);
+  GrowableArray<PhiInstr*> phis;
+  GrowableArray<Definition*> next;
+  for (PhiIterator it(header); !it.Done(); it.Advance()) {
+    PhiInstr* phi = it.Current();
+    phis.Add(phi);
+    next.Add(phi->InputAt(back_edge_index)->definition());
+  }
+
+  Instruction* last = body->last_instruction();
+  copies_.Clear();
+  for (intptr_t copy = 1; copy < factor; ++copy) {
+    for (intptr_t i = 0; i < phis.length(); ++i) {
+      copies_.Update(DefinitionKV::Pair(phis[i], next[i]));
+    }
+    // Copy the whole body before inserting anything, so a body with an
+    // unsupported instruction is left untouched.
+    GrowableArray<Instruction*> copied;
+    for (Instruction* instr : instrs) {
+      Instruction* result = CopyInstruction(instr);
+      if (result == nullptr) {
+        ASSERT(copy == 1);
+        return false;
+      }
+      if (Definition* def = instr->AsDefinition()) {
+        copies_.Update(DefinitionKV::Pair(def, result->AsDefinition()));
+      }
+      copied.Add(result);
+    }
+    for (intptr_t i = 0; i < instrs.length(); ++i) {
+      Definition* def = instrs[i]->AsDefinition();
+      flow_graph_->InsertBefore(
+          last, copied[i], nullptr,
+          (def != nullptr && def->HasSSATemp()) ? FlowGraph::kValue
+                                                : FlowGraph::kEffect);
+    }
+    for (intptr_t i = 0; i < phis.length(); ++i) {
+      next[i] = Lookup(phis[i]->InputAt(back_edge_index)->definition());
+    }
+  }
+  for (intptr_t i = 0; i < phis.length(); ++i) {
+    Value* input = phis[i]->InputAt(back_edge_index);
+    if (input->definition() != next[i]) {
+      input->BindTo(next[i]);
+    }
+  }
+  copies_.Clear();
+
+  if (FLAG_trace_optimization && flow_graph_->should_print()) {
+    THR_Print("Unrolled loop B%" Pd " %" Pd " times (trip count %" Pu64 ")\n",
+              header->block_id(), factor, trip_count);
+  }
+  return true;
+}
+
+Definition* LoopUnroller::Lookup(Definition* def) const {
+  Definition* copy = copies_.LookupValue(def);
+  return copy != nullptr ? copy : def;
+}
+
+Value* LoopUnroller::CopyInput(Instruction* instr, intptr_t index) {
+  return new (zone_) Value(Lookup(instr->InputAt(index)->definition()));
+}
+
+Instruction* LoopUnroller::CopyInstruction(Instruction* instr) {
+  Instruction* copy = nullptr;
+  if (auto op = instr->AsBinaryIntegerOp()) {
+    auto result = BinaryIntegerOpInstr::Make(
+        op->representation(), op->op_kind(), CopyInput(op, 0),
+        CopyInput(op, 1), DeoptId::kNone, op->can_overflow(),
+        op->is_truncating(), op->range(), op->SpeculativeModeOfInput(0));
+    if (result != nullptr && op->IsShiftIntegerOp()) {
+      result->AsShiftIntegerOp()->set_shift_range(
+          op->AsShiftIntegerOp()->shift_range());
+    }
+    copy = result;
+  } else if (auto op = instr->AsUnaryInt64Op()) {
+    copy = new (zone_)
+        UnaryInt64OpInstr(op->op_kind(), CopyInput(op, 0), DeoptId::kNone,
+                          op->SpeculativeModeOfInput(0));
+  } else if (auto op = instr->AsUnaryUint32Op()) {
+    copy = new (zone_)
+        UnaryUint32OpInstr(op->op_kind(), CopyInput(op, 0), DeoptId::kNone);
+  } else if (auto op = instr->AsBinaryDoubleOp()) {
+    copy = new (zone_) BinaryDoubleOpInstr(
+        op->op_kind(), CopyInput(op, 0), CopyInput(op, 1), DeoptId::kNone,
+        op->source(), op->SpeculativeModeOfInput(0), op->representation());
+  } else if (auto op = instr->AsIntConverter()) {
+    auto result = new (zone_) IntConverterInstr(
+        op->from(), op->to(), CopyInput(op, 0), DeoptId::kNone);
+    if (op->is_truncating()) {
+      result->mark_truncating();
+    }
+    copy = result;
+  } else if (auto op = instr->AsBox()) {
+    copy = BoxInstr::Create(op->from_representation(), CopyInput(op, 0));
+  } else if (auto op = instr->AsUnbox()) {
+    auto result =
+        UnboxInstr::Create(op->representation(), CopyInput(op, 0),
+                           DeoptId::kNone, op->SpeculativeModeOfInputs());
+    if (op->IsUnboxInteger() && op->AsUnboxInteger()->is_truncating()) {
+      result->AsUnboxInteger()->mark_truncating();
+    }
+    copy = result;
+  } else if (auto op = instr->AsGenericCheckBound()) {
+    copy = new (zone_) GenericCheckBoundInstr(
+        CopyInput(op, CheckBoundBaseInstr::kLengthPos),
+        CopyInput(op, CheckBoundBaseInstr::kIndexPos), DeoptId::kNone);
+  } else if (auto op = instr->AsLoadIndexed()) {
+    // Only element loads from typed data, which need no result type.
+    if (op->representation() != kTagged) {
+      copy = new (zone_) LoadIndexedInstr(
+          CopyInput(op, LoadIndexedInstr::kArrayPos),
+          CopyInput(op, LoadIndexedInstr::kIndexPos), op->index_unboxed(),
+          op->index_scale(), op->class_id(),
+          op->aligned() ? kAlignedAccess : kUnalignedAccess, DeoptId::kNone,
+          op->source());
+    }
+  } else if (auto op = instr->AsStoreIndexed()) {
+    // Only element stores without a write barrier.
+    if (!op->ShouldEmitStoreBarrier()) {
+      copy = new (zone_) StoreIndexedInstr(
+          CopyInput(op, StoreIndexedInstr::kArrayPos),
+          CopyInput(op, StoreIndexedInstr::kIndexPos),
+          CopyInput(op, StoreIndexedInstr::kValuePos), kNoStoreBarrier,
+          op->index_unboxed(), op->index_scale(), op->class_id(),
+          op->aligned() ? kAlignedAccess : kUnalignedAccess, DeoptId::kNone,
+          op->source(),
+          op->SpeculativeModeOfInput(StoreIndexedInstr::kValuePos));
+    }
+  }
+  if (copy == nullptr) {
+    return nullptr;
+  }
+  copy->CopyDeoptIdFrom(*instr);
+  if (instr->has_inlining_id() && !copy->has_inlining_id()) {
+    copy->set_inlining_id(instr->inlining_id());
+  }
+  // Every copy computes a value of the original for a later iteration, so
+  // the range computed for the original holds for the copy as well.
+  Definition* def = instr->AsDefinition();
+  if (def != nullptr && def->range() != nullptr) {
+    copy->AsDefinition()->set_range(*def->range());
+  }
+  return copy;
+}
+
 }  // namespace dart
@@ -349,6 +349,47 @@ class LoopHierarchy : public ZoneAllocated {
   DISALLOW_COPY_AND_ASSIGN(LoopHierarchy);
 };
 
+// Optimizes innermost loops using the induction variable analysis.
+//
+// Header phis that are linear inductions with the same stride as another
+// header phi are rewritten as a fixed offset from that phi, so that only
+// one induction is updated on every iteration.
+//
+// Loops that consist of a header and a single body block and that have a
+// constant trip count are unrolled by a factor that divides the trip count.
+// The copies of the iteration are appended to the body block without exit
+// tests in between, so the exit test and the stack overflow check in the
+// header only run once per unrolled iteration. Only instructions without
+// environments that can be copied safely are supported, see
+// LoopUnroller::CopyInstruction.
+class LoopUnroller : public ValueObject {
+ public:
+  explicit LoopUnroller(FlowGraph* flow_graph);
+
+  // Returns true if the flow graph was changed.
+  bool Optimize();
+
+ private:
+  typedef RawPointerKeyValueTrait<Definition, Definition*> DefinitionKV;
+
+  bool MergeInductions(LoopInfo* loop);
+  bool Unroll(LoopInfo* loop);
+
+  // Returns a copy of the given instruction that reads the copies of its
+  // inputs, or nullptr if the instruction cannot be copied.
+  Instruction* CopyInstruction(Instruction* instr);
+  Value* CopyInput(Instruction* instr, intptr_t index);
+
+  // Returns the definition that replaces def in the current copy.
+  Definition* Lookup(Definition* def) const;
+
+  FlowGraph* const flow_graph_;
+  Zone* const zone_;
+  DirectChainedHashMap<DefinitionKV> copies_;
+
+  DISALLOW_COPY_AND_ASSIGN(LoopUnroller);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_COMPILER_BACKEND_LOOPS_H_
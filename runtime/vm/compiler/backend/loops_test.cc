@@ -509,4 +509,104 @@ ISOLATE_UNIT_TEST_CASE(SecondExitDown) {
   EXPECT_STREQ(expected, ComputeInduction(thread, script_chars));
 }
 
+//
+// Loop unrolling tests.
+//
+
+#if defined(DART_PRECOMPILER) && defined(TARGET_ARCH_IS_64_BIT)
+
+// Helper method to run the AOT pipeline on "foo" and count the integer
+// multiplications and the phis in the resulting graph.
+static void CountUnrolled(Thread* thread,
+                          const char* script_chars,
+                          intptr_t* num_muls,
+                          intptr_t* num_phis) {
+  const auto& root_library = Library::Handle(LoadTestScript(script_chars));
+  const auto& function = Function::Handle(GetFunction(root_library, "foo"));
+  TestPipeline pipeline(function, CompilerPass::kAOT);
+  FlowGraph* flow_graph = pipeline.RunPasses({});
+
+  *num_muls = 0;
+  *num_phis = 0;
+  for (auto block : flow_graph->reverse_postorder()) {
+    if (auto join = block->AsJoinEntry()) {
+      for (PhiIterator it(join); !it.Done(); it.Advance()) {
+        (*num_phis)++;
+      }
+    }
+    for (auto instr : block->instructions()) {
+      if (auto op = instr->AsBinaryIntegerOp()) {
+        if (op->op_kind() == Token::kMUL) (*num_muls)++;
+      }
+    }
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopUnrolling_ConstantTripCount) {
+  const char* script_chars =
+      R"(
+      @pragma('vm:never-inline')
+      int foo(int x) {
+        int h = 0;
+        for (int i = 0; i < 16; i++) {
+          h = h * x + i;
+        }
+        return h;
+      }
+      main() {
+        foo(31);
+      }
+    )";
+  intptr_t num_muls, num_phis;
+  CountUnrolled(thread, script_chars, &num_muls, &num_phis);
+  EXPECT_EQ(4, num_muls);  // unrolled 4 times
+  EXPECT_EQ(2, num_phis);
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopUnrolling_OddTripCount) {
+  const char* script_chars =
+      R"(
+      @pragma('vm:never-inline')
+      int foo(int x) {
+        int h = 0;
+        for (int i = 0; i < 15; i++) {
+          h = h * x + i;
+        }
+        return h;
+      }
+      main() {
+        foo(31);
+      }
+    )";
+  intptr_t num_muls, num_phis;
+  CountUnrolled(thread, script_chars, &num_muls, &num_phis);
+  EXPECT_EQ(1, num_muls);  // not unrolled
+  EXPECT_EQ(2, num_phis);
+}
+
+ISOLATE_UNIT_TEST_CASE(LoopUnrolling_MergeInductions) {
+  const char* script_chars =
+      R"(
+      @pragma('vm:never-inline')
+      int foo(int x) {
+        int h = 0;
+        int j = 10;
+        for (int i = 0; i < x; i++) {
+          h = h * x + j;
+          j++;
+        }
+        return h;
+      }
+      main() {
+        foo(31);
+      }
+    )";
+  intptr_t num_muls, num_phis;
+  CountUnrolled(thread, script_chars, &num_muls, &num_phis);
+  EXPECT_EQ(1, num_muls);
+  EXPECT_EQ(2, num_phis);  // j is derived from i
+}
+
+#endif  // defined(DART_PRECOMPILER) && defined(TARGET_ARCH_IS_64_BIT)
+
 }  // namespace dart
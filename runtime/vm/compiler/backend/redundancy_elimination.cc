@@ -27,6 +27,15 @@ DEFINE_FLAG(bool,
             trace_load_optimization,
             false,
             "Print live sets for load optimization pass.");
+DEFINE_FLAG(bool,
+            partial_escape_analysis,
+            true,
+            "Eliminate allocations flowing into phis or escaping only on "
+            "some paths.");
+DEFINE_FLAG(bool,
+            trace_allocation_sinking,
+            false,
+            "Print the number of allocations eliminated in each function.");
 
 // Quick access to the current zone.
 #define Z (zone())
@@ -3718,6 +3727,11 @@ void AllocationSinking::Optimize() {
     return;
   }
 
+  if (FLAG_partial_escape_analysis) {
+    SplitAllocationPhis();
+    SinkPartiallyEscapingAllocations();
+  }
+
   CollectCandidates();
 
   // Insert MaterializeObject instructions that will describe the state of the
@@ -3785,6 +3799,15 @@ void AllocationSinking::Optimize() {
       }
     }
   }
+
+  if (FLAG_trace_allocation_sinking && flow_graph_->should_print() &&
+      !candidates_.is_empty()) {
+    THR_Print("Eliminated %" Pd " allocations in %s (%" Pd
+              " phis split, %" Pd " allocations sunk into escaping paths)\n",
+              candidates_.length(),
+              flow_graph_->function().ToFullyQualifiedCString(),
+              num_split_phis_, num_sunk_allocations_);
+  }
 }
 
 // Remove materializations from the graph. Register allocator will treat them
@@ -4080,6 +4103,423 @@ void AllocationSinking::InsertMaterializations(Definition* alloc) {
   }
 }
 
+template <typename T>
+static intptr_t IndexOf(const GrowableArray<T*>& list, T* value) {
+  for (intptr_t i = 0; i < list.length(); i++) {
+    if (list[i] == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// Returns true if the given use is a store into [alloc] in the block of
+// [alloc]. If these are the only stores into an allocation which does not
+// escape, its fields do not change once control leaves its block.
+static bool IsStoreInAllocationBlock(Value* use, Definition* alloc) {
+  auto* const store = use->instruction()->AsStoreField();
+  return (store != nullptr) && (use == store->instance()) &&
+         (store->GetBlock() == alloc->GetBlock());
+}
+
+// Returns the value of the given field of [alloc] at the end of the block
+// of [alloc], or nullptr if the field is not initialized explicitly.
+static Definition* FieldValueAtBlockEnd(Definition* alloc, const Slot& slot) {
+  Definition* value = nullptr;
+  auto* const allocation = alloc->AsAllocation();
+  for (intptr_t pos = 0; pos < allocation->InputCount(); pos++) {
+    if (allocation->SlotForInput(pos) == &slot) {
+      value = allocation->InputAt(pos)->definition();
+    }
+  }
+  for (Instruction* instr = alloc->next(); instr != nullptr;
+       instr = instr->next()) {
+    if (auto* const store = instr->AsStoreField()) {
+      if ((store->instance()->definition() == alloc) &&
+          (&store->slot() == &slot)) {
+        value = store->value()->definition();
+      }
+    }
+  }
+  return value;
+}
+
+bool AllocationSinking::CollectAllocationPhis(
+    PhiInstr* phi,
+    GrowableArray<PhiInstr*>* phis,
+    GrowableArray<Definition*>* allocs,
+    GrowableArray<LoadFieldInstr*>* loads) {
+  GrowableArray<Definition*> worklist(4);
+  worklist.Add(phi);
+
+  // Note: worklist grows while we are iterating over it.
+  for (intptr_t i = 0; i < worklist.length(); i++) {
+    Definition* defn = worklist[i];
+    if (PhiInstr* current = defn->AsPhi()) {
+      // There is no allocation to materialize the phi from.
+      if (current->env_use_list() != nullptr) {
+        return false;
+      }
+      for (intptr_t j = 0; j < current->InputCount(); j++) {
+        Definition* input = current->InputAt(j)->definition();
+        if (!input->IsPhi() &&
+            (!IsSupportedAllocation(input) || input->IsArrayAllocation())) {
+          return false;
+        }
+        AddInstruction(&worklist, input);
+      }
+      phis->Add(current);
+    } else {
+      allocs->Add(defn);
+    }
+
+    for (Value* use = defn->input_use_list(); use != nullptr;
+         use = use->next_use()) {
+      Instruction* instr = use->instruction();
+      if (instr->IsPhi()) {
+        AddInstruction(&worklist, instr->Cast<Definition>());
+      } else if (defn->IsPhi()) {
+        LoadFieldInstr* load = instr->AsLoadField();
+        if ((load == nullptr) || load->calls_initializer()) {
+          return false;
+        }
+        loads->Add(load);
+      } else if (!IsStoreInAllocationBlock(use, defn)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// Replaces every load from the given phis with a phi of the loaded field.
+// The allocations flowing into the phis do not escape and their fields are
+// only written in their own blocks, so the value of a field flowing into a
+// phi is the value it has at the end of the block of the allocation.
+//
+//     B1: v1 <- AllocateObject(A)            B1: ...
+//         StoreField(v1 . x = v2)                goto B3
+//         goto B3
+//     B2: v3 <- AllocateObject(A)     =>     B2: ...
+//         StoreField(v3 . x = v4)                goto B3
+//         goto B3
+//     B3: v5 <- phi(v1, v3)                  B3: v7 <- phi(v2, v4)
+//         v6 <- LoadField(v5 . x)                ... uses of v7 ...
+//
+// Afterwards the allocations only have stores into them and are eliminated
+// as usual.
+bool AllocationSinking::SplitPhis(const GrowableArray<PhiInstr*>& phis,
+                                  const GrowableArray<Definition*>& allocs,
+                                  const GrowableArray<LoadFieldInstr*>& loads) {
+  // Every allocation has to initialize each loaded field with a value of
+  // the representation of the load.
+  GrowableArray<const Slot*> slots(4);
+  GrowableArray<Representation> representations(4);
+  for (auto* load : loads) {
+    const Slot* slot = &load->slot();
+    const intptr_t index = IndexOf(slots, slot);
+    if (index >= 0) {
+      if (representations[index] != load->representation()) {
+        return false;
+      }
+      continue;
+    }
+    for (auto* alloc : allocs) {
+      Definition* value = FieldValueAtBlockEnd(alloc, *slot);
+      if ((value == nullptr) ||
+          (value->representation() != load->representation())) {
+        return false;
+      }
+    }
+    slots.Add(slot);
+    representations.Add(load->representation());
+  }
+
+  // Field phis are stored by slot and then by the phi they replace.
+  const intptr_t num_phis = phis.length();
+  GrowableArray<PhiInstr*> field_phis(slots.length() * num_phis);
+  for (intptr_t i = 0; i < slots.length(); i++) {
+    for (auto* phi : phis) {
+      auto* field_phi = new (Z) PhiInstr(phi->block(), phi->InputCount());
+      field_phi->set_representation(representations[i]);
+      flow_graph_->AllocateSSAIndex(field_phi);
+      field_phis.Add(field_phi);
+    }
+  }
+
+  for (intptr_t i = 0; i < slots.length(); i++) {
+    for (intptr_t j = 0; j < num_phis; j++) {
+      PhiInstr* phi = phis[j];
+      PhiInstr* field_phi = field_phis[i * num_phis + j];
+      for (intptr_t k = 0; k < phi->InputCount(); k++) {
+        Definition* input = phi->InputAt(k)->definition();
+        Definition* value =
+            input->IsPhi()
+                ? field_phis[i * num_phis + IndexOf(phis, input->AsPhi())]
+                : FieldValueAtBlockEnd(input, *slots[i]);
+        Value* use = new (Z) Value(value);
+        field_phi->SetInputAt(k, use);
+        value->AddInputUse(use);
+      }
+      field_phi->mark_alive();
+      phi->block()->InsertPhi(field_phi);
+    }
+  }
+
+  for (auto* load : loads) {
+    PhiInstr* phi = load->instance()->definition()->AsPhi();
+    PhiInstr* field_phi =
+        field_phis[IndexOf(slots, &load->slot()) * num_phis +
+                   IndexOf(phis, phi)];
+    if (FLAG_trace_optimization && flow_graph_->should_print()) {
+      THR_Print("Replacing load v%" Pd " with phi v%" Pd "\n",
+                load->ssa_temp_index(), field_phi->ssa_temp_index());
+    }
+    load->ReplaceUsesWith(field_phi);
+    load->RemoveFromGraph();
+  }
+
+  // The remaining uses of the phis are the phis themselves.
+  for (auto* phi : phis) {
+    phi->UnuseAllInputs();
+  }
+  for (auto* phi : phis) {
+    ASSERT(phi->input_use_list() == nullptr);
+    phi->mark_dead();
+    phi->block()->RemovePhi(phi);
+  }
+  return true;
+}
+
+void AllocationSinking::SplitAllocationPhis() {
+  GrowableArray<PhiInstr*> roots(4);
+  for (BlockIterator block_it = flow_graph_->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    JoinEntryInstr* join = block_it.Current()->AsJoinEntry();
+    if (join == nullptr) continue;
+    for (PhiIterator it(join); !it.Done(); it.Advance()) {
+      PhiInstr* phi = it.Current();
+      for (intptr_t i = 0; i < phi->InputCount(); i++) {
+        if (IsSupportedAllocation(phi->InputAt(i)->definition())) {
+          roots.Add(phi);
+          break;
+        }
+      }
+    }
+  }
+
+  GrowableArray<PhiInstr*> phis(4);
+  GrowableArray<Definition*> allocs(4);
+  GrowableArray<LoadFieldInstr*> loads(4);
+  for (auto* root : roots) {
+    // Skip phis removed together with an earlier root.
+    if (!root->is_alive()) continue;
+
+    phis.Clear();
+    allocs.Clear();
+    loads.Clear();
+    if (CollectAllocationPhis(root, &phis, &allocs, &loads) &&
+        SplitPhis(phis, allocs, loads)) {
+      if (FLAG_trace_optimization && flow_graph_->should_print()) {
+        THR_Print("splitting phi v%" Pd " merging %" Pd " allocations\n",
+                  root->ssa_temp_index(), allocs.length());
+      }
+      num_split_phis_ += phis.length();
+    }
+  }
+}
+
+// Moves an allocation which escapes only on some paths into these paths.
+// The allocation is copied, together with the stores initializing it, in
+// front of each escaping instruction that is not dominated by another one,
+// and the uses dominated by that instruction are redirected to the copy:
+//
+//     v1 <- AllocateObject(A)                ...
+//     StoreField(v1 . x = v2)                Branch if v3 goto (B1, B2)
+//     Branch if v3 goto (B1, B2)      =>   B1:
+//   B1:                                      v4 <- AllocateObject(A)
+//     StaticCall(use, v1)                    StoreField(v4 . x = v2)
+//                                            StaticCall(use, v4)
+//
+// The original allocation is then only stored into and is eliminated.
+//
+// Each copy can be made at most once per execution of the allocation and no
+// path from a copy may reach a use of the original allocation, so all uses
+// observe the same object on every path.
+bool AllocationSinking::SinkIntoEscapingPaths(AllocateObjectInstr* alloc) {
+  BlockEntryInstr* const block = alloc->GetBlock();
+
+  // Collect instructions the allocation escapes at.
+  GrowableArray<Instruction*> escapes(2);
+  for (Value* use = alloc->input_use_list(); use != nullptr;
+       use = use->next_use()) {
+    Instruction* instr = use->instruction();
+    if (IsStoreInAllocationBlock(use, alloc)) continue;
+    if ((instr->GetBlock() == block) || instr->IsPhi() ||
+        instr->IsLoadField() || instr->IsLoadIndexed()) {
+      return false;
+    }
+    auto* const store = instr->AsStoreField();
+    if ((store != nullptr) && (use == store->instance())) {
+      return false;
+    }
+    AddInstruction(&escapes, instr);
+  }
+  if (escapes.is_empty()) {
+    return false;
+  }
+
+  GrowableArray<Instruction*> roots(2);
+  for (auto* escape : escapes) {
+    bool is_dominated = false;
+    for (auto* other : escapes) {
+      if ((other != escape) && escape->IsDominatedBy(other)) {
+        is_dominated = true;
+        break;
+      }
+    }
+    if (!is_dominated) {
+      roots.Add(escape);
+    }
+  }
+
+  // Instructions which use the allocation or mention it in the environment.
+  GrowableArray<Instruction*> users(4);
+  for (Value* use = alloc->input_use_list(); use != nullptr;
+       use = use->next_use()) {
+    AddInstruction(&users, use->instruction());
+  }
+  for (Value* use = alloc->env_use_list(); use != nullptr;
+       use = use->next_use()) {
+    AddInstruction(&users, use->instruction());
+  }
+
+  BitVector* reachable =
+      new (Z) BitVector(Z, flow_graph_->preorder().length());
+  GrowableArray<BlockEntryInstr*> worklist(8);
+  for (auto* root : roots) {
+    BlockEntryInstr* const root_block = root->GetBlock();
+    if (root_block->InsideTryBlock()) {
+      return false;
+    }
+
+    // A copy in a loop which does not contain the allocation would be made
+    // on every iteration.
+    LoopInfo* loop = root_block->loop_info();
+    if ((loop != nullptr) && !loop->Contains(block)) {
+      return false;
+    }
+
+    // Collect blocks reachable from the copy without executing the
+    // allocation again.
+    reachable->Clear();
+    worklist.Clear();
+    worklist.Add(root_block);
+    while (!worklist.is_empty()) {
+      Instruction* last = worklist.RemoveLast()->last_instruction();
+      for (intptr_t i = 0; i < last->SuccessorCount(); i++) {
+        BlockEntryInstr* succ = last->SuccessorAt(i);
+        if ((succ != block) && !reachable->Contains(succ->preorder_number())) {
+          reachable->Add(succ->preorder_number());
+          worklist.Add(succ);
+        }
+      }
+    }
+
+    for (auto* user : users) {
+      if ((user != root) && !user->IsDominatedBy(root) &&
+          reachable->Contains(user->GetBlock()->preorder_number())) {
+        return false;
+      }
+    }
+  }
+
+  // Stores into the allocation in program order, without overwritten ones.
+  GrowableArray<StoreFieldInstr*> stores(4);
+  for (Instruction* instr = alloc->next(); instr != nullptr;
+       instr = instr->next()) {
+    auto* const store = instr->AsStoreField();
+    if ((store != nullptr) && (store->instance()->definition() == alloc)) {
+      for (intptr_t i = 0; i < stores.length(); i++) {
+        if (&stores[i]->slot() == &store->slot()) {
+          stores.EraseAt(i);
+          break;
+        }
+      }
+      stores.Add(store);
+    }
+  }
+
+  for (auto* root : roots) {
+    auto* const copy = new (Z) AllocateObjectInstr(
+        alloc->source(), alloc->cls(), DeoptId::kNone,
+        alloc->type_arguments() != nullptr
+            ? new (Z) Value(alloc->type_arguments()->definition())
+            : nullptr);
+    flow_graph_->InsertBefore(root, copy, nullptr, FlowGraph::kValue);
+    for (auto* store : stores) {
+      auto* const copy_store = new (Z) StoreFieldInstr(
+          store->slot(), new (Z) Value(copy),
+          new (Z) Value(store->value()->definition()),
+          store->ShouldEmitStoreBarrier() ? kEmitStoreBarrier
+                                          : kNoStoreBarrier,
+          store->stores_inner_pointer(), store->source(),
+          StoreFieldInstr::Kind::kInitializing, store->memory_order());
+      flow_graph_->InsertBefore(root, copy_store, nullptr, FlowGraph::kEffect);
+    }
+
+    Value* next_use;
+    for (Value* use = alloc->input_use_list(); use != nullptr;
+         use = next_use) {
+      next_use = use->next_use();
+      Instruction* instr = use->instruction();
+      if ((instr == root) || instr->IsDominatedBy(root)) {
+        use->BindTo(copy);
+      }
+    }
+    for (auto* user : users) {
+      if ((user->env() != nullptr) &&
+          ((user == root) || user->IsDominatedBy(root))) {
+        user->ReplaceInEnvironment(alloc, copy);
+      }
+    }
+
+    if (FLAG_trace_optimization && flow_graph_->should_print()) {
+      THR_Print("sinking allocation v%" Pd " into B%" Pd " as v%" Pd "\n",
+                alloc->ssa_temp_index(), root->GetBlock()->block_id(),
+                copy->ssa_temp_index());
+    }
+  }
+  return true;
+}
+
+void AllocationSinking::SinkPartiallyEscapingAllocations() {
+  // Copies inserted on escaping paths would need deoptimization environments
+  // in JIT mode.
+  if (!CompilerState::Current().is_aot()) {
+    return;
+  }
+
+  flow_graph_->GetLoopHierarchy();
+
+  GrowableArray<AllocateObjectInstr*> allocs(4);
+  for (BlockIterator block_it = flow_graph_->reverse_postorder_iterator();
+       !block_it.Done(); block_it.Advance()) {
+    for (ForwardInstructionIterator it(block_it.Current()); !it.Done();
+         it.Advance()) {
+      if (auto* const alloc = it.Current()->AsAllocateObject()) {
+        allocs.Add(alloc);
+      }
+    }
+  }
+
+  for (auto* alloc : allocs) {
+    if (SinkIntoEscapingPaths(alloc)) {
+      num_sunk_allocations_++;
+    }
+  }
+}
+
 // TryCatchAnalyzer tries to reduce the state that needs to be synchronized
 // on entry to the catch by discovering Parameter-s which are never used
 // or which are always constant.
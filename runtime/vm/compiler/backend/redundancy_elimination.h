@@ -25,6 +25,13 @@ class AllocationSinking : public ZoneAllocated {
 
   const GrowableArray<Definition*>& candidates() const { return candidates_; }
 
+  // Number of phis merging allocations which were replaced by phis of
+  // their fields.
+  intptr_t num_split_phis() const { return num_split_phis_; }
+
+  // Number of allocations which were moved into the paths they escape on.
+  intptr_t num_sunk_allocations() const { return num_sunk_allocations_; }
+
   // Find the materialization inserted for the given allocation
   // at the given exit.
   MaterializeObjectInstr* MaterializationFor(Definition* alloc,
@@ -58,6 +65,28 @@ class AllocationSinking : public ZoneAllocated {
     GrowableArray<Definition*> worklist_;
   };
 
+  // Replace loads from phis merging allocations that do not escape
+  // otherwise with phis of the loaded fields, so the allocations can be
+  // eliminated.
+  void SplitAllocationPhis();
+
+  // Collect the phis and allocations connected to [phi] and the loads
+  // from these phis. Returns false if any of them is used in another way.
+  bool CollectAllocationPhis(PhiInstr* phi,
+                             GrowableArray<PhiInstr*>* phis,
+                             GrowableArray<Definition*>* allocs,
+                             GrowableArray<LoadFieldInstr*>* loads);
+
+  bool SplitPhis(const GrowableArray<PhiInstr*>& phis,
+                 const GrowableArray<Definition*>& allocs,
+                 const GrowableArray<LoadFieldInstr*>& loads);
+
+  // Move allocations which only escape on some paths to these paths,
+  // so they can be eliminated from the others.
+  void SinkPartiallyEscapingAllocations();
+
+  bool SinkIntoEscapingPaths(AllocateObjectInstr* alloc);
+
   void CollectCandidates();
 
   void NormalizeMaterializations();
@@ -87,6 +116,9 @@ class AllocationSinking : public ZoneAllocated {
   GrowableArray<Definition*> candidates_;
   GrowableArray<MaterializeObjectInstr*> materializations_;
 
+  intptr_t num_split_phis_ = 0;
+  intptr_t num_sunk_allocations_ = 0;
+
   ExitsCollector exits_collector_;
 };
 
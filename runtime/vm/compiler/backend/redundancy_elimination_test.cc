@@ -1565,6 +1565,131 @@ ISOLATE_UNIT_TEST_CASE(DelayAllocations_DontDelayIntoLoop) {
   EXPECT(call->Receiver()->definition() == allocate);
 }
 
+static void CollectAllocationsAndCalls(
+    FlowGraph* flow_graph,
+    GrowableArray<AllocateObjectInstr*>* allocs,
+    GrowableArray<StaticCallInstr*>* calls) {
+  for (auto block : flow_graph->reverse_postorder()) {
+    for (auto instr : block->instructions()) {
+      if (auto alloc = instr->AsAllocateObject()) {
+        allocs->Add(alloc);
+      } else if (auto call = instr->AsStaticCall()) {
+        if (strcmp(call->function().UserVisibleNameCString(), "use") == 0) {
+          calls->Add(call);
+        }
+      }
+    }
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(AllocationSinking_Phis) {
+  const char* kScript = R"(
+    class Point {
+      final int x;
+      final int y;
+      Point(this.x, this.y);
+    }
+
+    @pragma('vm:never-inline')
+    int testIf(bool c, int a, int b) {
+      final p = c ? Point(a, b) : Point(b, a);
+      return p.x - p.y;
+    }
+
+    @pragma('vm:never-inline')
+    int testLoop(int n) {
+      var p = Point(0, 1);
+      for (int i = 0; i < n; i++) {
+        p = Point(p.y, p.x + p.y);
+      }
+      return p.x;
+    }
+
+    main() {
+      testIf(true, 1, 2);
+      testLoop(10);
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  for (const char* name : {"testIf", "testLoop"}) {
+    const auto& function = Function::Handle(GetFunction(root_library, name));
+    TestPipeline pipeline(function, CompilerPass::kAOT);
+    FlowGraph* flow_graph = pipeline.RunPasses({});
+
+    GrowableArray<AllocateObjectInstr*> allocs;
+    GrowableArray<StaticCallInstr*> calls;
+    CollectAllocationsAndCalls(flow_graph, &allocs, &calls);
+    EXPECT_EQ(0, allocs.length());
+  }
+}
+
+ISOLATE_UNIT_TEST_CASE(AllocationSinking_PartiallyEscaping) {
+  const char* kScript = R"(
+    class Point {
+      final int x;
+      final int y;
+      Point(this.x, this.y);
+    }
+
+    @pragma('vm:never-inline')
+    void use(Object o) {}
+
+    @pragma('vm:never-inline')
+    int testSunk(bool c, int a, int b) {
+      final p = Point(a, b);
+      if (c) use(p);
+      return p.x + p.y;
+    }
+
+    @pragma('vm:never-inline')
+    int testNotSunk(bool c, int a) {
+      final p = Point(a, a);
+      if (c) use(p);
+      use(p);
+      return p.x;
+    }
+
+    main() {
+      testSunk(true, 1, 2);
+      testNotSunk(true, 1);
+    }
+  )";
+
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  {
+    const auto& function =
+        Function::Handle(GetFunction(root_library, "testSunk"));
+    TestPipeline pipeline(function, CompilerPass::kAOT);
+    FlowGraph* flow_graph = pipeline.RunPasses({});
+
+    GrowableArray<AllocateObjectInstr*> allocs;
+    GrowableArray<StaticCallInstr*> calls;
+    CollectAllocationsAndCalls(flow_graph, &allocs, &calls);
+    // The allocation is only made on the path where it escapes.
+    EXPECT_EQ(1, allocs.length());
+    EXPECT_EQ(1, calls.length());
+    EXPECT(allocs[0]->GetBlock() == calls[0]->GetBlock());
+    EXPECT(allocs[0]->GetBlock() != flow_graph->graph_entry()->normal_entry());
+    EXPECT(calls[0]->ArgumentAt(0) == allocs[0]);
+  }
+  {
+    const auto& function =
+        Function::Handle(GetFunction(root_library, "testNotSunk"));
+    TestPipeline pipeline(function, CompilerPass::kAOT);
+    FlowGraph* flow_graph = pipeline.RunPasses({});
+
+    GrowableArray<AllocateObjectInstr*> allocs;
+    GrowableArray<StaticCallInstr*> calls;
+    CollectAllocationsAndCalls(flow_graph, &allocs, &calls);
+    // Both calls must observe the same object.
+    EXPECT_EQ(1, allocs.length());
+    EXPECT_EQ(2, calls.length());
+    EXPECT(calls[0]->ArgumentAt(0) == allocs[0]);
+    EXPECT(calls[1]->ArgumentAt(0) == allocs[0]);
+  }
+}
+
 ISOLATE_UNIT_TEST_CASE(CheckStackOverflowElimination_NoInterruptsPragma) {
   const char* kScript = R"(
     @pragma('vm:prefer-inline')
@@ -1210,17 +1210,26 @@ CompileType ParameterInstr::ComputeType() const {
       UNREACHABLE();
     }
   }
-  // Parameters at OSR entries have type dynamic.
+  const ParsedFunction& pf = graph_entry->parsed_function();
+
+  // Parameters at OSR entries have type dynamic, unless the OSR entry was
+  // specialized for the classes of the values it is entered with.
   //
   // TODO(kmillikin): Use the actual type of the parameter at OSR entry.
   // The code below is not safe for OSR because it doesn't necessarily use
   // the correct scope.
   if (graph_entry->IsCompiledForOsr()) {
+    if (block_->IsOsrEntry() && pf.osr_entry_cids() != nullptr &&
+        env_index() < pf.osr_entry_cids()->length()) {
+      const intptr_t cid = pf.osr_entry_cids()->At(env_index());
+      if (cid != kDynamicCid) {
+        return CompileType::FromCid(cid);
+      }
+    }
     // Parameter at OSR entry may correspond to a late local variable.
     return CompileType::DynamicOrSentinel();
   }
 
-  const ParsedFunction& pf = graph_entry->parsed_function();
   const Function& function = pf.function();
   if (function.IsIrregexpFunction()) {
     // In irregexp functions, types of input parameters are known and immutable.
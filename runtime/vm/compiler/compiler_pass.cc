@@ -12,6 +12,8 @@
 #include "vm/compiler/backend/il_printer.h"
 #include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/linearscan.h"
+#include "vm/compiler/backend/loop_vectorizer.h"
+#include "vm/compiler/backend/loops.h"
 #include "vm/compiler/backend/range_analysis.h"
 #include "vm/compiler/backend/redundancy_elimination.h"
 #include "vm/compiler/backend/type_propagator.h"
@@ -347,6 +349,11 @@ FlowGraph* CompilerPass::RunPipeline(PipelineMode mode,
   // so it should not be lifted earlier than that pass.
   INVOKE_PASS(DCE);
   INVOKE_PASS(Canonicalize);
+  // Vectorize and unroll after range analysis and environment elimination,
+  // so the new loop bodies share the eliminated checks and need no
+  // environments.
+  INVOKE_PASS_AOT(LoopVectorization);
+  INVOKE_PASS(LoopUnrolling);
   INVOKE_PASS_AOT(DelayAllocations);
   // Repeat branches optimization after DCE, as it could make more
   // empty blocks.
@@ -468,6 +475,24 @@ COMPILER_PASS(LICM, {
 
 COMPILER_PASS(DSE, { DeadStoreElimination::Optimize(flow_graph); });
 
+COMPILER_PASS(LoopVectorization, {
+  if (flow_graph->is_huge_method()) {
+    return false;
+  }
+
+  LoopVectorizer vectorizer(flow_graph);
+  vectorizer.Optimize();
+});
+
+COMPILER_PASS(LoopUnrolling, {
+  if (flow_graph->is_huge_method()) {
+    return false;
+  }
+
+  LoopUnroller unroller(flow_graph);
+  unroller.Optimize();
+});
+
 COMPILER_PASS(RangeAnalysis, {
   if (flow_graph->is_huge_method()) {
     return false;  // Runs in quadratic time.
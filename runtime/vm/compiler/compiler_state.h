@@ -72,6 +72,37 @@ class CompilerState : public ThreadStackResource {
   SlotCache* slot_cache() const { return slot_cache_; }
   void set_slot_cache(SlotCache* cache) { slot_cache_ = cache; }
 
+  // Instruction and call site counts of a function computed by the inliner.
+  struct FunctionSize {
+    const Function* function;
+    intptr_t instruction_count;
+    intptr_t call_site_count;
+    // Whether the counts replace previously cached ones.
+    bool force;
+  };
+
+  // If set, the inliner records the counts it computes in this list instead
+  // of caching them on the functions, so that functions which are compiled
+  // concurrently do not observe each other's results (see
+  // [FlowGraphInliner::PublishFunctionSizes]).
+  ZoneGrowableArray<FunctionSize>* deferred_function_sizes() const {
+    return deferred_function_sizes_;
+  }
+  void set_deferred_function_sizes(ZoneGrowableArray<FunctionSize>* sizes) {
+    deferred_function_sizes_ = sizes;
+  }
+
+  // If set, the inliner records the functions it finds not to be inlinable in
+  // this list instead of marking them, for the same reason (see
+  // [FlowGraphInliner::PublishNonInlinableFunctions]).
+  ZoneGrowableArray<const Function*>* deferred_non_inlinable_functions() const {
+    return deferred_non_inlinable_functions_;
+  }
+  void set_deferred_non_inlinable_functions(
+      ZoneGrowableArray<const Function*>* functions) {
+    deferred_non_inlinable_functions_ = functions;
+  }
+
   bool is_aot() const { return is_aot_; }
 
   bool is_optimizing() const { return is_optimizing_; }
@@ -137,6 +168,10 @@ class CompilerState : public ThreadStackResource {
   // Cache for Slot objects created during compilation (see slot.h).
   SlotCache* slot_cache_ = nullptr;
 
+  ZoneGrowableArray<FunctionSize>* deferred_function_sizes_ = nullptr;
+  ZoneGrowableArray<const Function*>* deferred_non_inlinable_functions_ =
+      nullptr;
+
   // Caches for dummy LocalVariables and context Slots.
   ZoneGrowableArray<ZoneGrowableArray<const Slot*>*>* dummy_slots_ = nullptr;
   ZoneGrowableArray<LocalVariable*>* dummy_captured_vars_ = nullptr;
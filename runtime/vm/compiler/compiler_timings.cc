@@ -90,10 +90,10 @@ void CompilerTimings::PrintTimers(
   }
 }
 
-void CompilerTimings::Print() {
+void CompilerTimings::Print(const char* name) {
   Zone* zone = Thread::Current()->zone();
 
-  OS::PrintErr("Precompilation took: %s\n",
+  OS::PrintErr("%s took: %s\n", name,
                total_.FormatElapsedHumanReadable(zone));
 
   PrintTimers(zone, root_, total_, 0);
@@ -117,6 +117,11 @@ class CompilerTimings : public MallocAllocated {
 
   CompilerTimings() { total_.Start(); }
 
+  // Stops and restarts the total time, e.g. for timings which are only
+  // attached to a thread while it helps the precompiler.
+  void Pause() { total_.Stop(); }
+  void Resume() { total_.Start(); }
+
   void RecordInliningStatsByOutcome(bool success, const Timer& timer) {
     if (success) {
       try_inlining_success_.AddTotal(timer);
@@ -125,7 +130,8 @@ class CompilerTimings : public MallocAllocated {
     }
   }
 
-  void Print();
+  // Prints the timers, headed by [name] and the total time.
+  void Print(const char* name = "Precompilation");
 
  private:
   void PrintTimers(Zone* zone,
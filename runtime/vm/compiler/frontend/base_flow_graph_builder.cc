@@ -6,6 +6,7 @@
 
 #include <utility>
 
+#include "vm/compiler/backend/inliner.h"
 #include "vm/compiler/backend/range_analysis.h"       // For Range.
 #include "vm/compiler/frontend/flow_graph_builder.h"  // For InlineExitCollector.
 #include "vm/compiler/frontend/kernel_translation_helper.h"
@@ -289,7 +290,7 @@ Fragment BaseFlowGraphBuilder::TailCall(const Code& code) {
 
 void BaseFlowGraphBuilder::InlineBailout(const char* reason) {
   if (IsInlining()) {
-    parsed_function_->function().set_is_inlinable(false);
+    FlowGraphInliner::MarkNonInlinable(parsed_function_->function());
     parsed_function_->Bailout("kernel::BaseFlowGraphBuilder", reason);
   }
 }
@@ -58,8 +58,11 @@ void InlineExitCollector::PrepareGraphs(FlowGraph* callee_graph) {
 
   const intptr_t outer_deopt_id = call_->deopt_id();
   // Scale the edge weights by the call count for the inlined function.
+  // AOT call sites carry no call counts, so only the relative weights of the
+  // callee's own branches are kept.
   double scale_factor = 1.0;
-  if (caller_graph_->graph_entry()->entry_count() != 0) {
+  if (caller_graph_->graph_entry()->entry_count() != 0 &&
+      !CompilerState::Current().is_aot()) {
     scale_factor =
         static_cast<double>(call_->CallCount()) /
         static_cast<double>(caller_graph_->graph_entry()->entry_count());
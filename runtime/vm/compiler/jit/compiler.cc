@@ -67,6 +67,11 @@ DEFINE_FLAG(bool,
             false,
             "Print the deopt-id to ICData map in optimizing compiler.");
 DEFINE_FLAG(bool, print_code_source_map, false, "Print code source map.");
+DEFINE_FLAG(int,
+            background_compiler_threads,
+            2,
+            "Maximum number of threads compiling optimized code in the "
+            "background for each isolate group.");
 DEFINE_FLAG(bool,
             stress_test_background_compilation,
             false,
@@ -75,6 +80,15 @@ DEFINE_FLAG(bool,
             stop_on_excessive_deoptimization,
             false,
             "Debugging: stops program if deoptimizing same function too often");
+DEFINE_FLAG(bool,
+            osr_code_cache,
+            true,
+            "Reuse OSR code for later OSR requests at the same loop.");
+DEFINE_FLAG(bool,
+            specialize_osr_entry,
+            true,
+            "Specialize OSR code for the classes of the values in the frame "
+            "it is entered from.");
 DEFINE_FLAG(bool, trace_compiler, false, "Trace compiler operations.");
 DEFINE_FLAG(bool,
             trace_failed_optimization_attempts,
@@ -297,17 +311,143 @@ bool Compiler::CanOptimizeFunction(Thread* thread, const Function& function) {
 
 bool Compiler::IsBackgroundCompilation() {
   // For now: compilation in non mutator thread is the background compilation.
-  return !Thread::Current()->IsDartMutatorThread();
+  // The precompiler's helper threads compile on behalf of the mutator, which
+  // waits for them.
+  Thread* thread = Thread::Current();
+  return !thread->IsDartMutatorThread() &&
+         thread->task_kind() != Thread::kPrecompilerTask;
+}
+
+// The OSR code cache of a function is an array in its ICData array (see
+// Function::ICDataArrayIndices::kOsrCode) with one entry per loop OSR code
+// was compiled for. The cache is only changed with all mutators stopped,
+// when OSR code is installed.
+enum OsrCodeCacheEntry {
+  kOsrIdIndex = 0,
+  kOsrCodeIndex,
+  // The unoptimized code the OSR code replaces.
+  kOsrUnoptimizedCodeIndex,
+  // Array of the Smi class ids the OSR entry is specialized for, or null.
+  kOsrEntryCidsIndex,
+  kOsrCodeCacheEntrySize,
+};
+
+static intptr_t FindOsrCodeCacheEntry(const Array& cache, intptr_t osr_id) {
+  if (cache.IsNull()) return -1;
+  for (intptr_t i = 0; i < cache.Length(); i += kOsrCodeCacheEntrySize) {
+    if (Smi::Value(Smi::RawCast(cache.At(i + kOsrIdIndex))) == osr_id) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// The value of the variable with [env_index] in the unoptimized frame of
+// [function] at [fp]. OSR code is entered with these values as the
+// parameters of its OsrEntry (see FlowGraph::PopulateEnvironmentFromOsrEntry).
+static ObjectPtr OsrEntryValueAt(const Function& function,
+                                 uword fp,
+                                 intptr_t env_index) {
+  const intptr_t num_direct_parameters =
+      function.MakesCopyOfParameters() ? 0 : function.NumParameters();
+  const intptr_t slot = runtime_frame_layout.FrameSlotForVariableIndex(
+      num_direct_parameters - env_index);
+  return *reinterpret_cast<ObjectPtr*>(fp + slot * kWordSize);
+}
+
+static intptr_t OsrEntryCid(ObjectPtr value) {
+  const intptr_t cid = value->GetClassIdMayBeSmi();
+  // Uninitialized late variables hold the sentinel, which is not a value of
+  // their type.
+  return cid == kSentinelCid ? kDynamicCid : cid;
+}
+
+CodePtr Compiler::LookupOsrCode(Thread* thread,
+                                const Function& function,
+                                intptr_t osr_id,
+                                uword frame_fp,
+                                bool* specialize) {
+  *specialize = FLAG_specialize_osr_entry;
+  if (!FLAG_osr_code_cache) return Code::null();
+  Zone* zone = thread->zone();
+  const Array& ic_data_array = Array::Handle(zone, function.ic_data_array());
+  if (ic_data_array.IsNull()) return Code::null();
+  const Array& cache = Array::Handle(
+      zone,
+      Array::RawCast(ic_data_array.At(Function::ICDataArrayIndices::kOsrCode)));
+  const intptr_t index = FindOsrCodeCacheEntry(cache, osr_id);
+  if (index < 0) return Code::null();
+
+  const Code& code =
+      Code::Handle(zone, Code::RawCast(cache.At(index + kOsrCodeIndex)));
+  // Code which was deoptimized (see DeoptimizeCopyFrame) or invalidated by
+  // class loading or field guards, and code for an older version of the
+  // function, is replaced by the next compilation.
+  if (!code.is_alive() || code.IsDisabled() ||
+      cache.At(index + kOsrUnoptimizedCodeIndex) !=
+          function.unoptimized_code()) {
+    return Code::null();
+  }
+  const Array& cids =
+      Array::Handle(zone, Array::RawCast(cache.At(index + kOsrEntryCidsIndex)));
+  if (!cids.IsNull()) {
+    for (intptr_t i = 0; i < cids.Length(); i++) {
+      const intptr_t cid = Smi::Value(Smi::RawCast(cids.At(i)));
+      if (cid != kDynamicCid &&
+          cid != OsrEntryCid(OsrEntryValueAt(function, frame_fp, i))) {
+        *specialize = false;
+        return Code::null();
+      }
+    }
+  }
+  return code.ptr();
+}
+
+static void AddToOsrCodeCache(Zone* zone,
+                              const Function& function,
+                              intptr_t osr_id,
+                              const Code& code,
+                              const ZoneGrowableArray<intptr_t>* entry_cids) {
+  const Array& ic_data_array = Array::Handle(zone, function.ic_data_array());
+  if (ic_data_array.IsNull()) return;
+  Array& cache = Array::Handle(
+      zone,
+      Array::RawCast(ic_data_array.At(Function::ICDataArrayIndices::kOsrCode)));
+  intptr_t index = FindOsrCodeCacheEntry(cache, osr_id);
+  if (index < 0) {
+    if (cache.IsNull()) {
+      index = 0;
+      cache = Array::New(kOsrCodeCacheEntrySize, Heap::kOld);
+    } else {
+      index = cache.Length();
+      cache = Array::Grow(cache, index + kOsrCodeCacheEntrySize, Heap::kOld);
+    }
+  }
+  Array& cids = Array::Handle(zone);
+  if (entry_cids != nullptr) {
+    cids = Array::New(entry_cids->length(), Heap::kOld);
+    for (intptr_t i = 0; i < entry_cids->length(); i++) {
+      cids.SetAt(i, Smi::Handle(zone, Smi::New(entry_cids->At(i))));
+    }
+  }
+  cache.SetAt(index + kOsrIdIndex, Smi::Handle(zone, Smi::New(osr_id)));
+  cache.SetAt(index + kOsrCodeIndex, code);
+  cache.SetAt(index + kOsrUnoptimizedCodeIndex,
+              Code::Handle(zone, function.unoptimized_code()));
+  cache.SetAt(index + kOsrEntryCidsIndex, cids);
+  ic_data_array.SetAt(Function::ICDataArrayIndices::kOsrCode, cache);
 }
 
 class CompileParsedFunctionHelper : public ValueObject {
  public:
   CompileParsedFunctionHelper(ParsedFunction* parsed_function,
                               bool optimized,
-                              intptr_t osr_id)
+                              intptr_t osr_id,
+                              uword osr_frame_fp = 0)
       : parsed_function_(parsed_function),
         optimized_(optimized),
         osr_id_(osr_id),
+        osr_frame_fp_(osr_frame_fp),
         thread_(Thread::Current()) {}
 
   CodePtr Compile(CompilationPipeline* pipeline);
@@ -325,6 +465,7 @@ class CompileParsedFunctionHelper : public ValueObject {
   ParsedFunction* parsed_function_;
   const bool optimized_;
   const intptr_t osr_id_;
+  const uword osr_frame_fp_;
   Thread* const thread_;
 
   DISALLOW_COPY_AND_ASSIGN(CompileParsedFunctionHelper);
@@ -430,6 +571,10 @@ CodePtr CompileParsedFunctionHelper::FinalizeCompilation(
       } else {
         // OSR is not compiled in background.
         ASSERT(!Compiler::IsBackgroundCompilation());
+        if (FLAG_osr_code_cache) {
+          AddToOsrCodeCache(zone, function, osr_id(), code,
+                            parsed_function()->osr_entry_cids());
+        }
       }
       ASSERT(code.owner() == function.ptr());
     } else {
@@ -548,6 +693,17 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
             zone, parsed_function(), ic_data_array, osr_id(), optimized());
       }
 
+      if (osr_frame_fp_ != 0 && flow_graph->IsCompiledForOsr()) {
+        // Specialize the OSR entry for the classes of the values in the
+        // frame it is entered from.
+        const intptr_t count = flow_graph->osr_variable_count();
+        auto* cids = new (zone) ZoneGrowableArray<intptr_t>(count);
+        for (intptr_t i = 0; i < count; i++) {
+          cids->Add(OsrEntryCid(OsrEntryValueAt(function, osr_frame_fp_, i)));
+        }
+        parsed_function()->set_osr_entry_cids(cids);
+      }
+
       const bool print_flow_graph =
           (FLAG_print_flow_graph ||
            (optimized() && FLAG_print_flow_graph_optimized)) &&
@@ -682,7 +838,8 @@ CodePtr CompileParsedFunctionHelper::Compile(CompilationPipeline* pipeline) {
 static ObjectPtr CompileFunctionHelper(CompilationPipeline* pipeline,
                                        const Function& function,
                                        volatile bool optimized,
-                                       intptr_t osr_id) {
+                                       intptr_t osr_id,
+                                       uword osr_frame_fp = 0) {
   Thread* const thread = Thread::Current();
   NoActiveIsolateScope no_active_isolate(thread);
 
@@ -715,7 +872,8 @@ static ObjectPtr CompileFunctionHelper(CompilationPipeline* pipeline,
       pipeline->ParseFunction(parsed_function);
     }
 
-    CompileParsedFunctionHelper helper(parsed_function, optimized, osr_id);
+    CompileParsedFunctionHelper helper(parsed_function, optimized, osr_id,
+                                       osr_frame_fp);
 
     const Code& result = Code::Handle(helper.Compile(pipeline));
 
@@ -885,7 +1043,8 @@ ErrorPtr Compiler::EnsureUnoptimizedCode(Thread* thread,
 
 ObjectPtr Compiler::CompileOptimizedFunction(Thread* thread,
                                              const Function& function,
-                                             intptr_t osr_id) {
+                                             intptr_t osr_id,
+                                             uword osr_frame_fp) {
   VMTagScope tag_scope(thread, VMTag::kCompileOptimizedTagId);
 
 #if defined(SUPPORT_TIMELINE)
@@ -903,7 +1062,7 @@ ObjectPtr Compiler::CompileOptimizedFunction(Thread* thread,
   CompilationPipeline* pipeline =
       CompilationPipeline::New(thread->zone(), function);
   return CompileFunctionHelper(pipeline, function, /* optimized = */ true,
-                               osr_id);
+                               osr_id, osr_frame_fp);
 }
 
 void Compiler::ComputeLocalVarDescriptors(const Code& code) {
@@ -992,7 +1151,9 @@ void Compiler::AbortBackgroundCompilation(intptr_t deopt_id, const char* msg) {
 class QueueElement {
  public:
   explicit QueueElement(const Function& function)
-      : next_(nullptr), function_(function.ptr()) {}
+      : next_(nullptr),
+        function_(function.ptr()),
+        enqueue_time_(OS::GetCurrentMonotonicMicros()) {}
 
   virtual ~QueueElement() {
     next_ = nullptr;
@@ -1009,19 +1170,30 @@ class QueueElement {
     return reinterpret_cast<ObjectPtr*>(&function_);
   }
 
+  // Monotonic time in microseconds at which the element was created.
+  int64_t enqueue_time() const { return enqueue_time_; }
+
  private:
   QueueElement* next_;
   FunctionPtr function_;
+  int64_t enqueue_time_;
 
   DISALLOW_COPY_AND_ASSIGN(QueueElement);
 };
 
 // Allocated in C-heap. Handles both input and output of background compilation.
-// It implements a FIFO queue, using Peek, Add, Remove operations.
+// It implements a queue, using Peek, Add, Remove operations, from which
+// compiler tasks take the hottest function with RemoveHottest. Elements taken
+// by RemoveHottest stay visible to ContainsObj and the GC until they are
+// passed to Done, so a function is never compiled by two tasks at once.
 class BackgroundCompilationQueue {
  public:
-  BackgroundCompilationQueue() : first_(nullptr), last_(nullptr) {}
-  virtual ~BackgroundCompilationQueue() { Clear(); }
+  BackgroundCompilationQueue()
+      : first_(nullptr), last_(nullptr), length_(0), in_progress_() {}
+  virtual ~BackgroundCompilationQueue() {
+    Clear();
+    ASSERT(in_progress_.is_empty());
+  }
 
   void VisitObjectPointers(ObjectPointerVisitor* visitor) {
     ASSERT(visitor != nullptr);
@@ -1030,9 +1202,14 @@ class BackgroundCompilationQueue {
       visitor->VisitPointer(p->function_untag());
       p = p->next();
     }
+    for (intptr_t i = 0; i < in_progress_.length(); i++) {
+      visitor->VisitPointer(in_progress_[i]->function_untag());
+    }
   }
 
   bool IsEmpty() const { return first_ == nullptr; }
+  intptr_t Length() const { return length_; }
+  intptr_t NumInProgress() const { return in_progress_.length(); }
 
   void Add(QueueElement* value) {
     ASSERT(value != nullptr);
@@ -1045,6 +1222,7 @@ class BackgroundCompilationQueue {
       last_->set_next(value);
     }
     last_ = value;
+    length_++;
     ASSERT(first_ != nullptr && last_ != nullptr);
   }
 
@@ -1066,9 +1244,59 @@ class BackgroundCompilationQueue {
     if (first_ == nullptr) {
       last_ = nullptr;
     }
+    result->set_next(nullptr);
+    length_--;
     return result;
   }
 
+  // Removes the element whose function has the highest usage counter, the
+  // oldest one among equally hot functions, and marks it as in progress.
+  // [function] is used as a scratch handle.
+  QueueElement* RemoveHottest(Function* function) {
+    ASSERT(first_ != nullptr);
+    QueueElement* best_prev = nullptr;
+    QueueElement* best = first_;
+    *function ^= best->function();
+    intptr_t best_count = function->usage_counter();
+    QueueElement* prev = first_;
+    for (QueueElement* p = first_->next(); p != nullptr; p = p->next()) {
+      *function ^= p->function();
+      const intptr_t count = function->usage_counter();
+      if (count > best_count) {
+        best_prev = prev;
+        best = p;
+        best_count = count;
+      }
+      prev = p;
+    }
+    if (best_prev == nullptr) {
+      first_ = best->next();
+    } else {
+      best_prev->set_next(best->next());
+    }
+    if (last_ == best) {
+      last_ = best_prev;
+    }
+    best->set_next(nullptr);
+    length_--;
+    in_progress_.Add(best);
+    *function ^= best->function();
+    return best;
+  }
+
+  // Deletes an element returned by RemoveHottest once its function has been
+  // compiled.
+  void Done(QueueElement* element) {
+    for (intptr_t i = 0; i < in_progress_.length(); i++) {
+      if (in_progress_[i] == element) {
+        in_progress_.RemoveAt(i);
+        delete element;
+        return;
+      }
+    }
+    UNREACHABLE();
+  }
+
   bool ContainsObj(const Object& obj) const {
     QueueElement* p = first_;
     while (p != nullptr) {
@@ -1077,6 +1305,11 @@ class BackgroundCompilationQueue {
       }
       p = p->next();
     }
+    for (intptr_t i = 0; i < in_progress_.length(); i++) {
+      if (in_progress_[i]->function() == obj.ptr()) {
+        return true;
+      }
+    }
     return false;
   }
 
@@ -1085,12 +1318,15 @@ class BackgroundCompilationQueue {
       QueueElement* e = Remove();
       delete e;
     }
-    ASSERT((first_ == nullptr) && (last_ == nullptr));
+    ASSERT((first_ == nullptr) && (last_ == nullptr) && (length_ == 0));
   }
 
  private:
   QueueElement* first_;
   QueueElement* last_;
+  intptr_t length_;
+  // Elements whose functions are being compiled, owned by the queue.
+  MallocGrowableArray<QueueElement*> in_progress_;
 
   DISALLOW_COPY_AND_ASSIGN(BackgroundCompilationQueue);
 };
@@ -1114,7 +1350,7 @@ BackgroundCompiler::BackgroundCompiler(IsolateGroup* isolate_group)
       monitor_(),
       function_queue_(new BackgroundCompilationQueue()),
       running_(false),
-      done_(true),
+      num_tasks_(0),
       disabled_depth_(0) {}
 
 // Fields all deleted in ::Stop; here clear them.
@@ -1122,6 +1358,29 @@ BackgroundCompiler::~BackgroundCompiler() {
   delete function_queue_;
 }
 
+bool BackgroundCompiler::StartTaskLocked() {
+  ASSERT(monitor_.IsOwnedByCurrentThread());
+  // If we ever wanted to run the BG compiler on the
+  // `IsolateGroup::mutator_pool()` we would need to ensure the BG compiler
+  // stops when it's idle - otherwise the [MutatorThreadPool]-based idle
+  // notification would not work anymore.
+  if (!Dart::thread_pool()->Run<BackgroundCompilerTask>(this)) {
+    return false;
+  }
+  // The new task can't look at [num_tasks_] before we release [monitor_].
+  num_tasks_++;
+  return true;
+}
+
+void BackgroundCompiler::UpdateQueueLengthMetricsLocked() {
+  ASSERT(monitor_.IsOwnedByCurrentThread());
+  const intptr_t length = function_queue()->Length();
+  isolate_group_->GetBackgroundCompilationQueueLengthMetric()->set_value(
+      length);
+  isolate_group_->GetBackgroundCompilationQueueLengthMaxMetric()->SetValue(
+      length);
+}
+
 void BackgroundCompiler::Run() {
   bool result = Thread::EnterIsolateGroupAsHelper(
       isolate_group_, Thread::kCompilerTask, /*bypass_safepoint=*/false);
@@ -1136,14 +1395,28 @@ void BackgroundCompiler::Run() {
     {
       SafepointMonitorLocker ml(&monitor_);
       if (running_ && !function_queue()->IsEmpty()) {
-        element = function_queue()->Remove();
-        function ^= element->function();
+        element = function_queue()->RemoveHottest(&function);
+        UpdateQueueLengthMetricsLocked();
+        const int64_t wait =
+            OS::GetCurrentMonotonicMicros() - element->enqueue_time();
+        Metric* total_wait =
+            isolate_group_->GetBackgroundCompilationWaitMetric();
+        total_wait->set_value(total_wait->value() + wait);
+        isolate_group_->GetBackgroundCompilationWaitMaxMetric()->SetValue(
+            wait);
       }
     }
     if (element != nullptr) {
-      delete element;
+      // Other compiler tasks may be compiling other functions concurrently.
+      // Installing the code and registering its CHA and field guard
+      // dependencies happens with all mutators and compiler tasks stopped
+      // (see CompileParsedFunctionHelper::FinalizeCompilation).
       Compiler::CompileOptimizedFunction(thread, function,
                                          Compiler::kNoOSRDeoptId);
+      {
+        SafepointMonitorLocker ml(&monitor_);
+        function_queue()->Done(element);
+      }
 
       // If an optimizable method is not optimized, put it back on
       // the background queue (unless it was passed to foreground).
@@ -1151,9 +1424,10 @@ void BackgroundCompiler::Run() {
           FLAG_stress_test_background_compilation) {
         if (Compiler::CanOptimizeFunction(thread, function)) {
           SafepointMonitorLocker ml(&monitor_);
-          if (running_) {
+          if (running_ && !function_queue()->ContainsObj(function)) {
             QueueElement* repeat_qelem = new QueueElement(function);
             function_queue()->Add(repeat_qelem);
+            UpdateQueueLengthMetricsLocked();
           }
         }
       }
@@ -1164,13 +1438,16 @@ void BackgroundCompiler::Run() {
     MonitorLocker ml(&monitor_);
     if (running_ && !function_queue()->IsEmpty() &&
         Dart::thread_pool()->Run<BackgroundCompilerTask>(this)) {
-      // Successfully scheduled a new task.
+      // Successfully scheduled a new task which replaces this one.
     } else {
-      // Background compiler done. This notification must happen after the
-      // thread leaves to group to avoid a shutdown race with the thread
-      // registry.
-      running_ = false;
-      done_ = true;
+      // This notification must happen after the thread leaves to group to
+      // avoid a shutdown race with the thread registry.
+      ASSERT(num_tasks_ > 0);
+      num_tasks_--;
+      if (num_tasks_ == 0) {
+        // Background compiler done.
+        running_ = false;
+      }
       ml.NotifyAll();
     }
   }
@@ -1183,16 +1460,10 @@ bool BackgroundCompiler::EnqueueCompilation(const Function& function) {
 
   SafepointMonitorLocker ml(&monitor_);
   if (disabled_depth_ > 0) return false;
-  if (!running_ && done_) {
+  if (!running_ && num_tasks_ == 0) {
     running_ = true;
-    done_ = false;
-    // If we ever wanted to run the BG compiler on the
-    // `IsolateGroup::mutator_pool()` we would need to ensure the BG compiler
-    // stops when it's idle - otherwise the [MutatorThreadPool]-based idle
-    // notification would not work anymore.
-    if (!Dart::thread_pool()->Run<BackgroundCompilerTask>(this)) {
+    if (!StartTaskLocked()) {
       running_ = false;
-      done_ = true;
       return false;
     }
   }
@@ -1203,6 +1474,16 @@ bool BackgroundCompiler::EnqueueCompilation(const Function& function) {
   }
   QueueElement* elem = new QueueElement(function);
   function_queue()->Add(elem);
+  UpdateQueueLengthMetricsLocked();
+  // Start another task if every task has a function to compile. If that
+  // fails, the function will be compiled by one of the running tasks.
+  const intptr_t max_tasks =
+      Utils::Maximum(FLAG_background_compiler_threads, 1);
+  if (num_tasks_ < max_tasks &&
+      num_tasks_ <
+          function_queue()->Length() + function_queue()->NumInProgress()) {
+    StartTaskLocked();
+  }
   ml.NotifyAll();
   return true;
 }
@@ -1224,7 +1505,8 @@ void BackgroundCompiler::StopLocked(Thread* thread,
                                     SafepointMonitorLocker* locker) {
   running_ = false;
   function_queue_->Clear();
-  while (!done_) {
+  UpdateQueueLengthMetricsLocked();
+  while (num_tasks_ > 0) {
     locker->Wait();
   }
 }
@@ -1248,7 +1530,7 @@ void BackgroundCompiler::Disable() {
 
   SafepointMonitorLocker ml(&monitor_);
   disabled_depth_++;
-  if (done_) return;
+  if (!IsRunning()) return;
   StopLocked(thread, &ml);
 }
 
@@ -1290,11 +1572,21 @@ ErrorPtr Compiler::EnsureUnoptimizedCode(Thread* thread,
 
 ObjectPtr Compiler::CompileOptimizedFunction(Thread* thread,
                                              const Function& function,
-                                             intptr_t osr_id) {
+                                             intptr_t osr_id,
+                                             uword osr_frame_fp) {
   FATAL("Attempt to compile function %s", function.ToCString());
   return Error::null();
 }
 
+CodePtr Compiler::LookupOsrCode(Thread* thread,
+                                const Function& function,
+                                intptr_t osr_id,
+                                uword frame_fp,
+                                bool* specialize) {
+  UNREACHABLE();
+  return Code::null();
+}
+
 void Compiler::ComputeLocalVarDescriptors(const Code& code) {
   UNREACHABLE();
 }
@@ -93,9 +93,27 @@ class Compiler : public AllStatic {
   // there is a compilation error.  If optimization fails, but there is no
   // error, returns null.  Any generated code is installed unless we are in
   // OSR mode.
+  //
+  // In OSR mode, the code is added to the OSR code cache of the function. If
+  // [osr_frame_fp] is not 0, the OSR entry is specialized for the classes of
+  // the values in the unoptimized frame at [osr_frame_fp].
   static ObjectPtr CompileOptimizedFunction(Thread* thread,
                                             const Function& function,
-                                            intptr_t osr_id = kNoOSRDeoptId);
+                                            intptr_t osr_id = kNoOSRDeoptId,
+                                            uword osr_frame_fp = 0);
+
+  // Returns the OSR code compiled for an earlier request at the loop with
+  // [osr_id] if it can be entered from the unoptimized frame at [frame_fp],
+  // or null otherwise.
+  //
+  // Sets [*specialize] to whether the code replacing it should have a
+  // specialized entry: code whose entry was specialized for classes the
+  // frame no longer has is replaced by code which works for any class.
+  static CodePtr LookupOsrCode(Thread* thread,
+                               const Function& function,
+                               intptr_t osr_id,
+                               uword frame_fp,
+                               bool* specialize);
 
   // Generates local var descriptors and sets it in 'code'. Do not call if the
   // local var descriptor already exists.
@@ -113,9 +131,10 @@ class Compiler : public AllStatic {
   static void AbortBackgroundCompilation(intptr_t deopt_id, const char* msg);
 };
 
-// Class to run optimizing compilation in a background thread.
-// Current implementation: one task per isolate, it dies with the owning
-// isolate.
+// Class to run optimizing compilation in background threads.
+// Current implementation: up to --background_compiler_threads tasks per
+// isolate group, they die with the owning isolate group. The hottest queued
+// function (by usage counter) is compiled first.
 // No OSR compilation in the background compiler.
 class BackgroundCompiler {
  public:
@@ -145,14 +164,18 @@ class BackgroundCompiler {
   void StopLocked(Thread* thread, SafepointMonitorLocker* done_locker);
   void Enable();
   void Disable();
-  bool IsRunning() { return !done_; }
+  bool IsRunning() { return num_tasks_ > 0; }
+
+  // Schedules another compiler task. Requires [monitor_] to be held.
+  bool StartTaskLocked();
+  void UpdateQueueLengthMetricsLocked();
 
   IsolateGroup* isolate_group_;
 
   Monitor monitor_;  // Controls access to the queue and running state.
   BackgroundCompilationQueue* function_queue_;
-  bool running_;  // While true, will try to read queue and compile.
-  bool done_;     // True if the thread is done.
+  bool running_;        // While true, will try to read queue and compile.
+  intptr_t num_tasks_;  // The number of scheduled or running tasks.
   int16_t disabled_depth_;
 
   DISALLOW_IMPLICIT_CONSTRUCTORS(BackgroundCompiler);
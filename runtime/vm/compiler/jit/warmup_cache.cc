@@ -0,0 +1,235 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/jit/warmup_cache.h"
+
+#include "vm/compiler/frontend/kernel_fingerprints.h"
+#include "vm/compiler/jit/compiler.h"
+#include "vm/dart.h"
+#include "vm/flags.h"
+#include "vm/log.h"
+#include "vm/object.h"
+#include "vm/object_store.h"
+#include "vm/timeline.h"
+#include "vm/version.h"
+#include "vm/zone_text_buffer.h"
+
+namespace dart {
+
+DEFINE_FLAG(charp,
+            jit_warmup_cache,
+            nullptr,
+            "Record the optimized functions in this file on exit and prime "
+            "them for optimization when the program is loaded again.");
+DEFINE_FLAG(int,
+            jit_warmup_cache_feedback,
+            100,
+            "The number of invocations after which a function recorded in "
+            "the JIT warmup cache is optimized.");
+DECLARE_FLAG(bool, trace_compiler);
+
+static constexpr const char* kHeader = "# dart-jit-warmup-cache ";
+static constexpr const char* kTopLevelClassName = "::";
+static constexpr intptr_t kNumFields = 4;
+
+// An entry of the cache file: "<fingerprint>\t<url>\t<class>\t<function>".
+// Names are stored without their library private key.
+struct WarmupCacheEntry {
+  const char* fields[kNumFields];
+  intptr_t lengths[kNumFields];
+
+  uint32_t fingerprint() const {
+    return static_cast<uint32_t>(strtoul(fields[0], nullptr, 16));
+  }
+  StringPtr ToString(intptr_t field) const {
+    return String::FromUTF8(reinterpret_cast<const uint8_t*>(fields[field]),
+                            lengths[field]);
+  }
+};
+
+// Splits [line] (of [length] bytes) into the fields of [entry]. Returns false
+// if it has the wrong number of fields.
+static bool ParseEntry(const char* line,
+                       intptr_t length,
+                       WarmupCacheEntry* entry) {
+  intptr_t field = 0;
+  intptr_t start = 0;
+  for (intptr_t i = 0; i <= length; i++) {
+    if (i < length && line[i] != '\t') continue;
+    if (field == kNumFields) return false;
+    entry->fields[field] = line + start;
+    entry->lengths[field] = i - start;
+    field++;
+    start = i + 1;
+  }
+  return field == kNumFields;
+}
+
+static bool PrimeFunction(Thread* thread, const WarmupCacheEntry& entry) {
+  Zone* zone = thread->zone();
+  const auto& url = String::Handle(zone, entry.ToString(1));
+  const auto& lib = Library::Handle(zone, Library::LookupLibrary(thread, url));
+  if (lib.IsNull()) return false;
+
+  auto& cls = Class::Handle(zone);
+  const auto& class_name = String::Handle(zone, entry.ToString(2));
+  if (class_name.Equals(kTopLevelClassName)) {
+    cls = lib.toplevel_class();
+  } else {
+    cls = lib.LookupClassAllowPrivate(class_name);
+  }
+  if (cls.IsNull() || cls.EnsureIsFinalized(thread) != Error::null()) {
+    return false;
+  }
+
+  const auto& function_name = String::Handle(zone, entry.ToString(3));
+  const auto& function =
+      Function::Handle(zone, cls.LookupFunctionAllowPrivate(function_name));
+  if (function.IsNull() || !function.IsOptimizable()) return false;
+
+  // The function changed since the cache was written.
+  if (kernel::KernelSourceFingerprintHelper::CalculateFunctionFingerprint(
+          function) != entry.fingerprint()) {
+    return false;
+  }
+
+  if (Compiler::EnsureUnoptimizedCode(thread, function) != Error::null()) {
+    return false;
+  }
+  const intptr_t primed_counter = Utils::Maximum<intptr_t>(
+      0, FLAG_optimization_counter_threshold - FLAG_jit_warmup_cache_feedback);
+  if (function.usage_counter() < primed_counter) {
+    function.SetUsageCounter(primed_counter);
+  }
+  return true;
+}
+
+void JitWarmupCache::Load(Thread* thread) {
+  if (FLAG_jit_warmup_cache == nullptr) return;
+  auto file_open = Dart::file_open_callback();
+  auto file_read = Dart::file_read_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_read == nullptr) ||
+      (file_close == nullptr)) {
+    return;
+  }
+  // There is no cache yet on the first run.
+  void* file = file_open(FLAG_jit_warmup_cache, /*write=*/false);
+  if (file == nullptr) return;
+  uint8_t* data = nullptr;
+  intptr_t length = -1;
+  file_read(&data, &length, file);
+  file_close(file);
+  if (data == nullptr || length < 0) return;
+
+  TIMELINE_DURATION(thread, Compiler, "LoadJitWarmupCache");
+  const char* contents = reinterpret_cast<const char*>(data);
+  const char* end = contents + length;
+
+  // The cache is only valid for the VM that wrote it.
+  const char* version = Version::SnapshotString();
+  const intptr_t header_length = strlen(kHeader);
+  const intptr_t version_length = strlen(version);
+  if (length < header_length + version_length + 1 ||
+      strncmp(contents, kHeader, header_length) != 0 ||
+      strncmp(contents + header_length, version, version_length) != 0 ||
+      contents[header_length + version_length] != '\n') {
+    if (FLAG_trace_compiler) {
+      THR_Print("Ignoring JIT warmup cache %s from a different VM\n",
+                FLAG_jit_warmup_cache);
+    }
+    free(data);
+    return;
+  }
+
+  intptr_t num_primed = 0;
+  intptr_t num_skipped = 0;
+  const char* line = contents + header_length + version_length + 1;
+  while (line < end) {
+    const char* line_end =
+        reinterpret_cast<const char*>(memchr(line, '\n', end - line));
+    if (line_end == nullptr) line_end = end;
+    WarmupCacheEntry entry;
+    StackZone zone(thread);
+    if (ParseEntry(line, line_end - line, &entry) &&
+        PrimeFunction(thread, entry)) {
+      num_primed++;
+    } else {
+      num_skipped++;
+    }
+    line = line_end + 1;
+  }
+  free(data);
+
+  if (FLAG_trace_compiler) {
+    THR_Print("Primed %" Pd " functions from JIT warmup cache %s, skipped %" Pd
+              "\n",
+              num_primed, FLAG_jit_warmup_cache, num_skipped);
+  }
+}
+
+void JitWarmupCache::Save(Thread* thread) {
+  if (FLAG_jit_warmup_cache == nullptr) return;
+  auto file_open = Dart::file_open_callback();
+  auto file_write = Dart::file_write_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_write == nullptr) ||
+      (file_close == nullptr)) {
+    OS::PrintErr("warning: Could not access file callbacks.");
+    return;
+  }
+
+  TIMELINE_DURATION(thread, Compiler, "SaveJitWarmupCache");
+  Zone* zone = thread->zone();
+  ZoneTextBuffer buffer(zone);
+  buffer.Printf("%s%s\n", kHeader, Version::SnapshotString());
+
+  const auto& libraries = GrowableObjectArray::Handle(
+      zone, thread->isolate_group()->object_store()->libraries());
+  auto& lib = Library::Handle(zone);
+  auto& cls = Class::Handle(zone);
+  auto& functions = Array::Handle(zone);
+  auto& function = Function::Handle(zone);
+  auto& url = String::Handle(zone);
+  auto& class_name = String::Handle(zone);
+  auto& function_name = String::Handle(zone);
+  for (intptr_t i = 0; i < libraries.Length(); i++) {
+    lib ^= libraries.At(i);
+    url = lib.url();
+    ClassDictionaryIterator it(lib, ClassDictionaryIterator::kIteratePrivate);
+    while (it.HasNext()) {
+      cls = it.GetNextClass();
+      if (!cls.is_finalized()) continue;
+      if (cls.IsTopLevel()) {
+        class_name = String::New(kTopLevelClassName);
+      } else {
+        class_name = String::RemovePrivateKey(String::Handle(zone, cls.Name()));
+      }
+      functions = cls.current_functions();
+      for (intptr_t j = 0; j < functions.Length(); j++) {
+        function ^= functions.At(j);
+        if (!function.HasOptimizedCode()) continue;
+        function_name = String::RemovePrivateKey(
+            String::Handle(zone, function.name()));
+        buffer.Printf(
+            "%08" Px32 "\t%s\t%s\t%s\n",
+            kernel::KernelSourceFingerprintHelper::CalculateFunctionFingerprint(
+                function),
+            url.ToCString(), class_name.ToCString(),
+            function_name.ToCString());
+      }
+    }
+  }
+
+  void* file = file_open(FLAG_jit_warmup_cache, /*write=*/true);
+  if (file == nullptr) {
+    OS::PrintErr("warning: Failed to write JIT warmup cache: %s\n",
+                 FLAG_jit_warmup_cache);
+    return;
+  }
+  file_write(buffer.buffer(), buffer.length(), file);
+  file_close(file);
+}
+
+}  // namespace dart
@@ -0,0 +1,46 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_JIT_WARMUP_CACHE_H_
+#define RUNTIME_VM_COMPILER_JIT_WARMUP_CACHE_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+
+namespace dart {
+
+class Thread;
+
+// Remembers across process restarts which functions were optimized, so a
+// new process can get them to optimized code sooner.
+//
+// When --jit_warmup_cache=<file> is given, the functions with optimized code
+// are written to the file when the last isolate of a group shuts down. Each
+// entry records the kernel fingerprint of the function, see
+// [KernelSourceFingerprintHelper]. When the program is loaded again, every
+// function whose fingerprint still matches is compiled eagerly and its usage
+// counter is primed, so it is optimized after it has collected fresh type
+// feedback for --jit_warmup_cache_feedback invocations. Functions whose
+// source changed are skipped, and the whole file is ignored if it was
+// written by a different VM version.
+//
+// Machine code itself is not persisted: it embeds the addresses of objects
+// of the process which produced it, and its speculative assumptions (CHA,
+// field guards) have to be established again in the new process anyway.
+class JitWarmupCache : public AllStatic {
+ public:
+  // Primes the functions recorded in the cache file, if any. Called once the
+  // program of the current isolate group is loaded.
+  static void Load(Thread* thread);
+
+  // Records the currently optimized functions in the cache file.
+  static void Save(Thread* thread);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_JIT_WARMUP_CACHE_H_
@@ -627,6 +627,9 @@ word ICData::EntryPointIndexFor(word num_args) {
 const word MegamorphicCache::kSpreadFactor =
     dart::MegamorphicCache::kSpreadFactor;
 
+const word MegamorphicCache::kEntryLength =
+    dart::MegamorphicCache::kEntryLength;
+
 // Currently we have two different axes for offset generation:
 //
 //  * Target architecture
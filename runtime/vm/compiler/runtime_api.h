@@ -562,6 +562,7 @@ class ICData : public AllStatic {
 class MegamorphicCache : public AllStatic {
  public:
   static const word kSpreadFactor;
+  static const word kEntryLength;
   static word mask_offset();
   static word buckets_offset();
   static word InstanceSize();
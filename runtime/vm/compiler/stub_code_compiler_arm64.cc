@@ -3385,8 +3385,14 @@ void StubCodeCompiler::GenerateMegamorphicCallStub() {
   __ Bind(&cid_loaded);
   __ ldr(R2,
          FieldAddress(IC_DATA_REG, target::MegamorphicCache::buckets_offset()));
-  __ ldr(R1,
-         FieldAddress(IC_DATA_REG, target::MegamorphicCache::mask_offset()));
+  // The mask is derived from the length of the buckets instead of being
+  // loaded from the cache, as growing the cache replaces its buckets while
+  // other threads may be running this stub. The entries are loaded through
+  // the buckets pointer, so they are as recent as the buckets themselves.
+  ASSERT(target::MegamorphicCache::kEntryLength == 2);
+  __ LoadCompressedSmi(R1, FieldAddress(R2, target::Array::length_offset()));
+  __ LsrImmediate(R1, 1);
+  __ AddImmediate(R1, -target::ToRawSmi(1));
   // R2: cache buckets array.
   // R1: mask as a smi.
 
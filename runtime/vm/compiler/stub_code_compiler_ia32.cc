@@ -2976,10 +2976,16 @@ void StubCodeCompiler::GenerateMegamorphicCallStub() {
   Label cid_loaded;
   __ Bind(&cid_loaded);
   __ pushl(EBX);  // save receiver
-  __ movl(EBX,
-          FieldAddress(IC_DATA_REG, target::MegamorphicCache::mask_offset()));
   __ movl(EDI, FieldAddress(IC_DATA_REG,
                             target::MegamorphicCache::buckets_offset()));
+  // The mask is derived from the length of the buckets instead of being
+  // loaded from the cache, as growing the cache replaces its buckets while
+  // other threads may be running this stub. The entries are loaded through
+  // the buckets pointer, so they are as recent as the buckets themselves.
+  ASSERT(target::MegamorphicCache::kEntryLength == 2);
+  __ movl(EBX, FieldAddress(EDI, target::Array::length_offset()));
+  __ LsrImmediate(EBX, 1);
+  __ AddImmediate(EBX, -target::ToRawSmi(1));
   // EDI: cache buckets array.
   // EBX: mask as a smi.
 
@@ -3150,7 +3150,14 @@ void StubCodeCompiler::GenerateMegamorphicCallStub() {
   __ Bind(&cid_loaded);
   __ lx(T2,
         FieldAddress(IC_DATA_REG, target::MegamorphicCache::buckets_offset()));
-  __ lx(T1, FieldAddress(IC_DATA_REG, target::MegamorphicCache::mask_offset()));
+  // The mask is derived from the length of the buckets instead of being
+  // loaded from the cache, as growing the cache replaces its buckets while
+  // other threads may be running this stub. The entries are loaded through
+  // the buckets pointer, so they are as recent as the buckets themselves.
+  ASSERT(target::MegamorphicCache::kEntryLength == 2);
+  __ LoadCompressedSmi(T1, FieldAddress(T2, target::Array::length_offset()));
+  __ LsrImmediate(T1, 1);
+  __ AddImmediate(T1, -target::ToRawSmi(1));
   // T2: cache buckets array.
   // T1: mask as a smi.
 
@@ -3300,10 +3300,16 @@ void StubCodeCompiler::GenerateMegamorphicCallStub() {
 
   Label cid_loaded;
   __ Bind(&cid_loaded);
-  __ movq(R9,
-          FieldAddress(IC_DATA_REG, target::MegamorphicCache::mask_offset()));
   __ movq(RDI, FieldAddress(IC_DATA_REG,
                             target::MegamorphicCache::buckets_offset()));
+  // The mask is derived from the length of the buckets instead of being
+  // loaded from the cache, as growing the cache replaces its buckets while
+  // other threads may be running this stub. The entries are loaded through
+  // the buckets pointer, so they are as recent as the buckets themselves.
+  ASSERT(target::MegamorphicCache::kEntryLength == 2);
+  __ LoadCompressedSmi(R9, FieldAddress(RDI, target::Array::length_offset()));
+  __ LsrImmediate(R9, 1);
+  __ AddImmediate(R9, -target::ToRawSmi(1));
   // R9: mask as a smi.
   // RDI: cache buckets array.
 
@@ -0,0 +1,515 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/type_feedback.h"
+
+#include "platform/text_buffer.h"
+#include "vm/closure_functions_cache.h"
+#include "vm/dart.h"
+#include "vm/flags.h"
+#include "vm/hash_table.h"
+#include "vm/object.h"
+#include "vm/object_store.h"
+#include "vm/timeline.h"
+#include "vm/version.h"
+#include "vm/zone_text_buffer.h"
+
+namespace dart {
+
+DEFINE_FLAG(charp,
+            write_type_feedback,
+            nullptr,
+            "Record the receiver classes of calls and the edge counters of the "
+            "executed functions in this file on exit, for use by the AOT "
+            "compiler.");
+DEFINE_FLAG(charp,
+            type_feedback,
+            nullptr,
+            "Precompile using the type feedback recorded in this file with "
+            "--write_type_feedback.");
+
+// The file starts with the header and the snapshot hash of the VM, followed
+// by tab separated lines. Each function line
+//
+//   F <url> <class> <function> <token pos> <edge counts>
+//
+// is followed by a line for each of its executed instance calls
+//
+//   C <token pos> <selector> (<url> <class> <count>)*
+//
+// The edge counts are separated by commas.
+static constexpr const char* kHeader = "# dart-type-feedback ";
+static constexpr const char* kTopLevelClassName = "::";
+static constexpr const char* kFunctionTag = "F";
+static constexpr const char* kCallTag = "C";
+static constexpr intptr_t kNumFunctionFields = 6;
+static constexpr intptr_t kNumCallFields = 3;
+static constexpr intptr_t kNumReceiverFields = 3;
+
+uword TypeFeedback::FunctionKeyValueTrait::Hash(const Key& key) {
+  ASSERT(key != nullptr);
+  return Utils::StringHash(key, strlen(key));
+}
+
+bool TypeFeedback::FunctionKeyValueTrait::IsKeyEqual(const Pair& kv,
+                                                     const Key& key) {
+  ASSERT(kv.key != nullptr && key != nullptr);
+  return kv.key == key || strcmp(kv.key, key) == 0;
+}
+
+static const char* NameOf(Zone* zone, const String& name) {
+  return String::Handle(zone, String::RemovePrivateKey(name)).ToCString();
+}
+
+// Dynamic invocation forwarders are called with the selector of the method
+// they forward to.
+static const char* SelectorOf(Zone* zone, const String& name) {
+  auto& selector = String::Handle(zone, name.ptr());
+  if (Function::IsDynamicInvocationForwarderName(selector)) {
+    selector = Function::DemangleDynamicInvocationForwarderName(selector);
+  }
+  return NameOf(zone, selector);
+}
+
+// Returns "<url>\t<class>", or nullptr if the class has no library.
+static const char* ClassKey(Zone* zone, const Class& cls) {
+  const auto& lib = Library::Handle(zone, cls.library());
+  if (lib.IsNull()) return nullptr;
+  const char* url = String::Handle(zone, lib.url()).ToCString();
+  if (cls.IsTopLevel()) {
+    return zone->PrintToString("%s\t%s", url, kTopLevelClassName);
+  }
+  return zone->PrintToString("%s\t%s", url,
+                             NameOf(zone, String::Handle(zone, cls.Name())));
+}
+
+// Returns "<url>\t<class>\t<function>\t<token pos>", or nullptr if the owner
+// of the function has no library. Closures are named by their token position.
+static const char* FunctionKey(Zone* zone, const Function& function) {
+  const char* class_key =
+      ClassKey(zone, Class::Handle(zone, function.Owner()));
+  if (class_key == nullptr) return nullptr;
+  return zone->PrintToString(
+      "%s\t%s\t%" Pd32, class_key,
+      NameOf(zone, String::Handle(zone, function.name())),
+      function.token_pos().Serialize());
+}
+
+static void WriteFunction(Thread* thread,
+                          const Function& function,
+                          BaseTextBuffer* buffer) {
+  StackZone stack_zone(thread);
+  Zone* zone = stack_zone.GetZone();
+  const auto& ic_data_array = Array::Handle(zone, function.ic_data_array());
+  const auto& code = Code::Handle(zone, function.unoptimized_code());
+  if (ic_data_array.IsNull() || code.IsNull()) return;
+  const char* key = FunctionKey(zone, function);
+  if (key == nullptr) return;
+
+  bool executed = false;
+  ZoneTextBuffer edge_counts(zone);
+  auto& edge_counters = Array::Handle(zone);
+  edge_counters ^=
+      ic_data_array.At(Function::ICDataArrayIndices::kEdgeCounters);
+  if (!edge_counters.IsNull()) {
+    for (intptr_t i = 0; i < edge_counters.Length(); i++) {
+      const intptr_t count = Smi::Value(Smi::RawCast(edge_counters.At(i)));
+      if (i > 0) edge_counts.AddChar(',');
+      edge_counts.Printf("%" Pd, count);
+      executed = executed || (count > 0);
+    }
+  }
+
+  // Deopt ids differ between the JIT and AOT flow graphs of a function, so
+  // calls are identified by their token position instead.
+  IntMap<intptr_t> token_positions(zone);
+  const auto& descriptors =
+      PcDescriptors::Handle(zone, code.pc_descriptors());
+  PcDescriptors::Iterator iter(descriptors, UntaggedPcDescriptors::kIcCall);
+  while (iter.MoveNext()) {
+    token_positions.Insert(iter.DeoptId(), iter.TokenPos().Serialize());
+  }
+
+  ZoneTextBuffer calls(zone);
+  ClassTable* class_table = thread->isolate_group()->class_table();
+  auto& ic_data = ICData::Handle(zone);
+  auto& cls = Class::Handle(zone);
+  GrowableArray<intptr_t> cids;
+  GrowableArray<intptr_t> cid_counts;
+  for (intptr_t i = Function::ICDataArrayIndices::kFirstICData;
+       i < ic_data_array.Length(); i++) {
+    ic_data ^= ic_data_array.At(i);
+    if (ic_data.rebind_rule() != ICData::kInstance) continue;
+    auto* token_pos = token_positions.LookupPair(ic_data.deopt_id());
+    if (token_pos == nullptr) continue;
+
+    // Calls checking two arguments have an entry per pair of classes.
+    cids.Clear();
+    cid_counts.Clear();
+    for (intptr_t j = 0, n = ic_data.NumberOfChecks(); j < n; j++) {
+      const intptr_t count = ic_data.GetCountAt(j);
+      if (count == 0) continue;
+      const intptr_t cid = ic_data.GetReceiverClassIdAt(j);
+      intptr_t k = 0;
+      while (k < cids.length() && cids[k] != cid) {
+        k++;
+      }
+      if (k == cids.length()) {
+        cids.Add(cid);
+        cid_counts.Add(0);
+      }
+      cid_counts[k] += count;
+    }
+    if (cids.is_empty()) continue;
+
+    calls.Printf("%s\t%" Pd "\t%s", kCallTag, token_pos->value,
+                 SelectorOf(zone, String::Handle(zone, ic_data.target_name())));
+    for (intptr_t k = 0; k < cids.length(); k++) {
+      cls = class_table->At(cids[k]);
+      const char* class_key = ClassKey(zone, cls);
+      if (class_key == nullptr) continue;
+      calls.Printf("\t%s\t%" Pd, class_key, cid_counts[k]);
+    }
+    calls.AddChar('\n');
+    executed = true;
+  }
+
+  if (!executed) return;
+  buffer->Printf("%s\t%s\t%s\n", kFunctionTag, key, edge_counts.buffer());
+  buffer->AddString(calls.buffer());
+}
+
+void TypeFeedback::Write(Thread* thread, BaseTextBuffer* buffer) {
+  Zone* zone = thread->zone();
+  buffer->Printf("%s%s\n", kHeader, Version::SnapshotString());
+
+  const auto& libraries = GrowableObjectArray::Handle(
+      zone, thread->isolate_group()->object_store()->libraries());
+  auto& lib = Library::Handle(zone);
+  auto& cls = Class::Handle(zone);
+  auto& functions = Array::Handle(zone);
+  auto& function = Function::Handle(zone);
+  for (intptr_t i = 0; i < libraries.Length(); i++) {
+    lib ^= libraries.At(i);
+    ClassDictionaryIterator it(lib, ClassDictionaryIterator::kIteratePrivate);
+    while (it.HasNext()) {
+      cls = it.GetNextClass();
+      if (!cls.is_finalized()) continue;
+      functions = cls.current_functions();
+      for (intptr_t j = 0; j < functions.Length(); j++) {
+        function ^= functions.At(j);
+        WriteFunction(thread, function, buffer);
+      }
+    }
+  }
+  ClosureFunctionsCache::ForAllClosureFunctions([&](const Function& closure) {
+    WriteFunction(thread, closure, buffer);
+    return true;  // Continue iteration.
+  });
+}
+
+void TypeFeedback::Save(Thread* thread) {
+  if (FLAG_write_type_feedback == nullptr) return;
+  auto file_open = Dart::file_open_callback();
+  auto file_write = Dart::file_write_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_write == nullptr) ||
+      (file_close == nullptr)) {
+    OS::PrintErr("warning: Could not access file callbacks.");
+    return;
+  }
+
+  TIMELINE_DURATION(thread, Compiler, "SaveTypeFeedback");
+  ZoneTextBuffer buffer(thread->zone());
+  Write(thread, &buffer);
+
+  void* file = file_open(FLAG_write_type_feedback, /*write=*/true);
+  if (file == nullptr) {
+    OS::PrintErr("warning: Failed to write type feedback: %s\n",
+                 FLAG_write_type_feedback);
+    return;
+  }
+  file_write(buffer.buffer(), buffer.length(), file);
+  file_close(file);
+}
+
+TypeFeedback* TypeFeedback::Load(Thread* thread) {
+  if (FLAG_type_feedback == nullptr) return nullptr;
+  auto file_open = Dart::file_open_callback();
+  auto file_read = Dart::file_read_callback();
+  auto file_close = Dart::file_close_callback();
+  if ((file_open == nullptr) || (file_read == nullptr) ||
+      (file_close == nullptr)) {
+    OS::PrintErr("warning: Could not access file callbacks.");
+    return nullptr;
+  }
+  void* file = file_open(FLAG_type_feedback, /*write=*/false);
+  if (file == nullptr) {
+    OS::PrintErr("warning: Failed to read type feedback: %s\n",
+                 FLAG_type_feedback);
+    return nullptr;
+  }
+  uint8_t* data = nullptr;
+  intptr_t length = -1;
+  file_read(&data, &length, file);
+  file_close(file);
+  if (data == nullptr || length < 0) return nullptr;
+
+  TIMELINE_DURATION(thread, Compiler, "LoadTypeFeedback");
+  TypeFeedback* feedback =
+      Parse(thread, reinterpret_cast<const char*>(data), length);
+  free(data);
+  if (feedback == nullptr) {
+    OS::PrintErr("warning: Ignoring type feedback %s from a different VM\n",
+                 FLAG_type_feedback);
+  }
+  return feedback;
+}
+
+namespace {
+
+struct TextField {
+  const char* start;
+  intptr_t length;
+};
+
+}  // namespace
+
+static void SplitFields(const char* line,
+                        intptr_t length,
+                        GrowableArray<TextField>* fields) {
+  fields->Clear();
+  intptr_t start = 0;
+  for (intptr_t i = 0; i <= length; i++) {
+    if (i < length && line[i] != '\t') continue;
+    fields->Add({line + start, i - start});
+    start = i + 1;
+  }
+}
+
+static bool IsTag(const TextField& field, const char* tag) {
+  return field.length == 1 && field.start[0] == tag[0];
+}
+
+// Parses the decimal number at the start of [field]. The contents need not
+// be NUL-terminated, the last field of a file without a trailing newline
+// ends the buffer.
+static intptr_t ParseInteger(const TextField& field) {
+  intptr_t i = 0;
+  const bool negative = field.length > 0 && field.start[0] == '-';
+  if (negative) i++;
+  intptr_t value = 0;
+  for (; i < field.length && Utils::IsDecimalDigit(field.start[i]); i++) {
+    value = value * 10 + (field.start[i] - '0');
+  }
+  return negative ? -value : value;
+}
+
+static StringPtr ToString(const TextField& field) {
+  return String::FromUTF8(reinterpret_cast<const uint8_t*>(field.start),
+                          field.length);
+}
+
+// Returns the id of the class [name] of library [url], or kIllegalCid if
+// there is no such class. [class_ids] caches the classes resolved so far by
+// their "<url>\t<class>" key.
+static intptr_t ResolveClass(Thread* thread,
+                             CStringIntMap* class_ids,
+                             const char* class_key,
+                             const TextField& url,
+                             const TextField& name) {
+  const intptr_t known = class_ids->LookupValue(class_key);
+  if (known != CStringIntMapKeyValueTrait::kNoValue) return known;
+
+  Zone* zone = thread->zone();
+  intptr_t cid = kIllegalCid;
+  const auto& lib = Library::Handle(
+      zone, Library::LookupLibrary(thread, String::Handle(zone, ToString(url))));
+  if (!lib.IsNull()) {
+    const auto& cls = Class::Handle(
+        zone,
+        lib.LookupClassAllowPrivate(String::Handle(zone, ToString(name))));
+    if (!cls.IsNull() && cls.is_finalized()) {
+      cid = cls.id();
+    }
+  }
+  class_ids->Insert({class_key, cid});
+  return cid;
+}
+
+static int MostFrequentFirst(const TypeFeedback::Receiver* a,
+                             const TypeFeedback::Receiver* b) {
+  if (a->count != b->count) return a->count > b->count ? -1 : 1;
+  return a->cid < b->cid ? -1 : (a->cid > b->cid ? 1 : 0);
+}
+
+TypeFeedback* TypeFeedback::Parse(Thread* thread,
+                                  const char* contents,
+                                  intptr_t length) {
+  Zone* zone = thread->zone();
+  const char* end = contents + length;
+
+  // The feedback is only valid for the VM that wrote it.
+  const char* version = Version::SnapshotString();
+  const intptr_t header_length = strlen(kHeader);
+  const intptr_t version_length = strlen(version);
+  if (length < header_length + version_length + 1 ||
+      strncmp(contents, kHeader, header_length) != 0 ||
+      strncmp(contents + header_length, version, version_length) != 0 ||
+      contents[header_length + version_length] != '\n') {
+    return nullptr;
+  }
+
+  auto* feedback = new (zone) TypeFeedback(zone);
+  CStringIntMap class_ids(zone);
+  GrowableArray<TextField> fields;
+  FunctionFeedback* current = nullptr;
+  const char* line = contents + header_length + version_length + 1;
+  while (line < end) {
+    const char* line_end =
+        reinterpret_cast<const char*>(memchr(line, '\n', end - line));
+    if (line_end == nullptr) line_end = end;
+    SplitFields(line, line_end - line, &fields);
+
+    if (fields.length() == kNumFunctionFields &&
+        IsTag(fields[0], kFunctionTag)) {
+      const TextField& counts = fields[kNumFunctionFields - 1];
+      const char* key = zone->MakeCopyOfStringN(
+          fields[1].start, counts.start - 1 - fields[1].start);
+      current = nullptr;
+      if (!feedback->functions_.HasKey(key)) {
+        current = new (zone) FunctionFeedback();
+        current->edge_counts = new (zone) ZoneGrowableArray<intptr_t>(zone, 8);
+        current->calls = new (zone) ZoneGrowableArray<CallSite>(zone, 4);
+        for (intptr_t i = 0; i < counts.length; i++) {
+          if (i == 0 || counts.start[i - 1] == ',') {
+            current->edge_counts->Add(
+                ParseInteger({counts.start + i, counts.length - i}));
+          }
+        }
+        feedback->functions_.Insert({key, current});
+        feedback->num_functions_++;
+      }
+    } else if (current != nullptr && fields.length() >= kNumCallFields &&
+               (fields.length() - kNumCallFields) % kNumReceiverFields == 0 &&
+               IsTag(fields[0], kCallTag)) {
+      CallSite call;
+      call.token_pos = static_cast<int32_t>(ParseInteger(fields[1]));
+      call.selector =
+          zone->MakeCopyOfStringN(fields[2].start, fields[2].length);
+      call.count = 0;
+      call.receivers = new (zone) ZoneGrowableArray<Receiver>(zone, 2);
+      for (intptr_t i = kNumCallFields; i < fields.length();
+           i += kNumReceiverFields) {
+        const TextField& url = fields[i];
+        const TextField& name = fields[i + 1];
+        const intptr_t count = ParseInteger(fields[i + 2]);
+        const char* class_key = zone->MakeCopyOfStringN(
+            url.start, name.start + name.length - url.start);
+        const intptr_t cid =
+            ResolveClass(thread, &class_ids, class_key, url, name);
+        call.count += count;
+        if (cid != kIllegalCid && count > 0) {
+          call.receivers->Add({cid, count});
+        }
+      }
+      call.receivers->Sort(MostFrequentFirst);
+      current->calls->Add(call);
+      feedback->num_calls_++;
+    }
+    line = line_end + 1;
+  }
+  return feedback;
+}
+
+const TypeFeedback::FunctionFeedback* TypeFeedback::Lookup(
+    const Function& function) const {
+  const char* key = FunctionKey(Thread::Current()->zone(), function);
+  if (key == nullptr) return nullptr;
+  return functions_.LookupValue(key);
+}
+
+const TypeFeedback::CallSite* TypeFeedback::LookupCall(
+    const FunctionFeedback& feedback,
+    TokenPosition token_pos,
+    const String& selector) const {
+  const int32_t pos = token_pos.Serialize();
+  const char* name = nullptr;
+  for (const CallSite& call : *feedback.calls) {
+    if (call.token_pos != pos) continue;
+    if (name == nullptr) {
+      name = SelectorOf(Thread::Current()->zone(), selector);
+    }
+    if (strcmp(call.selector, name) == 0) {
+      return &call;
+    }
+  }
+  return nullptr;
+}
+
+ArrayPtr TypeFeedback::EdgeCounters(const Function& function,
+                                    intptr_t num_blocks) const {
+  const FunctionFeedback* feedback = Lookup(function);
+  if (feedback == nullptr || feedback->edge_counts->length() != num_blocks) {
+    return Array::null();
+  }
+  const auto& counters = Array::Handle(Array::New(num_blocks, Heap::kOld));
+  for (intptr_t i = 0; i < num_blocks; i++) {
+    counters.SetAt(i, Smi::Handle(Smi::New(feedback->edge_counts->At(i))));
+  }
+  return counters.ptr();
+}
+
+intptr_t TypeFeedback::ExecutedBlockCount(const Function& function) const {
+  const FunctionFeedback* feedback = Lookup(function);
+  if (feedback == nullptr) return 0;
+  intptr_t count = 0;
+  for (intptr_t edge_count : *feedback->edge_counts) {
+    count += edge_count;
+  }
+  return count;
+}
+
+namespace {
+
+// Functions are hashed by their token position, which unlike their name is
+// not changed by obfuscation.
+struct ExecutedBlockCountTraits {
+  static uint32_t Hash(const Object& key) {
+    return Function::Cast(key).token_pos().Hash();
+  }
+  static const char* Name() { return "ExecutedBlockCountTraits"; }
+  static bool IsMatch(const Object& a, const Object& b) {
+    return a.ptr() == b.ptr();
+  }
+  static bool ReportStats() { return false; }
+};
+
+using ExecutedBlockCountMap = UnorderedHashMap<ExecutedBlockCountTraits>;
+
+}  // namespace
+
+ArrayPtr TypeFeedback::ExecutedBlockCounts(
+    const GrowableArray<const Function*>& functions) const {
+  ExecutedBlockCountMap map(
+      HashTables::New<ExecutedBlockCountMap>(functions.length(), Heap::kOld));
+  auto& count = Smi::Handle();
+  for (const Function* function : functions) {
+    const intptr_t executed = ExecutedBlockCount(*function);
+    if (executed == 0) continue;
+    count = Smi::New(Utils::Minimum<intptr_t>(executed, Smi::kMaxValue));
+    map.UpdateOrInsert(*function, count);
+  }
+  return map.Release().ptr();
+}
+
+intptr_t TypeFeedback::LookupExecutedBlockCount(const Array& counts,
+                                                const Function& function) {
+  ExecutedBlockCountMap map(counts.ptr());
+  const ObjectPtr count = map.GetOrNull(function);
+  map.Release();
+  return count == Object::null() ? 0 : Smi::Value(Smi::RawCast(count));
+}
+
+}  // namespace dart
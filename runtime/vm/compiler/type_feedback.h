@@ -0,0 +1,154 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_COMPILER_TYPE_FEEDBACK_H_
+#define RUNTIME_VM_COMPILER_TYPE_FEEDBACK_H_
+
+#if defined(DART_PRECOMPILED_RUNTIME)
+#error "AOT runtime should not use compiler sources (including header files)"
+#endif  // defined(DART_PRECOMPILED_RUNTIME)
+
+#include "vm/allocation.h"
+#include "vm/growable_array.h"
+#include "vm/hash_map.h"
+#include "vm/tagged_pointer.h"
+#include "vm/token_position.h"
+
+namespace dart {
+
+class Array;
+class BaseTextBuffer;
+class Function;
+class String;
+class Thread;
+
+// Type feedback collected by a JIT run of a program, for use by the AOT
+// compiler of the same program.
+//
+// When --write_type_feedback=<file> is given, the JIT records for every
+// function it has executed the edge counters of its unoptimized code and the
+// receiver classes seen by each of its instance calls, together with their
+// counts. The file is written when the last isolate of a group shuts down.
+//
+// When the precompiler is given the file with --type_feedback=<file>, it
+//
+//   - turns dynamic calls whose receivers were dominated by a few classes
+//     into polymorphic calls, so their hot targets are inlined behind class
+//     id checks with a fallback call for all other receivers,
+//   - assigns edge weights to the blocks of functions whose flow graph has
+//     the same shape as in the JIT, so the block scheduler can move branches
+//     which were never taken out of the hot path.
+//
+// Functions are identified by library, class, name and token position, and
+// classes by library and name. Names are stored without their library
+// private key. Feedback which no longer matches the program is harmless:
+// call sites whose receivers changed still reach their targets through the
+// fallback call, and edge counters are only used if the number of blocks is
+// unchanged.
+class TypeFeedback : public ZoneAllocated {
+ public:
+  struct Receiver {
+    intptr_t cid;
+    intptr_t count;
+  };
+
+  struct CallSite {
+    int32_t token_pos;
+    const char* selector;
+    // The number of calls with any receiver, including receivers whose class
+    // no longer exists.
+    intptr_t count;
+    // The receiver classes which exist in the program, most frequent first.
+    ZoneGrowableArray<Receiver>* receivers;
+  };
+
+  struct FunctionFeedback : public ZoneAllocated {
+    // Edge counters of the unoptimized code, indexed by block preorder
+    // number.
+    ZoneGrowableArray<intptr_t>* edge_counts;
+    ZoneGrowableArray<CallSite>* calls;
+  };
+
+  // Records the type feedback of the current isolate group in the file given
+  // by --write_type_feedback, if any.
+  static void Save(Thread* thread);
+
+  // Writes the type feedback of the current isolate group to [buffer].
+  static void Write(Thread* thread, BaseTextBuffer* buffer);
+
+  // Reads the file given by --type_feedback. Returns nullptr if there is no
+  // such file or it was written by a different VM.
+  static TypeFeedback* Load(Thread* thread);
+
+  // Parses type feedback written by [Write]. Allocates in the zone of
+  // [thread], and resolves receiver classes in its isolate group.
+  static TypeFeedback* Parse(Thread* thread,
+                             const char* contents,
+                             intptr_t length);
+
+  // The feedback of [function], or nullptr if it was not executed.
+  const FunctionFeedback* Lookup(const Function& function) const;
+
+  // The feedback of the call of [selector] at [token_pos] in the function
+  // with [feedback], or nullptr if it was not executed.
+  const CallSite* LookupCall(const FunctionFeedback& feedback,
+                             TokenPosition token_pos,
+                             const String& selector) const;
+
+  // Returns the edge counters of [function] as an array of Smis if its
+  // unoptimized flow graph had [num_blocks] blocks, or null otherwise.
+  ArrayPtr EdgeCounters(const Function& function, intptr_t num_blocks) const;
+
+  // The number of blocks executed by [function], or 0 if it was not
+  // executed. Functions which were optimized by the JIT stop counting, so
+  // this only separates the hot functions from the others.
+  intptr_t ExecutedBlockCount(const Function& function) const;
+
+  // Returns a map from the functions in [functions] which were executed to
+  // their [ExecutedBlockCount]. Unlike the feedback, the map remains valid
+  // after the names of the functions are obfuscated, and can be read without
+  // allocating (see [LookupExecutedBlockCount]).
+  ArrayPtr ExecutedBlockCounts(
+      const GrowableArray<const Function*>& functions) const;
+
+  // The count of [function] in [counts], a map built by
+  // [ExecutedBlockCounts], or 0 if it has none.
+  static intptr_t LookupExecutedBlockCount(const Array& counts,
+                                           const Function& function);
+
+  intptr_t num_functions() const { return num_functions_; }
+  intptr_t num_calls() const { return num_calls_; }
+
+ private:
+  struct FunctionKeyValueTrait {
+    using Key = const char*;
+    using Value = FunctionFeedback*;
+
+    struct Pair {
+      Key key;
+      Value value;
+      Pair() : key(nullptr), value(nullptr) {}
+      Pair(const Key key, const Value& value) : key(key), value(value) {}
+      Pair(const Pair& other) : key(other.key), value(other.value) {}
+      Pair& operator=(const Pair&) = default;
+    };
+
+    static Key KeyOf(const Pair& pair) { return pair.key; }
+    static Value ValueOf(const Pair& pair) { return pair.value; }
+    static uword Hash(const Key& key);
+    static bool IsKeyEqual(const Pair& kv, const Key& key);
+  };
+
+  explicit TypeFeedback(Zone* zone) : functions_(zone) {}
+
+  DirectChainedHashMap<FunctionKeyValueTrait> functions_;
+  intptr_t num_functions_ = 0;
+  intptr_t num_calls_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(TypeFeedback);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_COMPILER_TYPE_FEEDBACK_H_
@@ -0,0 +1,148 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/compiler/type_feedback.h"
+
+#include "vm/compiler/backend/il_test_helper.h"
+#include "vm/object.h"
+#include "vm/unit_test.h"
+#include "vm/zone_text_buffer.h"
+
+namespace dart {
+
+ISOLATE_UNIT_TEST_CASE(TypeFeedback_WriteAndParse) {
+  const char* kScript = R"(
+    abstract class A {
+      int m();
+    }
+    class B extends A {
+      int m() => 1;
+    }
+    class C extends A {
+      int m() => 2;
+    }
+    @pragma('vm:never-inline')
+    int foo(A a) => a.m();
+    main() {
+      final b = B();
+      final c = C();
+      int sum = 0;
+      for (int i = 0; i < 30; i++) {
+        sum += foo(i % 3 == 0 ? c : b);
+      }
+      return sum;
+    }
+  )";
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+
+  ZoneTextBuffer buffer(thread->zone());
+  TypeFeedback::Write(thread, &buffer);
+  TypeFeedback* feedback =
+      TypeFeedback::Parse(thread, buffer.buffer(), buffer.length());
+  EXPECT(feedback != nullptr);
+  EXPECT(feedback->num_functions() > 0);
+
+  const auto& foo = Function::Handle(GetFunction(root_library, "foo"));
+  const auto* foo_feedback = feedback->Lookup(foo);
+  EXPECT(foo_feedback != nullptr);
+  EXPECT(foo_feedback->edge_counts->length() > 0);
+  EXPECT(feedback->ExecutedBlockCount(foo) >= 30);
+  EXPECT_EQ(1, foo_feedback->calls->length());
+
+  const TypeFeedback::CallSite& call = foo_feedback->calls->At(0);
+  EXPECT_STREQ("m", call.selector);
+  EXPECT_EQ(30, call.count);
+  EXPECT_EQ(2, call.receivers->length());
+  const auto& b = Class::Handle(GetClass(root_library, "B"));
+  const auto& c = Class::Handle(GetClass(root_library, "C"));
+  EXPECT_EQ(b.id(), call.receivers->At(0).cid);
+  EXPECT_EQ(20, call.receivers->At(0).count);
+  EXPECT_EQ(c.id(), call.receivers->At(1).cid);
+  EXPECT_EQ(10, call.receivers->At(1).count);
+
+  const auto& selector = String::Handle(String::New("m"));
+  EXPECT(feedback->LookupCall(*foo_feedback,
+                              TokenPosition::Deserialize(call.token_pos),
+                              selector) == &call);
+  const auto& other_selector = String::Handle(String::New("n"));
+  EXPECT(feedback->LookupCall(*foo_feedback,
+                              TokenPosition::Deserialize(call.token_pos),
+                              other_selector) == nullptr);
+
+  // Edge counters are only used for flow graphs of the same shape.
+  const intptr_t num_blocks = foo_feedback->edge_counts->length();
+  EXPECT(feedback->EdgeCounters(foo, num_blocks) != Array::null());
+  EXPECT(feedback->EdgeCounters(foo, num_blocks + 1) == Array::null());
+}
+
+ISOLATE_UNIT_TEST_CASE(TypeFeedback_ParseWithoutTrailingNewline) {
+  const char* kScript = R"(
+    class B {
+      int m() => 1;
+    }
+    class C {
+      int m() => 2;
+    }
+    @pragma('vm:never-inline')
+    int foo(dynamic a) => a.m();
+    main() {
+      final b = B();
+      final c = C();
+      int sum = 0;
+      for (int i = 0; i < 30; i++) {
+        sum += foo(i % 3 == 0 ? c : b);
+      }
+      return sum;
+    }
+  )";
+  const auto& root_library = Library::Handle(LoadTestScript(kScript));
+  Invoke(root_library, "main");
+
+  ZoneTextBuffer buffer(thread->zone());
+  TypeFeedback::Write(thread, &buffer);
+  const char* contents = buffer.buffer();
+
+  // Keep the header and the lines of foo, which end with the count of its
+  // last receiver.
+  const char* header_end = strchr(contents, '\n') + 1;
+  const char* foo_start = strstr(contents, "\tfoo\t");
+  EXPECT(foo_start != nullptr);
+  while (foo_start[-1] != '\n') foo_start--;
+  const char* foo_end = strstr(foo_start + 1, "\nF\t");
+  if (foo_end == nullptr) foo_end = contents + buffer.length() - 1;
+  EXPECT_EQ('\n', *foo_end);
+
+  // Digits after the end of the contents must not be read.
+  const intptr_t header_length = header_end - contents;
+  const intptr_t foo_length = foo_end - foo_start;
+  const intptr_t length = header_length + foo_length;
+  char* truncated = thread->zone()->Alloc<char>(length + 8);
+  memmove(truncated, contents, header_length);
+  memmove(truncated + header_length, foo_start, foo_length);
+  memset(truncated + length, '9', 8);
+
+  TypeFeedback* feedback = TypeFeedback::Parse(thread, truncated, length);
+  EXPECT(feedback != nullptr);
+  EXPECT_EQ(1, feedback->num_functions());
+  const auto& foo = Function::Handle(GetFunction(root_library, "foo"));
+  const auto* foo_feedback = feedback->Lookup(foo);
+  EXPECT(foo_feedback != nullptr);
+  EXPECT_EQ(1, foo_feedback->calls->length());
+  const TypeFeedback::CallSite& call = foo_feedback->calls->At(0);
+  EXPECT_EQ(30, call.count);
+  EXPECT_EQ(2, call.receivers->length());
+  EXPECT_EQ(20, call.receivers->At(0).count);
+  EXPECT_EQ(10, call.receivers->At(1).count);
+}
+
+ISOLATE_UNIT_TEST_CASE(TypeFeedback_RejectsOtherVersions) {
+  const char* kFeedback =
+      "# dart-type-feedback 0123456789abcdef\n"
+      "F\tfile:///test.dart\t::\tfoo\t10\t1,1\n";
+  EXPECT(TypeFeedback::Parse(thread, kFeedback, strlen(kFeedback)) ==
+         nullptr);
+}
+
+}  // namespace dart
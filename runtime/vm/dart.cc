@@ -961,8 +961,20 @@ ErrorPtr Dart::InitializeIsolate(Thread* T,
   //   * after this block it will add the new static field to this isolate.
   {
     SafepointReadRwLocker reader(T, IG->program_lock());
-    I->set_field_table(T, IG->initial_field_table()->Clone(I));
+#if defined(SUPPORT_TIMELINE)
+    TimelineBeginEndScope tbes(T, Timeline::GetIsolateStream(),
+                               "CloneFieldTable");
+#endif
+    bool reused_storage = false;
+    I->set_field_table(T, IG->field_table_pool()->Clone(
+                              IG->initial_field_table(), I, &reused_storage));
     I->field_table()->MarkReadyToUse();
+#if defined(SUPPORT_TIMELINE)
+    tbes.SetNumArguments(2);
+    tbes.FormatArgument(0, "fieldCount", "%" Pd,
+                        I->field_table()->NumFieldIds());
+    tbes.CopyArgument(1, "reusedStorage", reused_storage ? "true" : "false");
+#endif
   }
 
   const auto& out_of_memory =
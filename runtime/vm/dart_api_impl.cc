@@ -58,6 +58,7 @@
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
 #include "vm/compiler/aot/precompiler.h"
+#include "vm/compiler/jit/warmup_cache.h"
 #include "vm/kernel_loader.h"
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
 
@@ -5808,6 +5809,10 @@ DART_EXPORT Dart_Handle Dart_FinalizeLoading(bool complete_futures) {
     ASSERT(!dirty_bit.IsNull() && dirty_bit.is_static());
     dirty_bit.SetStaticValue(Bool::True());
   }
+
+  if (!Isolate::IsSystemIsolate(I)) {
+    JitWarmupCache::Load(T);
+  }
 #endif
 
   return Api::Success();
@@ -6730,6 +6735,39 @@ static void DropRegExpMatchCode(Zone* zone) {
   ASSERT(!func.HasCode());
 }
 
+
+// OSR code is entered only from the loops of the run that compiled it, with
+// entries specialized on the classes of the values live there, and is not
+// installed on its function. Drop the OSR code caches instead of carrying that
+// code in app-JIT snapshots; loops still OSR when the snapshot runs.
+static void DropOsrCode(Thread* thread) {
+  class DropOsrCodeVisitor : public FunctionVisitor {
+   public:
+    explicit DropOsrCodeVisitor(Zone* zone)
+        : ic_data_array_(Array::Handle(zone)) {}
+
+    void VisitFunction(const Function& function) {
+      ic_data_array_ = function.ic_data_array();
+      if (ic_data_array_.IsNull() ||
+          ic_data_array_.Length() <= Function::ICDataArrayIndices::kOsrCode ||
+          ic_data_array_.At(Function::ICDataArrayIndices::kOsrCode) ==
+              Object::null()) {
+        return;
+      }
+      ic_data_array_.SetAt(Function::ICDataArrayIndices::kOsrCode,
+                           Object::null_object());
+    }
+
+   private:
+    Array& ic_data_array_;
+  };
+
+  auto const isolate_group = thread->isolate_group();
+  SafepointWriteRwLocker ml(thread, isolate_group->program_lock());
+  StackZone stack_zone(thread);
+  DropOsrCodeVisitor visitor(thread->zone());
+  ProgramVisitor::WalkProgram(thread->zone(), isolate_group, &visitor);
+}
 #endif  // (!defined(TARGET_ARCH_IA32) && !defined(DART_PRECOMPILED_RUNTIME))
 
 #if !defined(TARGET_ARCH_IA32) && !defined(DART_PRECOMPILED_RUNTIME)
@@ -6786,6 +6824,7 @@ Dart_CreateAppJITSnapshotAsBlobs(uint8_t** isolate_snapshot_data_buffer,
 
   NoBackgroundCompilerScope no_bg_compiler(T);
   DropRegExpMatchCode(Z);
+  DropOsrCode(T);
 
   ProgramVisitor::Dedup(T);
 
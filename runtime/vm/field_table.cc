@@ -8,6 +8,7 @@
 #include "vm/flags.h"
 #include "vm/growable_array.h"
 #include "vm/heap/heap.h"
+#include "vm/lockers.h"
 #include "vm/object.h"
 #include "vm/object_graph.h"
 #include "vm/object_store.h"
@@ -154,6 +155,40 @@ FieldTable* FieldTable::Clone(Isolate* for_isolate,
   return clone;
 }
 
+FieldTable* FieldTable::CloneInto(Isolate* for_isolate,
+                                  ObjectPtr* storage,
+                                  intptr_t storage_capacity) {
+  DEBUG_ASSERT(
+      IsolateGroup::Current()->program_lock()->IsCurrentThreadReader());
+
+  if (storage == nullptr || storage_capacity < capacity_) {
+    free(storage);
+    return Clone(for_isolate);
+  }
+
+  FieldTable* clone = new FieldTable(for_isolate);
+  memmove(storage, table_, capacity_ * sizeof(ObjectPtr));  // NOLINT
+  // Unused slots have to be cleared, see [AllocateIndex].
+  for (intptr_t i = capacity_; i < storage_capacity; i++) {
+    storage[i] = ObjectPtr();
+  }
+  clone->table_ = storage;
+  clone->capacity_ = storage_capacity;
+  clone->top_ = top_;
+  clone->free_head_ = free_head_;
+  return clone;
+}
+
+ObjectPtr* FieldTable::DetachStorage(intptr_t* capacity) {
+  ObjectPtr* storage = table_;
+  *capacity = capacity_;
+  table_ = nullptr;
+  capacity_ = 0;
+  top_ = 0;
+  free_head_ = -1;
+  return storage;
+}
+
 void FieldTable::VisitObjectPointers(ObjectPointerVisitor* visitor) {
   // GC might try to visit field table before it's isolate done setting it up.
   if (table_ == nullptr) {
@@ -166,4 +201,46 @@ void FieldTable::VisitObjectPointers(ObjectPointerVisitor* visitor) {
   visitor->clear_gc_root_type();
 }
 
+FieldTablePool::~FieldTablePool() {
+  for (intptr_t i = 0; i < storages_.length(); i++) {
+    free(storages_[i].table);
+  }
+}
+
+FieldTable* FieldTablePool::Clone(FieldTable* initial_field_table,
+                                  Isolate* for_isolate,
+                                  bool* reused) {
+  ObjectPtr* storage = nullptr;
+  intptr_t capacity = 0;
+  {
+    MutexLocker ml(&mutex_);
+    if (storages_.length() > 0) {
+      const Storage pooled = storages_.RemoveLast();
+      storage = pooled.table;
+      capacity = pooled.capacity;
+    }
+  }
+  *reused = storage != nullptr && capacity >= initial_field_table->Capacity();
+  if (storage == nullptr) {
+    return initial_field_table->Clone(for_isolate);
+  }
+  return initial_field_table->CloneInto(for_isolate, storage, capacity);
+}
+
+void FieldTablePool::Recycle(FieldTable* field_table) {
+  intptr_t capacity = 0;
+  ObjectPtr* storage = field_table->DetachStorage(&capacity);
+  if (storage == nullptr) {
+    return;
+  }
+  {
+    MutexLocker ml(&mutex_);
+    if (storages_.length() < max_size_) {
+      storages_.Add({storage, capacity});
+      return;
+    }
+  }
+  free(storage);
+}
+
 }  // namespace dart
@@ -12,6 +12,7 @@
 #include "vm/class_id.h"
 #include "vm/globals.h"
 #include "vm/growable_array.h"
+#include "vm/os_thread.h"
 #include "vm/tagged_pointer.h"
 
 namespace dart {
@@ -91,6 +92,17 @@ class FieldTable {
   FieldTable* Clone(Isolate* for_isolate,
                     IsolateGroup* for_isolate_group = nullptr);
 
+  // Like [Clone], but copies the values into [storage] (which has room for
+  // [storage_capacity] values) if it is large enough. Takes ownership of
+  // [storage] in either case.
+  FieldTable* CloneInto(Isolate* for_isolate,
+                        ObjectPtr* storage,
+                        intptr_t storage_capacity);
+
+  // Detaches the backing store from this field table and transfers its
+  // ownership to the caller. The field table is empty afterwards.
+  ObjectPtr* DetachStorage(intptr_t* capacity);
+
   void VisitObjectPointers(ObjectPointerVisitor* visitor);
 
   static constexpr int kInitialCapacity = 512;
@@ -124,6 +136,38 @@ class FieldTable {
   DISALLOW_COPY_AND_ASSIGN(FieldTable);
 };
 
+// Keeps the backing stores of field tables of exited isolates around, so
+// isolates spawned later into the same group can clone the initial field
+// table without allocating (and page-faulting in) a new backing store.
+class FieldTablePool {
+ public:
+  explicit FieldTablePool(intptr_t max_size) : max_size_(max_size) {}
+  ~FieldTablePool();
+
+  // Returns a clone of [initial_field_table] for [for_isolate], reusing a
+  // pooled backing store if one is available. Sets [reused] accordingly.
+  FieldTable* Clone(FieldTable* initial_field_table,
+                    Isolate* for_isolate,
+                    bool* reused);
+
+  // Takes the backing store of [field_table] if the pool is not full.
+  void Recycle(FieldTable* field_table);
+
+  intptr_t size() const { return storages_.length(); }
+
+ private:
+  struct Storage {
+    ObjectPtr* table;
+    intptr_t capacity;
+  };
+
+  Mutex mutex_;
+  MallocGrowableArray<Storage> storages_;
+  const intptr_t max_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(FieldTablePool);
+};
+
 }  // namespace dart
 
 #endif  // RUNTIME_VM_FIELD_TABLE_H_
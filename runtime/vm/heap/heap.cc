@@ -40,6 +40,11 @@ DEFINE_FLAG(bool,
             disable_heap_verification,
             false,
             "Explicitly disable heap verification.");
+DEFINE_FLAG(bool,
+            print_weak_table_stats,
+            false,
+            "Print the sizes, probe lengths and rehash times of the weak "
+            "tables when the heap is destroyed.");
 
 Heap::Heap(IsolateGroup* isolate_group,
            bool is_vm_isolate,
@@ -61,6 +66,10 @@ Heap::Heap(IsolateGroup* isolate_group,
 }
 
 Heap::~Heap() {
+  if (FLAG_print_weak_table_stats) {
+    PrintWeakTableStats();
+  }
+
 #if !defined(PRODUCT) || defined(FORCE_INCLUDE_SAMPLING_HEAP_PROFILER)
   Dart_HeapSamplingDeleteCallback cleanup =
       HeapProfileSampler::delete_callback();
@@ -799,6 +808,41 @@ void Heap::PrintSizes() const {
       (UsedInWords(kOld) / KBInWords), (CapacityInWords(kOld) / KBInWords));
 }
 
+void Heap::PrintWeakTableStats() const {
+  static const char* const kSelectorNames[] = {
+      "peers",
+#if !defined(HASH_IN_OBJECT_HEADER)
+      "identity hashes",
+#endif
+      "canonical hashes",
+      "object ids",
+      "loading units",
+#if !defined(PRODUCT) || defined(FORCE_INCLUDE_SAMPLING_HEAP_PROFILER)
+      "heap sampling data",
+#endif
+  };
+  static_assert(ARRAY_SIZE(kSelectorNames) == kNumWeakSelectors,
+                "Missing weak selector names");
+  for (int sel = 0; sel < kNumWeakSelectors; sel++) {
+    for (Space space : {kNew, kOld}) {
+      const WeakTable* table =
+          GetWeakTable(space, static_cast<WeakSelector>(sel));
+      const WeakTable::ProbeStats stats = table->ComputeProbeStatsExclusive();
+      const double average_probes =
+          stats.entries == 0
+              ? 0.0
+              : static_cast<double>(stats.total_probes) / stats.entries;
+      OS::PrintErr("%s space %s: %" Pd " entries, capacity %" Pd
+                   ", average probe length %.2f, max probe length %" Pd
+                   ", %" Pd " rehashes taking %" Pd64 " us\n",
+                   space == kNew ? "New" : "Old", kSelectorNames[sel],
+                   stats.entries, table->size(),
+                   average_probes, stats.max_probes, table->rehash_count(),
+                   table->rehash_micros());
+    }
+  }
+}
+
 intptr_t Heap::UsedInWords(Space space) const {
   return space == kNew ? new_space_.UsedInWords() : old_space_.UsedInWords();
 }
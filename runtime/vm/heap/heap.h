@@ -141,6 +141,9 @@ class Heap {
   // Print heap sizes.
   void PrintSizes() const;
 
+  // Print the sizes, probe lengths and rehash times of the weak tables.
+  void PrintWeakTableStats() const;
+
   // Return amount of memory used and capacity in a space, excluding external.
   intptr_t UsedInWords(Space space) const;
   intptr_t CapacityInWords(Space space) const;
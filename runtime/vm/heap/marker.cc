@@ -826,6 +826,7 @@ void GCMarker::ProcessWeakTables(Thread* thread) {
 #endif
     WeakTable* table =
         heap_->GetWeakTable(Heap::kOld, static_cast<Heap::WeakSelector>(sel));
+    table->FinishRehashExclusive();
     intptr_t size = table->size();
     for (intptr_t i = 0; i < size; i++) {
       if (table->IsValidEntryAtExclusive(i)) {
@@ -841,6 +842,7 @@ void GCMarker::ProcessWeakTables(Thread* thread) {
     }
     table =
         heap_->GetWeakTable(Heap::kNew, static_cast<Heap::WeakSelector>(sel));
+    table->FinishRehashExclusive();
     size = table->size();
     for (intptr_t i = 0; i < size; i++) {
       if (table->IsValidEntryAtExclusive(i)) {
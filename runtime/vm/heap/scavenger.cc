@@ -1460,6 +1460,7 @@ void Scavenger::MournWeakTables() {
   auto rehash_weak_table = [](WeakTable* table, WeakTable* replacement_new,
                               WeakTable* replacement_old,
                               Dart_HeapSamplingDeleteCallback cleanup) {
+    table->FinishRehashExclusive();
     intptr_t size = table->size();
     for (intptr_t i = 0; i < size; i++) {
       if (table->IsValidEntryAtExclusive(i)) {
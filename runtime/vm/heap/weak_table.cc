@@ -6,6 +6,7 @@
 
 #include "platform/assert.h"
 #include "vm/isolate.h"
+#include "vm/os.h"
 #include "vm/raw_object.h"
 
 namespace dart {
@@ -30,7 +31,29 @@ intptr_t WeakTable::SizeFor(intptr_t count, intptr_t size) {
   return result;
 }
 
+intptr_t* WeakTable::AllocateData(intptr_t size) {
+  intptr_t* data =
+      reinterpret_cast<intptr_t*>(malloc(size * kEntrySize * kWordSize));
+  for (intptr_t i = 0; i < size; i++) {
+    data[i * kEntrySize + kObjectOffset] = kNoEntry;
+    data[i * kEntrySize + kValueOffset] = kNoValue;
+  }
+  return data;
+}
+
 void WeakTable::SetValueExclusive(ObjectPtr key, intptr_t val) {
+  if (IsRehashing()) {
+    MoveEntries(move_step_);
+  }
+  if (IsRehashing()) {
+    // Take the entry of this key out of the previous table, so that it is
+    // updated, added or removed below like any other entry.
+    const intptr_t old_idx = IndexOf(old_data_, old_size_, key);
+    if (old_idx >= 0) {
+      RemoveOldEntry(old_idx);
+    }
+  }
+
   const intptr_t mask = size() - 1;
   intptr_t idx = Hash(key) & mask;
   intptr_t empty_idx = -1;
@@ -67,15 +90,19 @@ void WeakTable::SetValueExclusive(ObjectPtr key, intptr_t val) {
   SetValueAt(idx, val);
   // Update the counts.
   set_used(used() + 1);
-  set_count(count() + 1);
+  set_count(count_ + 1);
 
-  // Rehash if needed to ensure that there are empty slots available.
-  if (used_ >= limit()) {
-    Rehash();
-  }
+  RehashIfNeeded();
 }
 
 bool WeakTable::MarkValueExclusive(ObjectPtr key, intptr_t val) {
+  if (IsRehashing()) {
+    MoveEntries(move_step_);
+  }
+  if (IsRehashing() && (IndexOf(old_data_, old_size_, key) >= 0)) {
+    return false;
+  }
+
   const intptr_t mask = size() - 1;
   intptr_t idx = Hash(key) & mask;
   intptr_t empty_idx = -1;
@@ -106,29 +133,123 @@ bool WeakTable::MarkValueExclusive(ObjectPtr key, intptr_t val) {
   SetValueAt(idx, val);
   // Update the counts.
   set_used(used() + 1);
-  set_count(count() + 1);
+  set_count(count_ + 1);
+
+  RehashIfNeeded();
+  return true;
+}
+
+void WeakTable::AddNew(ObjectPtr key, intptr_t val) {
+  ASSERT(val != kNoValue);
+  const intptr_t mask = size() - 1;
+  intptr_t idx = Hash(key) & mask;
+  intptr_t obj = data_[ObjectIndex(idx)];
+  while ((obj != kNoEntry) && (obj != kDeletedEntry)) {
+    ASSERT(obj != static_cast<intptr_t>(key));
+    idx = (idx + 1) & mask;
+    obj = data_[ObjectIndex(idx)];
+  }
+  if (obj == kNoEntry) {
+    set_used(used() + 1);
+  }
+  SetObjectAt(idx, key);
+  SetValueAt(idx, val);
+  set_count(count_ + 1);
+}
+
+intptr_t WeakTable::RemoveOldEntry(intptr_t idx) {
+  ASSERT(IsRehashing());
+  const intptr_t val = old_data_[ValueIndex(idx)];
+  ASSERT(val != kNoValue);
+  old_data_[ObjectIndex(idx)] = kDeletedEntry;
+  old_data_[ValueIndex(idx)] = kNoValue;
+  old_count_--;
+  return val;
+}
+
+void WeakTable::MoveEntries(intptr_t slots) {
+  ASSERT(IsRehashing());
+  const intptr_t end = Utils::Minimum(old_moved_ + slots, old_size_);
+  for (; old_moved_ < end; old_moved_++) {
+    if (old_data_[ValueIndex(old_moved_)] != kNoValue) {
+      const ObjectPtr key =
+          static_cast<ObjectPtr>(old_data_[ObjectIndex(old_moved_)]);
+      AddNew(key, RemoveOldEntry(old_moved_));
+    }
+  }
+  if (old_moved_ == old_size_) {
+    ASSERT(old_count_ == 0);
+    free(old_data_);
+    old_data_ = nullptr;
+    old_size_ = 0;
+    old_moved_ = 0;
+  }
+}
 
+void WeakTable::RehashIfNeeded() {
   // Rehash if needed to ensure that there are empty slots available.
-  if (used_ >= limit()) {
+  if (used_ < limit()) {
+    return;
+  }
+  if (IsRehashing() || (size() < kMinIncrementalRehashSize)) {
     Rehash();
+    return;
   }
-  return true;
+
+  // Start moving the entries to a new table. Every insertion moves enough
+  // of them to be done before the new table runs out of empty slots: until
+  // then, each of its used slots holds either a moved entry or an inserted
+  // one.
+  old_data_ = data_;
+  old_size_ = size_;
+  old_count_ = count_;
+  old_moved_ = 0;
+  size_ = SizeFor(old_count_, old_size_);
+  data_ = AllocateData(size_);
+  used_ = 0;
+  count_ = 0;
+  const intptr_t headroom = limit() - old_count_;
+  ASSERT(headroom > 0);
+  move_step_ = (old_size_ + headroom - 1) / headroom;
+  rehash_count_++;
+}
+
+WeakTable::ProbeStats WeakTable::ComputeProbeStatsExclusive() const {
+  ProbeStats stats;
+  auto add = [&](const intptr_t* data, intptr_t size) {
+    const intptr_t mask = size - 1;
+    for (intptr_t i = 0; i < size; i++) {
+      if (data[i * kEntrySize + kValueOffset] == kNoValue) continue;
+      const ObjectPtr key =
+          static_cast<ObjectPtr>(data[i * kEntrySize + kObjectOffset]);
+      const intptr_t probes = ((i - Hash(key)) & mask) + 1;
+      stats.entries++;
+      stats.total_probes += probes;
+      stats.max_probes = Utils::Maximum(stats.max_probes, probes);
+    }
+  };
+  add(data_, size_);
+  if (IsRehashing()) {
+    add(old_data_, old_size_);
+  }
+  return stats;
 }
 
 void WeakTable::Reset() {
-  intptr_t* old_data = data_;
+  free(data_);
+  free(old_data_);
+  old_data_ = nullptr;
+  old_size_ = 0;
+  old_count_ = 0;
+  old_moved_ = 0;
   used_ = 0;
   count_ = 0;
   size_ = kMinSize;
-  free(old_data);
-  data_ = reinterpret_cast<intptr_t*>(malloc(size_ * kEntrySize * kWordSize));
-  for (intptr_t i = 0; i < size_; i++) {
-    data_[ObjectIndex(i)] = kNoEntry;
-    data_[ValueIndex(i)] = kNoValue;
-  }
+  data_ = AllocateData(size_);
 }
 
 void WeakTable::Forward(ObjectPointerVisitor* visitor) {
+  FinishRehashExclusive();
   if (used_ == 0) return;
 
   for (intptr_t i = 0; i < size_; i++) {
@@ -145,6 +266,7 @@ void WeakTable::ReportSurvivingAllocations(
     Dart_HeapSamplingReportCallback callback,
     void* context) {
   MutexLocker ml(&mutex_);
+  FinishRehashExclusive();
   for (intptr_t i = 0; i < size_; i++) {
     if (IsValidEntryAtExclusive(i)) {
       void* data = reinterpret_cast<void*>(data_[ValueIndex(i)]);
@@ -154,6 +276,7 @@ void WeakTable::ReportSurvivingAllocations(
 }
 
 void WeakTable::CleanupValues(Dart_HeapSamplingDeleteCallback cleanup) {
+  FinishRehashExclusive();
   for (intptr_t i = 0; i < size_; i++) {
     if (IsValidEntryAtExclusive(i)) {
       cleanup(reinterpret_cast<void*>(data_[ValueIndex(i)]));
@@ -163,44 +286,34 @@ void WeakTable::CleanupValues(Dart_HeapSamplingDeleteCallback cleanup) {
 #endif
 
 void WeakTable::Rehash() {
+  const int64_t start = OS::GetCurrentMonotonicMicros();
   intptr_t old_size = size();
   intptr_t* old_data = data_;
 
   intptr_t new_size = SizeFor(count(), size());
   ASSERT(Utils::IsPowerOfTwo(new_size));
-  intptr_t* new_data =
-      reinterpret_cast<intptr_t*>(malloc(new_size * kEntrySize * kWordSize));
-  for (intptr_t i = 0; i < new_size; i++) {
-    new_data[ObjectIndex(i)] = kNoEntry;
-    new_data[ValueIndex(i)] = kNoValue;
-  }
+  size_ = new_size;
+  data_ = AllocateData(new_size);
+  used_ = 0;
+  count_ = 0;
 
-  intptr_t mask = new_size - 1;
-  set_used(0);
+  // Add the valid entries of the previous backing store, and of the one
+  // being rehashed incrementally, if any.
   for (intptr_t i = 0; i < old_size; i++) {
-    if (IsValidEntryAtExclusive(i)) {
-      // Find the new hash location for this entry.
-      ObjectPtr key = ObjectAtExclusive(i);
-      intptr_t idx = Hash(key) & mask;
-      ObjectPtr obj = static_cast<ObjectPtr>(new_data[ObjectIndex(idx)]);
-      while (obj != static_cast<ObjectPtr>(kNoEntry)) {
-        ASSERT(obj != key);  // Duplicate entry is not expected.
-        idx = (idx + 1) & mask;
-        obj = static_cast<ObjectPtr>(new_data[ObjectIndex(idx)]);
-      }
-
-      new_data[ObjectIndex(idx)] = static_cast<intptr_t>(key);
-      new_data[ValueIndex(idx)] = ValueAtExclusive(i);
-      set_used(used() + 1);
+    const intptr_t val = old_data[ValueIndex(i)];
+    if (val != kNoValue) {
+      AddNew(static_cast<ObjectPtr>(old_data[ObjectIndex(i)]), val);
     }
   }
+  free(old_data);
+  if (IsRehashing()) {
+    MoveEntries(old_size_);
+  }
   // We should only have used valid entries.
   ASSERT(used() == count());
 
-  // Switch to using the newly allocated backing store.
-  size_ = new_size;
-  data_ = new_data;
-  free(old_data);
+  rehash_count_++;
+  rehash_micros_ += OS::GetCurrentMonotonicMicros() - start;
 }
 
 }  // namespace dart
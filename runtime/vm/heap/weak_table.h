@@ -13,10 +13,22 @@
 
 namespace dart {
 
+// A hash table from objects to values which does not keep its keys alive.
+//
+// When a table which has grown large runs out of space, its entries are
+// moved to the larger table incrementally: every insertion moves a few of
+// them, so no single insertion pays for rehashing the whole table. Until all
+// of them have been moved, lookups probe both tables.
 class WeakTable {
  public:
   static constexpr intptr_t kNoValue = 0;
 
+  struct ProbeStats {
+    intptr_t entries = 0;
+    intptr_t total_probes = 0;
+    intptr_t max_probes = 0;
+  };
+
   WeakTable() : WeakTable(kMinSize) {}
   explicit WeakTable(intptr_t size) : used_(0), count_(0) {
     ASSERT(size >= 0);
@@ -33,22 +45,33 @@ class WeakTable {
     }
     size_ = size;
     ASSERT(Utils::IsPowerOfTwo(size_));
-    data_ = reinterpret_cast<intptr_t*>(malloc(size_ * kEntrySize * kWordSize));
-    for (intptr_t i = 0; i < size_; i++) {
-      data_[ObjectIndex(i)] = kNoEntry;
-      data_[ValueIndex(i)] = kNoValue;
-    }
+    data_ = AllocateData(size_);
   }
 
-  ~WeakTable() { free(data_); }
+  ~WeakTable() {
+    free(data_);
+    free(old_data_);
+  }
 
   static WeakTable* NewFrom(WeakTable* original) {
-    return new WeakTable(SizeFor(original->count(), original->size()));
+    WeakTable* table =
+        new WeakTable(SizeFor(original->count(), original->size()));
+    table->rehash_count_ = original->rehash_count_;
+    table->rehash_micros_ = original->rehash_micros_;
+    return table;
   }
 
   intptr_t size() const { return size_; }
   intptr_t used() const { return used_; }
-  intptr_t count() const { return count_; }
+  intptr_t count() const { return count_ + old_count_; }
+
+  // Whether some entries are still in the table being rehashed incrementally.
+  bool IsRehashing() const { return old_data_ != nullptr; }
+
+  // The number of rehashes, incremental or not, and the time spent in the
+  // ones which were not incremental.
+  intptr_t rehash_count() const { return rehash_count_; }
+  int64_t rehash_micros() const { return rehash_micros_; }
 
   // The following methods can be called concurrently and are guarded by a lock.
 
@@ -76,6 +99,19 @@ class WeakTable {
   // which are known to have exclusive access to the weak table.
   //
   // This is mostly limited to GC related code (e.g. scavenger, marker, ...)
+  //
+  // The methods which access entries by index only see the entries which
+  // have been moved to the current table, see [FinishRehashExclusive].
+
+  // Moves all the entries which are still in the table being rehashed
+  // incrementally, so they can be accessed by index.
+  void FinishRehashExclusive() {
+    if (IsRehashing()) {
+      MoveEntries(old_size_);
+    }
+  }
+
+  ProbeStats ComputeProbeStatsExclusive() const;
 
   bool IsValidEntryAtExclusive(intptr_t i) const {
     ASSERT((ValueAtExclusive(i) == 0 &&
@@ -107,36 +143,34 @@ class WeakTable {
   bool MarkValueExclusive(ObjectPtr key, intptr_t val);
 
   intptr_t GetValueExclusive(ObjectPtr key) const {
-    intptr_t mask = size() - 1;
-    intptr_t idx = Hash(key) & mask;
-    ObjectPtr obj = ObjectAtExclusive(idx);
-    while (obj != static_cast<ObjectPtr>(kNoEntry)) {
-      if (obj == key) {
-        return ValueAtExclusive(idx);
+    intptr_t idx = IndexOf(data_, size_, key);
+    if (idx >= 0) {
+      return ValueAtExclusive(idx);
+    }
+    if (IsRehashing()) {
+      idx = IndexOf(old_data_, old_size_, key);
+      if (idx >= 0) {
+        return old_data_[ValueIndex(idx)];
       }
-      idx = (idx + 1) & mask;
-      obj = ObjectAtExclusive(idx);
     }
-    ASSERT(ValueAtExclusive(idx) == 0);
     return kNoValue;
   }
 
   // Removes and returns the value associated with |key|. Returns 0 if there is
   // no value associated with |key|.
   intptr_t RemoveValueExclusive(ObjectPtr key) {
-    intptr_t mask = size() - 1;
-    intptr_t idx = Hash(key) & mask;
-    ObjectPtr obj = ObjectAtExclusive(idx);
-    while (obj != static_cast<ObjectPtr>(kNoEntry)) {
-      if (obj == key) {
-        intptr_t result = ValueAtExclusive(idx);
-        InvalidateAtExclusive(idx);
-        return result;
+    intptr_t idx = IndexOf(data_, size_, key);
+    if (idx >= 0) {
+      intptr_t result = ValueAtExclusive(idx);
+      InvalidateAtExclusive(idx);
+      return result;
+    }
+    if (IsRehashing()) {
+      idx = IndexOf(old_data_, old_size_, key);
+      if (idx >= 0) {
+        return RemoveOldEntry(idx);
       }
-      idx = (idx + 1) & mask;
-      obj = ObjectAtExclusive(idx);
     }
-    ASSERT(ValueAtExclusive(idx) == 0);
     return kNoValue;
   }
 
@@ -157,6 +191,8 @@ class WeakTable {
   static constexpr intptr_t kNoEntry = 1;       // Not a valid OOP.
   static constexpr intptr_t kDeletedEntry = 3;  // Not a valid OOP.
   static constexpr intptr_t kMinSize = 8;
+  // Tables with fewer entries are rehashed all at once.
+  static constexpr intptr_t kMinIncrementalRehashSize = 4 * KB;
 
   static intptr_t SizeFor(intptr_t count, intptr_t size);
   static intptr_t LimitFor(intptr_t size) {
@@ -172,6 +208,7 @@ class WeakTable {
     used_ = val;
   }
 
+  // Only counts the entries in data_.
   void set_count(intptr_t val) {
     ASSERT(val <= limit());
     ASSERT(val <= used());
@@ -200,11 +237,43 @@ class WeakTable {
     // Setting a value of 0 is equivalent to invalidating the entry.
     if (val == 0) {
       data_[ObjectIndex(i)] = kDeletedEntry;
-      set_count(count() - 1);
+      set_count(count_ - 1);
     }
     data_[ValueIndex(i)] = val;
   }
 
+  // Returns the index of |key| in the table with |data| and |size| entries,
+  // or -1.
+  static intptr_t IndexOf(const intptr_t* data, intptr_t size, ObjectPtr key) {
+    const intptr_t mask = size - 1;
+    intptr_t idx = Hash(key) & mask;
+    intptr_t obj = data[idx * kEntrySize + kObjectOffset];
+    while (obj != kNoEntry) {
+      if (obj == static_cast<intptr_t>(key)) {
+        return idx;
+      }
+      idx = (idx + 1) & mask;
+      obj = data[idx * kEntrySize + kObjectOffset];
+    }
+    ASSERT(data[idx * kEntrySize + kValueOffset] == kNoValue);
+    return -1;
+  }
+
+  static intptr_t* AllocateData(intptr_t size);
+
+  // Adds |key|, which must not be in the table yet, without rehashing.
+  void AddNew(ObjectPtr key, intptr_t val);
+
+  // Removes the entry at |idx| of the table being rehashed and returns its
+  // value.
+  intptr_t RemoveOldEntry(intptr_t idx);
+
+  // Moves up to |slots| slots of the table being rehashed.
+  void MoveEntries(intptr_t slots);
+
+  // Called after adding an entry to make sure there are empty slots left.
+  void RehashIfNeeded();
+
   void Rehash();
 
   static uword Hash(ObjectPtr key) {
@@ -222,6 +291,19 @@ class WeakTable {
   intptr_t used_;
   intptr_t count_;
 
+  // While rehashing incrementally, the previous table with old_size_ entries,
+  // old_count_ of which are valid. Its slots below old_moved_ have been
+  // moved to data_. A key is never in both tables.
+  intptr_t* old_data_ = nullptr;
+  intptr_t old_size_ = 0;
+  intptr_t old_count_ = 0;
+  intptr_t old_moved_ = 0;
+  // The number of slots moved by every insertion while rehashing.
+  intptr_t move_step_ = 0;
+
+  intptr_t rehash_count_ = 0;
+  int64_t rehash_micros_ = 0;
+
   DISALLOW_COPY_AND_ASSIGN(WeakTable);
 };
 
@@ -59,4 +59,63 @@ ISOLATE_UNIT_TEST_CASE(WeakTables) {
   EXPECT_EQ(kNoValue, heap->GetObjectId(imm_obj.ptr()));
 }
 
+// Not dereferenced. The first fake address is 0 + kHeapObjectTag, which is
+// the marker of empty slots.
+static ObjectPtr FakeKey(intptr_t i) {
+  return static_cast<ObjectPtr>(kHeapObjectTag + (i + 1) * kObjectAlignment);
+}
+
+static intptr_t FakeKeyIndex(ObjectPtr key) {
+  return (static_cast<uword>(key) - kHeapObjectTag) / kObjectAlignment - 1;
+}
+
+VM_UNIT_TEST_CASE(WeakTable_IncrementalRehash) {
+  WeakTable table;
+  const intptr_t kNumKeys = 20000;
+  bool was_rehashing = false;
+  for (intptr_t i = 0; i < kNumKeys; i++) {
+    table.SetValue(FakeKey(i), i + 1);
+    if (!table.IsRehashing()) continue;
+    was_rehashing = true;
+    // All entries can be found, updated and removed whichever table they are
+    // in.
+    EXPECT_EQ(i + 1, table.count());
+    EXPECT_EQ(1, table.GetValue(FakeKey(0)));
+    EXPECT_EQ(i / 2 + 1, table.GetValue(FakeKey(i / 2)));
+    EXPECT_EQ(i + 1, table.GetValue(FakeKey(i)));
+    EXPECT_EQ(WeakTable::kNoValue, table.GetValue(FakeKey(i + 1)));
+    table.SetValue(FakeKey(i / 3), -1);
+    EXPECT_EQ(-1, table.GetValue(FakeKey(i / 3)));
+    table.SetValue(FakeKey(i / 3), i / 3 + 1);
+  }
+  EXPECT(was_rehashing);
+  EXPECT_EQ(kNumKeys, table.count());
+  EXPECT(table.rehash_count() > 0);
+
+  // Remove the odd keys.
+  for (intptr_t i = 1; i < kNumKeys; i += 2) {
+    EXPECT_EQ(i + 1, table.RemoveValueExclusive(FakeKey(i)));
+  }
+  EXPECT_EQ(kNumKeys / 2, table.count());
+
+  table.FinishRehashExclusive();
+  EXPECT(!table.IsRehashing());
+  intptr_t valid = 0;
+  for (intptr_t i = 0; i < table.size(); i++) {
+    if (table.IsValidEntryAtExclusive(i)) {
+      const intptr_t key = FakeKeyIndex(table.ObjectAtExclusive(i));
+      EXPECT_EQ(0, key % 2);
+      EXPECT_EQ(key + 1, table.ValueAtExclusive(i));
+      valid++;
+    }
+  }
+  EXPECT_EQ(kNumKeys / 2, valid);
+
+  const WeakTable::ProbeStats stats = table.ComputeProbeStatsExclusive();
+  EXPECT_EQ(kNumKeys / 2, stats.entries);
+  EXPECT(stats.total_probes >= stats.entries);
+  EXPECT(stats.max_probes >= 1);
+  EXPECT(stats.max_probes <= table.size());
+}
+
 }  // namespace dart
@@ -58,7 +58,9 @@
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
 #include "vm/compiler/assembler/assembler.h"
+#include "vm/compiler/jit/warmup_cache.h"
 #include "vm/compiler/stub_code_compiler.h"
+#include "vm/compiler/type_feedback.h"
 #endif
 
 namespace dart {
@@ -92,6 +94,13 @@ DEFINE_FLAG_HANDLER(DeterministicModeHandler,
                     deterministic,
                     "Enable deterministic mode.");
 
+DEFINE_FLAG(int,
+            isolate_field_table_pool_size,
+            8,
+            "Maximum number of static field table backing stores an isolate "
+            "group keeps from exited isolates for reuse by newly spawned "
+            "isolates.");
+
 DEFINE_FLAG(bool,
             disable_thread_pool_limit,
             false,
@@ -354,8 +363,12 @@ IsolateGroup::IsolateGroup(std::shared_ptr<IsolateGroupSource> source,
       shared_initial_field_table_(new FieldTable(/*isolate=*/nullptr,
                                                  /*isolate_group=*/nullptr)),
       shared_field_table_(new FieldTable(/*isolate=*/nullptr, this)),
+      field_table_pool_(
+          new FieldTablePool(FLAG_isolate_field_table_pool_size)),
 #if !defined(DART_PRECOMPILED_RUNTIME)
       background_compiler_(new BackgroundCompiler(this)),
+#else
+      reverse_pc_cache_(new ReversePcCache()),
 #endif
       symbols_mutex_(NOT_IN_PRODUCT("IsolateGroup::symbols_mutex_")),
       type_canonicalization_mutex_(
@@ -437,6 +450,10 @@ IsolateGroup::~IsolateGroup() {
     delete[] obfuscation_map_;
   }
 
+  for (intptr_t i = 0; i < retained_snapshot_clusters_.length(); i++) {
+    delete retained_snapshot_clusters_[i];
+  }
+
   class_table_allocator_.Free(class_table_);
   if (heap_walk_class_table_ != class_table_) {
     class_table_allocator_.Free(heap_walk_class_table_);
@@ -448,6 +465,12 @@ IsolateGroup::~IsolateGroup() {
 #endif
 }
 
+void IsolateGroup::RetainSnapshotClusters(
+    std::unique_ptr<VirtualMemory> clusters) {
+  SafepointWriteRwLocker ml(Thread::Current(), program_lock());
+  retained_snapshot_clusters_.Add(clusters.release());
+}
+
 void IsolateGroup::RegisterIsolate(Isolate* isolate) {
   SafepointWriteRwLocker ml(Thread::Current(), isolates_lock_.get());
   ASSERT(isolates_lock_->IsCurrentThreadWriter());
@@ -1371,6 +1394,13 @@ MessageHandler::MessageStatus IsolateMessageHandler::HandleMessage(
   tbes.SetNumArguments(1);
   tbes.CopyArgument(0, "isolateName", I->name());
 #endif
+#if !defined(PRODUCT)
+  // Approximates the time until the isolate can serve its first request.
+  Metric* first_message_latency = I->GetFirstMessageLatencyMetric();
+  if (first_message_latency->value() == 0) {
+    first_message_latency->set_value(I->UptimeMicros());
+  }
+#endif  // !defined(PRODUCT)
 
   // Parse the message.
   Object& msg_obj = Object::Handle(zone, ReadMessage(thread, message.get()));
@@ -2581,6 +2611,18 @@ void Isolate::Shutdown() {
   }
 #endif  // !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
 
+#if !defined(DART_PRECOMPILED_RUNTIME)
+  // Record the optimized functions and the type feedback once the whole
+  // group is done.
+  if (is_runnable() && !Isolate::IsSystemIsolate(this) &&
+      group()->ContainsOnlyOneIsolate()) {
+    StackZone zone(thread);
+    HandleScope handle_scope(thread);
+    JitWarmupCache::Save(thread);
+    TypeFeedback::Save(thread);
+  }
+#endif  // !defined(DART_PRECOMPILED_RUNTIME)
+
   // Then, proceed with low-level teardown.
   Isolate::UnMarkIsolateReady(this);
 
@@ -2631,6 +2673,10 @@ void Isolate::LowLevelCleanup(Isolate* isolate) {
   ASSERT(!Thread::Current()->HasActiveState());
   Thread::ExitIsolate(/*isolate_shutdown=*/true);
 
+  // The isolate is no longer visited by GC, so the backing store of its static
+  // fields can be handed to the next isolate spawned into the group.
+  isolate_group->field_table_pool()->Recycle(isolate->field_table_);
+
   // Now it's safe to delete the isolate.
   delete isolate;
 
@@ -69,6 +69,7 @@ class ObjectPointerVisitor;
 class ObjectStore;
 class PersistentHandle;
 class ProgramReloadContext;
+class ReversePcCache;
 class RwLock;
 class SafepointHandler;
 class SafepointRwLock;
@@ -362,6 +363,17 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
 #endif  // !defined(PRODUCT)
 
   DispatchTable* dispatch_table() const { return dispatch_table_.get(); }
+
+  // The cache of stack maps found by ReversePc, or nullptr outside of the
+  // precompiled runtime.
+  ReversePcCache* reverse_pc_cache() const {
+#if defined(DART_PRECOMPILED_RUNTIME)
+    return reverse_pc_cache_.get();
+#else
+    return nullptr;
+#endif
+  }
+
   void set_dispatch_table(DispatchTable* table) {
     dispatch_table_.reset(table);
   }
@@ -766,6 +778,10 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
     T->shared_field_table_values_ = shared_field_table->table();
   }
 
+  // Backing stores of field tables of exited isolates, reused when new
+  // isolates are spawned into this group.
+  FieldTablePool* field_table_pool() const { return field_table_pool_.get(); }
+
   MutatorThreadPool* thread_pool() { return thread_pool_.get(); }
 
   void RegisterClass(const Class& cls);
@@ -782,6 +798,10 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   }
   NativeAssetsApi* native_assets_api() { return &native_assets_api_; }
 
+  // Takes ownership of decompressed snapshot clusters that objects in this
+  // group still point into, freeing them when the group is destroyed.
+  void RetainSnapshotClusters(std::unique_ptr<VirtualMemory> clusters);
+
  private:
   friend class Dart;  // For `object_store_ = ` in Dart::Init
   friend class Heap;
@@ -828,6 +848,9 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
 
   const char** obfuscation_map_ = nullptr;
 
+  // Guarded by [program_lock_].
+  MallocGrowableArray<VirtualMemory*> retained_snapshot_clusters_;
+
   bool is_vm_isolate_ = false;
   void* embedder_data_ = nullptr;
 
@@ -887,9 +910,11 @@ class IsolateGroup : public IntrusiveDListEntry<IsolateGroup> {
   std::shared_ptr<FieldTable> initial_field_table_;
   std::shared_ptr<FieldTable> shared_initial_field_table_;
   std::shared_ptr<FieldTable> shared_field_table_;
+  std::unique_ptr<FieldTablePool> field_table_pool_;
   uint32_t isolate_group_flags_ = 0;
 
   NOT_IN_PRECOMPILED(std::unique_ptr<BackgroundCompiler> background_compiler_);
+  ONLY_IN_PRECOMPILED(std::unique_ptr<ReversePcCache> reverse_pc_cache_);
 
   Mutex symbols_mutex_;
   Mutex type_canonicalization_mutex_;
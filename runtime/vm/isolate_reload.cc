@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "vm/bit_vector.h"
+#include "vm/closure_functions_cache.h"
 #include "vm/compiler/jit/compiler.h"
 #include "vm/dart_api_impl.h"
 #if !defined(PRODUCT) && !defined(DART_PRECOMPILED_RUNTIME)
@@ -1774,6 +1775,12 @@ void ProgramReloadContext::CommitAfterInstanceMorphing() {
     TIMELINE_SCOPE(ForwardEnums);
     become_.Forward();
   }
+  {
+    // Closure functions are hashed by their owner, which may have been
+    // forwarded to a new class above.
+    SafepointWriteRwLocker ml(Thread::Current(), IG->program_lock());
+    ClosureFunctionsCache::ResetClosureIndicesLocked();
+  }
 
   if (FLAG_identity_reload) {
     const auto& saved_libs = GrowableObjectArray::Handle(saved_libraries_);
@@ -2136,6 +2143,7 @@ void ProgramReloadContext::InvalidateFunctions(
       // test caches.
       resetter.ResetSwitchableCalls(code);
       resetter.ResetCaches(code);
+      resetter.ClearOsrCode(func);
     }
 
     // Clear counters.
@@ -412,6 +412,7 @@ class CallSiteResetter : public ValueObject {
   explicit CallSiteResetter(Zone* zone);
 
   void ZeroEdgeCounters(const Function& function);
+  void ClearOsrCode(const Function& function);
   void ResetCaches(const Code& code);
   void ResetCaches(const ObjectPool& pool);
   void Reset(const ICData& ic);
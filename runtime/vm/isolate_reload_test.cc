@@ -201,6 +201,75 @@ TEST_CASE(IsolateReload_KernelIncrementalCompileAppAndLib) {
   EXPECT_EQ(24, value);
 }
 
+// Cached OSR code of a function whose unoptimized code survives the reload
+// must not be reused, as it may have inlined the old version of a callee.
+TEST_CASE(IsolateReload_OsrCodeAfterCalleeReload) {
+  SetFlagScope<int> sfs(&FLAG_optimization_counter_threshold, 100);
+  SetFlagScope<bool> sfs2(&FLAG_background_compilation, false);
+  // clang-format off
+  Dart_SourceFile sourcefiles[] = {
+    {
+      "file:///test-app.dart",
+      "import 'test-lib.dart';\n"
+      "loop() {\n"
+      "  int sum = 0;\n"
+      "  for (int i = 0; i < 10000; i++) {\n"
+      "    sum += value();\n"
+      "  }\n"
+      "  return sum;\n"
+      "}\n"
+      "main() {\n"
+      "  return loop();\n"
+      "}\n",
+    },
+    {
+      "file:///test-lib.dart",
+      "value() {\n"
+      "  return 42;\n"
+      "}\n",
+    }};
+  // clang-format on
+
+  Dart_Handle lib = TestCase::LoadTestScriptWithDFE(
+      sizeof(sourcefiles) / sizeof(Dart_SourceFile), sourcefiles,
+      nullptr /* resolver */, true /* finalize */, true /* incrementally */);
+  EXPECT_VALID(lib);
+  EXPECT_EQ(420000, SimpleInvoke(lib, "main"));
+  Isolate* isolate = Isolate::Current();
+  const int64_t osr_compilations =
+      isolate->GetOsrCompilationsMetric()->value();
+  EXPECT(osr_compilations > 0);
+
+  // clang-format off
+  Dart_SourceFile updated_sourcefiles[] = {
+    {
+      "file:///test-lib.dart",
+      "value() {\n"
+      "  return 24;\n"
+      "}\n"
+    }};
+  // clang-format on
+
+  {
+    const uint8_t* kernel_buffer = nullptr;
+    intptr_t kernel_buffer_size = 0;
+    char* error = TestCase::CompileTestScriptWithDFE(
+        "file:///test-app.dart",
+        sizeof(updated_sourcefiles) / sizeof(Dart_SourceFile),
+        updated_sourcefiles, &kernel_buffer, &kernel_buffer_size,
+        true /* incrementally */);
+    EXPECT(error == nullptr);
+    EXPECT_NOTNULL(kernel_buffer);
+
+    lib = TestCase::ReloadTestKernel(kernel_buffer, kernel_buffer_size);
+    EXPECT_VALID(lib);
+  }
+  const int64_t osr_reuses = isolate->GetOsrCodeReusesMetric()->value();
+  EXPECT_EQ(240000, SimpleInvoke(lib, "main"));
+  EXPECT(isolate->GetOsrCompilationsMetric()->value() > osr_compilations);
+  EXPECT_EQ(osr_reuses, isolate->GetOsrCodeReusesMetric()->value());
+}
+
 TEST_CASE(IsolateReload_KernelIncrementalCompileGenerics) {
   // clang-format off
   Dart_SourceFile sourcefiles[] = {
@@ -289,4 +289,37 @@ ISOLATE_UNIT_TEST_CASE(Isolate_MayExit_False) {
   EXPECT_EQ(false, thread->is_unwind_in_progress());
 }
 
+ISOLATE_UNIT_TEST_CASE(FieldTablePool_ReusesStorage) {
+  auto isolate_group = thread->isolate_group();
+  SafepointReadRwLocker reader(thread, isolate_group->program_lock());
+  FieldTable* initial = isolate_group->initial_field_table();
+  EXPECT(initial->Capacity() > 0);
+
+  FieldTablePool pool(/*max_size=*/1);
+  bool reused = true;
+  FieldTable* first = pool.Clone(initial, /*for_isolate=*/nullptr, &reused);
+  EXPECT(!reused);
+  pool.Recycle(first);
+  EXPECT_EQ(1, pool.size());
+  EXPECT_EQ(0, first->Capacity());
+  delete first;
+
+  FieldTable* second = pool.Clone(initial, /*for_isolate=*/nullptr, &reused);
+  EXPECT(reused);
+  EXPECT_EQ(0, pool.size());
+  EXPECT_EQ(initial->NumFieldIds(), second->NumFieldIds());
+  for (intptr_t i = 0; i < initial->NumFieldIds(); i++) {
+    EXPECT(initial->At(i) == second->At(i));
+  }
+
+  // The pool does not grow beyond its maximum size.
+  FieldTable* third = pool.Clone(initial, /*for_isolate=*/nullptr, &reused);
+  EXPECT(!reused);
+  pool.Recycle(second);
+  pool.Recycle(third);
+  EXPECT_EQ(1, pool.size());
+  delete second;
+  delete third;
+}
+
 }  // namespace dart
@@ -113,6 +113,21 @@ void MegamorphicCacheTable::PrintSizes(Thread* thread) {
                      static_cast<double>(entry_count));
   }
   delete[] probe_counts;
+
+  // Report the caches whose entries are slow to find.
+  const intptr_t kReportedMaxProbes = 8;
+  String& name = String::Handle();
+  for (intptr_t i = 0; i < table.Length(); i++) {
+    cache ^= table.At(i);
+    const MegamorphicCache::ProbeStats stats = cache.ComputeProbeStats();
+    if (stats.max_probes < kReportedMaxProbes) continue;
+    name = cache.target_name();
+    OS::PrintErr("Megamorphic cache %s: %" Pd " entries, %" Pd
+                 " probes at most, %lf on average\n",
+                 name.ToCString(), stats.entries, stats.max_probes,
+                 static_cast<double>(stats.total_probes) /
+                     static_cast<double>(stats.entries));
+  }
 }
 
 }  // namespace dart
@@ -41,14 +41,36 @@ class JSONStream;
   V(MaxMetric, HeapNewUsedMax, "heap.new.used.max", kByte)                     \
   V(MaxMetric, HeapNewCapacityMax, "heap.new.capacity.max", kByte)             \
   V(MetricHeapUsed, HeapGlobalUsed, "heap.global.used", kByte)                 \
-  V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)
+  V(MaxMetric, HeapGlobalUsedMax, "heap.global.used.max", kByte)               \
+  V(Metric, SnapshotMaterialized, "snapshot.materialized", kByte)              \
+  V(Metric, SnapshotInPlace, "snapshot.in_place", kByte)                       \
+  V(Metric, BackgroundCompilationQueueLength,                                  \
+    "compiler.background.queue_length", kCounter)                              \
+  V(MaxMetric, BackgroundCompilationQueueLengthMax,                            \
+    "compiler.background.queue_length.max", kCounter)                          \
+  V(Metric, BackgroundCompilationWait, "compiler.background.wait",             \
+    kMicrosecond)                                                              \
+  V(MaxMetric, BackgroundCompilationWaitMax,                                   \
+    "compiler.background.wait.max", kMicrosecond)                              \
+  V(Metric, SubtypeTestCacheRuntimeLookups,                                    \
+    "type_check.cache.runtime_lookups", kCounter)                              \
+  V(Metric, SubtypeTestCacheRuntimeHits, "type_check.cache.runtime_hits",      \
+    kCounter)                                                                  \
+  V(Metric, SubtypeTestCacheEntries, "type_check.cache.entries", kCounter)     \
+  V(Metric, SubtypeTestCacheCapacity, "type_check.cache.capacity", kCounter)   \
+  V(Metric, SubtypeTestCacheEarlyGrowths, "type_check.cache.early_growths",    \
+    kCounter)
 
 // Metrics for each isolate.
 //
 // All metrics are exposed via vm-service protocol.
 #define ISOLATE_METRIC_LIST(V)                                                 \
   V(Metric, RunnableLatency, "isolate.runnable.latency", kMicrosecond)         \
-  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)
+  V(Metric, RunnableHeapSize, "isolate.runnable.heap", kByte)                  \
+  V(Metric, FirstMessageLatency, "isolate.first_message.latency",              \
+    kMicrosecond)                                                              \
+  V(Metric, OsrCompilations, "isolate.osr.compilations", kCounter)             \
+  V(Metric, OsrCodeReuses, "isolate.osr.reuses", kCounter)
 
 class Metric {
  public:
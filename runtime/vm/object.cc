@@ -64,6 +64,7 @@
 #include "vm/scopes.h"
 #include "vm/stack_frame.h"
 #include "vm/stub_code.h"
+#include "vm/string_kernels.h"
 #include "vm/symbols.h"
 #include "vm/tags.h"
 #include "vm/thread_registry.h"
@@ -18745,11 +18746,11 @@ const char* Sentinel::ToCString() const {
 }
 
 ArrayPtr MegamorphicCache::buckets() const {
-  return untag()->buckets();
+  return untag()->buckets<std::memory_order_acquire>();
 }
 
 void MegamorphicCache::set_buckets(const Array& buckets) const {
-  untag()->set_buckets(buckets.ptr());
+  untag()->set_buckets<std::memory_order_release>(buckets.ptr());
 }
 
 // Class IDs in the table are smi-tagged, so we use a smi-tagged mask
@@ -18809,8 +18810,8 @@ void MegamorphicCache::EnsureContains(const Smi& class_id,
 }
 
 ObjectPtr MegamorphicCache::Lookup(const Smi& class_id) const {
-  SafepointMutexLocker ml(IsolateGroup::Current()->type_feedback_mutex());
-  return LookupLocked(class_id);
+  // Published buckets are never modified, so no lock is needed.
+  return LookupIn(Array::Handle(buckets()), class_id);
 }
 
 ObjectPtr MegamorphicCache::LookupLocked(const Smi& class_id) const {
@@ -18820,15 +18821,19 @@ ObjectPtr MegamorphicCache::LookupLocked(const Smi& class_id) const {
   ASSERT(thread->IsDartMutatorThread());
   ASSERT(isolate_group->type_feedback_mutex()->IsOwnedByCurrentThread());
 
-  const auto& backing_array = Array::Handle(zone, buckets());
-  intptr_t id_mask = mask();
-  intptr_t index = (class_id.Value() * kSpreadFactor) & id_mask;
+  return LookupIn(Array::Handle(zone, buckets()), class_id);
+}
+
+ObjectPtr MegamorphicCache::LookupIn(const Array& buckets,
+                                     const Smi& class_id) {
+  const intptr_t id_mask = MaskOf(buckets);
+  const intptr_t index = (class_id.Value() * kSpreadFactor) & id_mask;
   intptr_t i = index;
   do {
     const classid_t current_cid =
-        Smi::Value(Smi::RawCast(GetClassId(backing_array, i)));
+        Smi::Value(Smi::RawCast(GetClassId(buckets, i)));
     if (current_cid == class_id.Value()) {
-      return GetTargetFunction(backing_array, i);
+      return GetTargetFunction(buckets, i);
     } else if (current_cid == kIllegalCid) {
       return Object::null();
     }
@@ -18839,74 +18844,53 @@ ObjectPtr MegamorphicCache::LookupLocked(const Smi& class_id) const {
 
 void MegamorphicCache::InsertLocked(const Smi& class_id,
                                     const Object& target) const {
-  auto isolate_group = IsolateGroup::Current();
-  ASSERT(isolate_group->type_feedback_mutex()->IsOwnedByCurrentThread());
-
-  // As opposed to ICData we are stopping mutator threads from other isolates
-  // while modifying the megamorphic cache, since updates are not atomic.
-  //
-  // NOTE: In the future we might change the megamorphic cache insertions to
-  // carefully use store-release barriers on the writer as well as
-  // load-acquire barriers on the reader, ...
-  isolate_group->RunWithStoppedMutators(
-      [&]() {
-        EnsureCapacityLocked();
-        InsertEntryLocked(class_id, target);
-      },
-      /*use_force_growth=*/true);
-}
-
-void MegamorphicCache::EnsureCapacityLocked() const {
   auto thread = Thread::Current();
   auto zone = thread->zone();
   auto isolate_group = thread->isolate_group();
   ASSERT(isolate_group->type_feedback_mutex()->IsOwnedByCurrentThread());
 
-  intptr_t old_capacity = mask() + 1;
-  double load_limit = kLoadFactor * static_cast<double>(old_capacity);
+  // Other mutators search the buckets concurrently, both in the megamorphic
+  // call stub and in the runtime, so the buckets are never modified once
+  // published. Instead, the entries are copied into new buckets together
+  // with the new entry, which are then published with a store-release. The
+  // stub derives the mask from the buckets, so it always matches them.
+  const Array& old_buckets = Array::Handle(zone, buckets());
+  const intptr_t old_capacity = MaskOf(old_buckets) + 1;
+  intptr_t new_capacity = old_capacity;
+  const double load_limit = kLoadFactor * static_cast<double>(old_capacity);
   if (static_cast<double>(filled_entry_count() + 1) > load_limit) {
-    const Array& old_buckets = Array::Handle(zone, buckets());
-    intptr_t new_capacity = old_capacity * 2;
-    const Array& new_buckets =
-        Array::Handle(zone, Array::New(kEntryLength * new_capacity));
-
-    auto& target = Object::Handle(zone);
-    for (intptr_t i = 0; i < new_capacity; ++i) {
-      SetEntry(new_buckets, i, smi_illegal_cid(), target);
-    }
-    set_buckets(new_buckets);
-    set_mask(new_capacity - 1);
-    set_filled_entry_count(0);
-
-    // Rehash the valid entries.
-    Smi& class_id = Smi::Handle(zone);
-    for (intptr_t i = 0; i < old_capacity; ++i) {
-      class_id ^= GetClassId(old_buckets, i);
-      if (class_id.Value() != kIllegalCid) {
-        target = GetTargetFunction(old_buckets, i);
-        InsertEntryLocked(class_id, target);
-      }
+    new_capacity = old_capacity * 2;
+  }
+  const Array& new_buckets = Array::Handle(
+      zone, Array::New(kEntryLength * new_capacity, Heap::kOld));
+  auto& entry_target = Object::Handle(zone);
+  for (intptr_t i = 0; i < new_capacity; ++i) {
+    SetEntry(new_buckets, i, smi_illegal_cid(), entry_target);
+  }
+  Smi& entry_class_id = Smi::Handle(zone);
+  for (intptr_t i = 0; i < old_capacity; ++i) {
+    entry_class_id ^= GetClassId(old_buckets, i);
+    if (entry_class_id.Value() != kIllegalCid) {
+      entry_target = GetTargetFunction(old_buckets, i);
+      InsertEntry(new_buckets, entry_class_id, entry_target);
     }
   }
-}
+  InsertEntry(new_buckets, class_id, target);
 
-void MegamorphicCache::InsertEntryLocked(const Smi& class_id,
-                                         const Object& target) const {
-  auto thread = Thread::Current();
-  auto isolate_group = thread->isolate_group();
-  ASSERT(isolate_group->type_feedback_mutex()->IsOwnedByCurrentThread());
+  set_mask(new_capacity - 1);
+  set_buckets(new_buckets);
+  set_filled_entry_count(filled_entry_count() + 1);
+}
 
-  ASSERT(Thread::Current()->IsDartMutatorThread());
-  ASSERT(static_cast<double>(filled_entry_count() + 1) <=
-         (kLoadFactor * static_cast<double>(mask() + 1)));
-  const Array& backing_array = Array::Handle(buckets());
-  intptr_t id_mask = mask();
-  intptr_t index = (class_id.Value() * kSpreadFactor) & id_mask;
+void MegamorphicCache::InsertEntry(const Array& buckets,
+                                   const Smi& class_id,
+                                   const Object& target) {
+  const intptr_t id_mask = MaskOf(buckets);
+  const intptr_t index = (class_id.Value() * kSpreadFactor) & id_mask;
   intptr_t i = index;
   do {
-    if (Smi::Value(Smi::RawCast(GetClassId(backing_array, i))) == kIllegalCid) {
-      SetEntry(backing_array, i, class_id, target);
-      set_filled_entry_count(filled_entry_count() + 1);
+    if (Smi::Value(Smi::RawCast(GetClassId(buckets, i))) == kIllegalCid) {
+      SetEntry(buckets, i, class_id, target);
       return;
     }
     i = (i + 1) & id_mask;
@@ -18914,6 +18898,24 @@ void MegamorphicCache::InsertEntryLocked(const Smi& class_id,
   UNREACHABLE();
 }
 
+MegamorphicCache::ProbeStats MegamorphicCache::ComputeProbeStats() const {
+  const auto& backing_array = Array::Handle(buckets());
+  const intptr_t id_mask = MaskOf(backing_array);
+  ProbeStats stats;
+  for (intptr_t i = 0; i <= id_mask; i++) {
+    const intptr_t class_id =
+        Smi::Value(Smi::RawCast(GetClassId(backing_array, i)));
+    if (class_id == kIllegalCid) continue;
+    // The number of probes needed to find the entry, including the last one.
+    const intptr_t start = (class_id * kSpreadFactor) & id_mask;
+    const intptr_t probes = ((i - start) & id_mask) + 1;
+    stats.entries++;
+    stats.total_probes += probes;
+    stats.max_probes = Utils::Maximum(stats.max_probes, probes);
+  }
+  return stats;
+}
+
 const char* MegamorphicCache::ToCString() const {
   const String& name = String::Handle(target_name());
   return OS::SCreate(Thread::Current()->zone(), "MegamorphicCache(%s)",
@@ -18991,17 +18993,34 @@ intptr_t SubtypeTestCache::AddCheck(
   ASSERT(Smi::New(kRecordCid) != instance_class_id_or_signature.ptr());
 
   const intptr_t old_num = NumberOfChecks();
-  Zone* const zone = Thread::Current()->zone();
+  Thread* const thread = Thread::Current();
+  Zone* const zone = thread->zone();
+  IsolateGroup* const isolate_group = thread->isolate_group();
   Array& data = Array::Handle(zone, cache());
+  const intptr_t old_capacity = NumEntries(data);
   bool was_grown;
   data = EnsureCapacity(zone, data, old_num + 1, &was_grown);
   ASSERT(data.ptr() != Object::empty_subtype_test_cache_array().ptr());
 
-  const auto& loc = FindKeyOrUnused(
+  auto loc = FindKeyOrUnused(
       data, num_inputs(), instance_class_id_or_signature, destination_type,
       instance_type_arguments, instantiator_type_arguments,
       function_type_arguments, instance_parent_function_type_arguments,
       instance_delayed_type_arguments);
+  if (!loc.present && !was_grown && IsHash(data) &&
+      loc.collisions > kMaxCollisions &&
+      LoadFactor(old_num + 1, NumEntries(data)) >=
+          kMinLoadFactorForEarlyGrowth) {
+    data = EnsureCapacity(zone, data, old_num + 1, &was_grown,
+                          /*force_growth=*/true);
+    ASSERT(was_grown);
+    isolate_group->GetSubtypeTestCacheEarlyGrowthsMetric()->increment();
+    loc = FindKeyOrUnused(
+        data, num_inputs(), instance_class_id_or_signature, destination_type,
+        instance_type_arguments, instantiator_type_arguments,
+        function_type_arguments, instance_parent_function_type_arguments,
+        instance_delayed_type_arguments);
+  }
   SubtypeTestCacheTable entries(data);
   const auto& entry = entries[loc.entry];
   if (loc.present) {
@@ -19056,8 +19075,11 @@ intptr_t SubtypeTestCache::AddCheck(
       UNREACHABLE();
   }
   set_num_occupied(old_num + 1);
+  isolate_group->GetSubtypeTestCacheEntriesMetric()->increment();
   if (was_grown) {
     set_cache(data);
+    auto capacity = isolate_group->GetSubtypeTestCacheCapacityMetric();
+    capacity->set_value(capacity->value() + NumEntries(data) - old_capacity);
   }
   return loc.entry;
 }
@@ -19132,7 +19154,7 @@ SubtypeTestCache::KeyLocation SubtypeTestCache::FindKeyOrUnused(
     const TypeArguments& instance_delayed_type_arguments) {
   // Fast case for empty STCs.
   if (array.ptr() == Object::empty_subtype_test_cache_array().ptr()) {
-    return {0, false};
+    return {0, false, 0};
   }
   const bool is_hash = IsHash(array);
   SubtypeTestCacheTable table(array);
@@ -19142,6 +19164,7 @@ SubtypeTestCache::KeyLocation SubtypeTestCache::FindKeyOrUnused(
   // after all the occupied ones.
   intptr_t probe = 0;
   intptr_t probe_distance = 1;
+  intptr_t collisions = 0;
   if (is_hash) {
     // For a hash-based cache, instead start at an entry determined by the hash
     // of the keys.
@@ -19190,8 +19213,9 @@ SubtypeTestCache::KeyLocation SubtypeTestCache::FindKeyOrUnused(
             instance_type_arguments, instantiator_type_arguments,
             function_type_arguments, instance_parent_function_type_arguments,
             instance_delayed_type_arguments)) {
-      return {probe, true};
+      return {probe, true, collisions};
     }
+    collisions++;
     // Advance probe by the current probing distance.
     probe = probe + probe_distance;
     if (is_hash) {
@@ -19202,13 +19226,14 @@ SubtypeTestCache::KeyLocation SubtypeTestCache::FindKeyOrUnused(
       probe_distance++;
     }
   }
-  return {probe, false};
+  return {probe, false, collisions};
 }
 
 ArrayPtr SubtypeTestCache::EnsureCapacity(Zone* zone,
                                           const Array& array,
                                           intptr_t new_occupied,
-                                          bool* was_grown) const {
+                                          bool* was_grown,
+                                          bool force_growth) const {
   ASSERT(new_occupied > NumberOfChecks());
   ASSERT(was_grown != nullptr);
   // How many entries are in the current array (including unoccupied entries).
@@ -19220,7 +19245,7 @@ ArrayPtr SubtypeTestCache::EnsureCapacity(Zone* zone,
   if (is_linear) {
     // We need at least one unoccupied entry in addition to the occupied ones.
     if (current_capacity > new_occupied) return array.ptr();
-  } else {
+  } else if (!force_growth) {
     if (LoadFactor(new_occupied, current_capacity) < kMaxLoadFactor) {
       return array.ptr();
     }
@@ -23552,13 +23577,23 @@ bool String::Equals(const String& str,
     return false;  // Lengths don't match.
   }
 
-  for (intptr_t i = 0; i < len; i++) {
-    if (CharAt(i) != str.CharAt(begin_index + i)) {
-      return false;
+  NoSafepointScope no_safepoint;
+  if (IsOneByteString()) {
+    const uint8_t* chars = OneByteString::DataStart(*this);
+    if (str.IsOneByteString()) {
+      return StringKernels::Equals(
+          chars, OneByteString::DataStart(str) + begin_index, len);
     }
+    return StringKernels::Equals(
+        TwoByteString::DataStart(str) + begin_index, chars, len);
   }
-
-  return true;
+  const uint16_t* chars = TwoByteString::DataStart(*this);
+  if (str.IsOneByteString()) {
+    return StringKernels::Equals(
+        chars, OneByteString::DataStart(str) + begin_index, len);
+  }
+  return StringKernels::Equals(
+      chars, TwoByteString::DataStart(str) + begin_index, len);
 }
 
 bool String::Equals(const char* cstr) const {
@@ -23588,12 +23623,13 @@ bool String::Equals(const uint8_t* latin1_array, intptr_t len) const {
     return false;
   }
 
-  for (intptr_t i = 0; i < len; i++) {
-    if (this->CharAt(i) != latin1_array[i]) {
-      return false;
-    }
+  NoSafepointScope no_safepoint;
+  if (IsOneByteString()) {
+    return StringKernels::Equals(OneByteString::DataStart(*this), latin1_array,
+                                 len);
   }
-  return true;
+  return StringKernels::Equals(TwoByteString::DataStart(*this), latin1_array,
+                               len);
 }
 
 bool String::Equals(const uint16_t* utf16_array, intptr_t len) const {
@@ -23602,12 +23638,13 @@ bool String::Equals(const uint16_t* utf16_array, intptr_t len) const {
     return false;
   }
 
-  for (intptr_t i = 0; i < len; i++) {
-    if (this->CharAt(i) != LoadUnaligned(&utf16_array[i])) {
-      return false;
-    }
+  NoSafepointScope no_safepoint;
+  if (IsOneByteString()) {
+    return StringKernels::Equals(utf16_array, OneByteString::DataStart(*this),
+                                 len);
   }
-  return true;
+  return StringKernels::Equals(TwoByteString::DataStart(*this), utf16_array,
+                               len);
 }
 
 bool String::Equals(const int32_t* utf32_array, intptr_t len) const {
@@ -23638,14 +23675,22 @@ intptr_t String::CompareTo(const String& other) const {
   const intptr_t this_len = this->Length();
   const intptr_t other_len = other.IsNull() ? 0 : other.Length();
   const intptr_t len = (this_len < other_len) ? this_len : other_len;
-  for (intptr_t i = 0; i < len; i++) {
-    uint16_t this_code_unit = this->CharAt(i);
-    uint16_t other_code_unit = other.CharAt(i);
-    if (this_code_unit < other_code_unit) {
-      return -1;
-    }
-    if (this_code_unit > other_code_unit) {
-      return 1;
+  if ((len > 0) && IsOneByteString() && other.IsOneByteString()) {
+    // Bytes compare in the same order as the code units they encode.
+    NoSafepointScope no_safepoint;
+    const int result = memcmp(OneByteString::DataStart(*this),
+                              OneByteString::DataStart(other), len);
+    if (result != 0) return (result < 0) ? -1 : 1;
+  } else {
+    for (intptr_t i = 0; i < len; i++) {
+      uint16_t this_code_unit = this->CharAt(i);
+      uint16_t other_code_unit = other.CharAt(i);
+      if (this_code_unit < other_code_unit) {
+        return -1;
+      }
+      if (this_code_unit > other_code_unit) {
+        return 1;
+      }
     }
   }
   if (this_len < other_len) return -1;
@@ -23738,14 +23783,7 @@ StringPtr String::FromLatin1(const uint8_t* latin1_array,
 StringPtr String::FromUTF16(const uint16_t* utf16_array,
                             intptr_t array_len,
                             Heap::Space space) {
-  bool is_one_byte_string = true;
-  for (intptr_t i = 0; i < array_len; ++i) {
-    if (!Utf::IsLatin1(LoadUnaligned(&utf16_array[i]))) {
-      is_one_byte_string = false;
-      break;
-    }
-  }
-  if (is_one_byte_string) {
+  if (StringKernels::IsLatin1(utf16_array, array_len)) {
     return OneByteString::New(utf16_array, array_len, space);
   }
   return TwoByteString::New(utf16_array, array_len, space);
@@ -23801,9 +23839,9 @@ void String::Copy(const String& dst,
       memmove(OneByteString::CharAddr(dst, dst_offset), characters, len);
     }
   } else if (dst.IsTwoByteString()) {
-    for (intptr_t i = 0; i < len; ++i) {
-      *TwoByteString::CharAddr(dst, i + dst_offset) = characters[i];
-    }
+    NoSafepointScope no_safepoint;
+    StringKernels::Widen(characters, TwoByteString::DataStart(dst) + dst_offset,
+                         len);
   }
 }
 
@@ -23815,11 +23853,10 @@ void String::Copy(const String& dst,
   ASSERT(array_len >= 0);
   ASSERT(array_len <= (dst.Length() - dst_offset));
   if (dst.IsOneByteString()) {
+    ASSERT(StringKernels::IsLatin1(utf16_array, array_len));
     NoSafepointScope no_safepoint;
-    for (intptr_t i = 0; i < array_len; ++i) {
-      ASSERT(Utf::IsLatin1(LoadUnaligned(&utf16_array[i])));
-      *OneByteString::CharAddr(dst, i + dst_offset) = utf16_array[i];
-    }
+    StringKernels::Narrow(
+        utf16_array, OneByteString::DataStart(dst) + dst_offset, array_len);
   } else {
     ASSERT(dst.IsTwoByteString());
     NoSafepointScope no_safepoint;
@@ -24104,12 +24141,9 @@ StringPtr String::SubString(Thread* thread,
   bool is_one_byte_string = true;
   intptr_t char_size = str.CharSize();
   if (char_size == kTwoByteChar) {
-    for (intptr_t i = begin_index; i < begin_index + length; ++i) {
-      if (!Utf::IsLatin1(str.CharAt(i))) {
-        is_one_byte_string = false;
-        break;
-      }
-    }
+    NoSafepointScope no_safepoint;
+    is_one_byte_string = StringKernels::IsLatin1(
+        TwoByteString::DataStart(str) + begin_index, length);
   }
   REUSABLE_STRING_HANDLESCOPE(thread);
   String& result = thread->StringHandle();
@@ -24194,12 +24228,24 @@ StringPtr String::Transform(int32_t (*mapping)(int32_t ch),
 }
 
 StringPtr String::ToUpperCase(const String& str, Heap::Space space) {
-  // TODO(cshapiro): create a fast-path for OneByteString instances.
+  if (str.IsOneByteString()) {
+    const OneByteStringPtr result =
+        OneByteString::SwitchAsciiCase(str, 'a', 'z', space);
+    if (result != OneByteString::null()) {
+      return result;
+    }
+  }
   return Transform(CaseMapping::ToUpper, str, space);
 }
 
 StringPtr String::ToLowerCase(const String& str, Heap::Space space) {
-  // TODO(cshapiro): create a fast-path for OneByteString instances.
+  if (str.IsOneByteString()) {
+    const OneByteStringPtr result =
+        OneByteString::SwitchAsciiCase(str, 'A', 'Z', space);
+    if (result != OneByteString::null()) {
+      return result;
+    }
+  }
   return Transform(CaseMapping::ToLower, str, space);
 }
 
@@ -24505,6 +24551,41 @@ OneByteStringPtr OneByteString::Transform(int32_t (*mapping)(int32_t ch),
   return OneByteString::raw(result);
 }
 
+OneByteStringPtr OneByteString::SwitchAsciiCase(const String& str,
+                                                uint8_t first,
+                                                uint8_t last,
+                                                Heap::Space space) {
+  ASSERT(!str.IsNull() && str.IsOneByteString());
+  const intptr_t len = str.Length();
+  {
+    NoSafepointScope no_safepoint;
+    const uint8_t* chars = DataStart(str);
+    if (!StringKernels::IsAscii(chars, len)) {
+      return OneByteString::null();
+    }
+    if (!StringKernels::ContainsInRange(chars, len, first, last)) {
+      return raw(str);
+    }
+  }
+  const String& result = String::Handle(OneByteString::New(len, space));
+  NoSafepointScope no_safepoint;
+  StringKernels::SwitchAsciiCase(DataStart(str), DataStart(result), len,
+                                 first, last);
+  return raw(result);
+}
+
+intptr_t OneByteString::IndexOf(const String& str,
+                                const String& pattern,
+                                intptr_t start) {
+  ASSERT(str.IsOneByteString() && pattern.IsOneByteString());
+  ASSERT((start >= 0) && (start <= str.Length()));
+  NoSafepointScope no_safepoint;
+  const intptr_t index =
+      StringKernels::IndexOf(DataStart(str) + start, str.Length() - start,
+                             DataStart(pattern), pattern.Length());
+  return (index < 0) ? -1 : start + index;
+}
+
 OneByteStringPtr OneByteString::SubStringUnchecked(const String& str,
                                                    intptr_t begin_index,
                                                    intptr_t length,
@@ -4070,12 +4070,14 @@ class Function : public Object {
                         bool clone_ic_data) const;
 
   // ic_data_array attached to the function stores edge counters in the
-  // first element, coverage data array in the second element and the rest
+  // first element, coverage data array in the second element, the OSR code
+  // cache (see Compiler::LookupOsrCode) in the third element and the rest
   // are ICData objects.
   struct ICDataArrayIndices {
     static constexpr intptr_t kEdgeCounters = 0;
     static constexpr intptr_t kCoverageData = 1;
-    static constexpr intptr_t kFirstICData = 2;
+    static constexpr intptr_t kOsrCode = 2;
+    static constexpr intptr_t kFirstICData = 3;
   };
 
   ArrayPtr ic_data_array() const;
@@ -7645,8 +7647,22 @@ class MegamorphicCache : public CallSiteData {
                                  const Array& arguments_descriptor);
 
   void EnsureContains(const Smi& class_id, const Object& target) const;
+  // Does not take IsolateGroup::type_feedback_mutex(), so it may miss an entry
+  // added concurrently.
   ObjectPtr Lookup(const Smi& class_id) const;
 
+  struct ProbeStats {
+    intptr_t entries = 0;
+    // The number of probes needed to find each of the entries, in total and
+    // at most.
+    intptr_t total_probes = 0;
+    intptr_t max_probes = 0;
+  };
+
+  // The probe lengths of the current entries, which are the lengths of the
+  // searches done by the megamorphic call stub when one of them is hit.
+  ProbeStats ComputeProbeStats() const;
+
   static intptr_t InstanceSize() {
     return RoundedAllocationSize(sizeof(UntaggedMegamorphicCache));
   }
@@ -7660,10 +7676,17 @@ class MegamorphicCache : public CallSiteData {
 
   // The caller must hold IsolateGroup::type_feedback_mutex().
   void InsertLocked(const Smi& class_id, const Object& target) const;
-  void EnsureCapacityLocked() const;
   ObjectPtr LookupLocked(const Smi& class_id) const;
 
-  void InsertEntryLocked(const Smi& class_id, const Object& target) const;
+  static ObjectPtr LookupIn(const Array& buckets, const Smi& class_id);
+  // Adds an entry to buckets which are not published yet.
+  static void InsertEntry(const Array& buckets,
+                          const Smi& class_id,
+                          const Object& target);
+
+  // The mask is also stored in the cache, but it does not necessarily belong
+  // to the buckets read concurrently from it.
+  static inline intptr_t MaskOf(const Array& buckets);
 
   static inline void SetEntry(const Array& array,
                               intptr_t index,
@@ -7890,6 +7913,8 @@ class SubtypeTestCache : public Object {
     // be located if added afterwards without any intermediate additions.
     intptr_t entry;
     bool present;  // Whether an entry already exists in the cache.
+    // The number of occupied entries visited before [entry].
+    intptr_t collisions;
   };
 
   // If a cache entry in the given array contains the given inputs, returns a
@@ -7917,10 +7942,14 @@ class SubtypeTestCache : public Object {
   // If the given array cannot contain the requested number of entries,
   // returns a new array that can and which contains all the entries of the
   // given array and sets [was_grown] to true.
+  //
+  // If [force_growth] is true, a hash-based cache is grown even if its load
+  // factor allows the requested number of entries.
   ArrayPtr EnsureCapacity(Zone* zone,
                           const Array& array,
                           intptr_t new_capacity,
-                          bool* was_grown) const;
+                          bool* was_grown,
+                          bool force_growth = false) const;
 
  public:  // Used in the StubCodeCompiler.
   // The maximum size of the array backing a linear cache. All hash based
@@ -7939,6 +7968,14 @@ class SubtypeTestCache : public Object {
   // The max load factor allowed in hash-based caches.
   static constexpr double kMaxLoadFactor = 0.71;
 
+  // Hash-based caches are grown before reaching kMaxLoadFactor if adding an
+  // entry collides with more than kMaxCollisions occupied entries, as every
+  // lookup of that entry in the stubs has to step over them. Caches are only
+  // grown early if they are at least kMinLoadFactorForEarlyGrowth full, so
+  // that inputs with identical hashes cannot make a cache grow repeatedly.
+  static constexpr intptr_t kMaxCollisions = 8;
+  static constexpr double kMinLoadFactorForEarlyGrowth = 0.35;
+
   void set_cache(const Array& value) const;
   void set_num_occupied(intptr_t value) const;
 
@@ -10628,6 +10665,20 @@ class OneByteString : public AllStatic {
                                     const String& str,
                                     Heap::Space space);
 
+  // Maps the letters in [first, last] of "str" to the other case. Returns
+  // null if "str" is not all ASCII, as some other Latin-1 letters map to
+  // two-byte code units.
+  static OneByteStringPtr SwitchAsciiCase(const String& str,
+                                          uint8_t first,
+                                          uint8_t last,
+                                          Heap::Space space);
+
+  // Returns the index of the first occurrence of "pattern" in "str" at or
+  // after "start", or -1. Both must be OneByteStrings.
+  static intptr_t IndexOf(const String& str,
+                          const String& pattern,
+                          intptr_t start);
+
   // High performance version of substring for one-byte strings.
   // "str" must be OneByteString.
   static OneByteStringPtr SubStringUnchecked(const String& str,
@@ -13381,6 +13432,10 @@ void MegamorphicCache::SetEntry(const Array& array,
   array.SetAt((index * kEntryLength) + kTargetFunctionIndex, target);
 }
 
+intptr_t MegamorphicCache::MaskOf(const Array& buckets) {
+  return buckets.Length() / kEntryLength - 1;
+}
+
 ObjectPtr MegamorphicCache::GetClassId(const Array& array, intptr_t index) {
   return array.At((index * kEntryLength) + kClassIdIndex);
 }
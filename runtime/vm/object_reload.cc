@@ -40,6 +40,17 @@ void CallSiteResetter::ZeroEdgeCounters(const Function& function) {
   }
 }
 
+void CallSiteResetter::ClearOsrCode(const Function& function) {
+  ic_data_array_ = function.ic_data_array();
+  if (ic_data_array_.IsNull()) {
+    return;
+  }
+  // Cached OSR code may have inlined or specialized on code which was
+  // reloaded, even when the unoptimized code it was compiled against is kept.
+  ic_data_array_.SetAt(Function::ICDataArrayIndices::kOsrCode,
+                       Object::null_object());
+}
+
 CallSiteResetter::CallSiteResetter(Zone* zone)
     : zone_(zone),
       instrs_(Instructions::Handle(zone)),
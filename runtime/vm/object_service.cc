@@ -1155,6 +1155,10 @@ void MegamorphicCache::PrintJSONImpl(JSONStream* stream, bool ref) const {
   jsobj.AddProperty("_mask", mask());
   jsobj.AddProperty("_argumentsDescriptor",
                     Object::Handle(arguments_descriptor()));
+  const ProbeStats stats = ComputeProbeStats();
+  jsobj.AddProperty("_filledEntryCount", stats.entries);
+  jsobj.AddProperty("_totalProbeLength", stats.total_probes);
+  jsobj.AddProperty("_maxProbeLength", stats.max_probes);
 }
 
 void MegamorphicCache::PrintImplementationFieldsImpl(
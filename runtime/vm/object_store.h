@@ -165,6 +165,7 @@ class ObjectPointerVisitor;
   RW(Array, loading_units)                                                     \
   RW(GrowableObjectArray, closure_functions)                                   \
   RW(Array, closure_functions_table)                                           \
+  RW(Array, closure_functions_indices)                                         \
   RW(GrowableObjectArray, pending_classes)                                     \
   RW(Array, record_field_names_map)                                            \
   ARW_RELAXED(Array, record_field_names)                                       \
@@ -292,6 +293,7 @@ class ObjectPointerVisitor;
   RW(Array, dispatch_table_code_entries)                                       \
   RW(GrowableObjectArray, instructions_tables)                                 \
   RW(Array, obfuscation_map)                                                   \
+  RW(Array, executed_block_counts)                                             \
   RW(Array, loading_unit_uris)                                                 \
   RW(Class, ffi_pointer_class)                                                 \
   RW(Class, ffi_native_type_class)                                             \
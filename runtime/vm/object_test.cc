@@ -5341,6 +5341,64 @@ ISOLATE_UNIT_TEST_CASE(FindClosureIndex) {
   EXPECT_EQ(func_from_index.ptr(), function.ptr());
 }
 
+ISOLATE_UNIT_TEST_CASE(FindClosureIndex_Many) {
+  const String& class_name = String::Handle(Symbols::New(thread, "MyClass"));
+  const Script& script = Script::Handle();
+  const Class& cls = Class::Handle(CreateDummyClass(class_name, script));
+  const Array& functions = Array::Handle(Array::New(1));
+  const String& parent_name = String::Handle(Symbols::New(thread, "foo_papa"));
+  const FunctionType& signature = FunctionType::ZoneHandle(FunctionType::New());
+  const Function& parent = Function::Handle(Function::New(
+      signature, parent_name, UntaggedFunction::kRegularFunction, false, false,
+      false, false, false, cls, TokenPosition::kMinSource));
+  functions.SetAt(0, parent);
+  {
+    SafepointWriteRwLocker ml(thread, thread->isolate_group()->program_lock());
+    cls.SetFunctions(functions);
+  }
+
+  const intptr_t kNumClosures = 1000;
+  const String& function_name = String::Handle(Symbols::New(thread, "foo"));
+  const Array& closures = Array::Handle(Array::New(kNumClosures));
+  Function& function = Function::Handle();
+  auto add_closure = [&](intptr_t i) {
+    function = Function::NewClosureFunction(function_name, parent,
+                                            TokenPosition::Deserialize(i));
+    function.set_kernel_offset(i + 1);
+    closures.SetAt(i, function);
+    SafepointWriteRwLocker ml(thread, thread->isolate_group()->program_lock());
+    ClosureFunctionsCache::AddClosureFunctionLocked(function);
+  };
+
+  // The index is built by the first lookup and then updated as closure
+  // functions are added.
+  for (intptr_t i = 0; i < kNumClosures / 2; i++) {
+    add_closure(i);
+  }
+  function ^= closures.At(0);
+  const intptr_t first_index =
+      ClosureFunctionsCache::FindClosureIndex(function);
+  EXPECT_GE(first_index, 0);
+  for (intptr_t i = kNumClosures / 2; i < kNumClosures; i++) {
+    add_closure(i);
+  }
+  for (intptr_t i = 0; i < kNumClosures; i++) {
+    function ^= closures.At(i);
+    EXPECT_EQ(first_index + i,
+              ClosureFunctionsCache::FindClosureIndex(function));
+  }
+  EXPECT_EQ(-1, ClosureFunctionsCache::FindClosureIndex(parent));
+
+  // The index is rebuilt after being reset.
+  {
+    SafepointWriteRwLocker ml(thread, thread->isolate_group()->program_lock());
+    ClosureFunctionsCache::ResetClosureIndicesLocked();
+  }
+  function ^= closures.At(kNumClosures - 1);
+  EXPECT_EQ(first_index + kNumClosures - 1,
+            ClosureFunctionsCache::FindClosureIndex(function));
+}
+
 ISOLATE_UNIT_TEST_CASE(FindInvocationDispatcherFunctionIndex) {
   const String& class_name = String::Handle(Symbols::New(thread, "MyClass"));
   const Script& script = Script::Handle();
@@ -7309,6 +7367,34 @@ ISOLATE_UNIT_TEST_CASE(Symbols_FromConcatAll) {
   }
 }
 
+ISOLATE_UNIT_TEST_CASE(Symbols_NewAll) {
+  Zone* zone = thread->zone();
+  const String& existing =
+      String::Handle(zone, Symbols::New(thread, "Symbols_NewAll_existing"));
+  const Array& strings = Array::Handle(zone, Array::New(5));
+  String& str = String::Handle(zone);
+  strings.SetAt(0, existing);
+  str = String::New("Symbols_NewAll_existing");
+  strings.SetAt(1, str);
+  str = String::New("Symbols_NewAll_new");
+  strings.SetAt(2, str);
+  str = String::New("Symbols_NewAll_new");
+  strings.SetAt(3, str);
+  str = String::New("Dot");
+  strings.SetAt(4, str);
+  Symbols::NewAll(thread, strings);
+
+  for (intptr_t i = 0; i < strings.Length(); i++) {
+    str ^= strings.At(i);
+    EXPECT(str.IsSymbol());
+  }
+  EXPECT_EQ(existing.ptr(), strings.At(0));
+  EXPECT_EQ(existing.ptr(), strings.At(1));
+  EXPECT_EQ(strings.At(2), strings.At(3));
+  EXPECT_EQ(Symbols::New(thread, "Symbols_NewAll_new"), strings.At(2));
+  EXPECT_EQ(Symbols::New(thread, "Dot"), strings.At(4));
+}
+
 struct TestResult {
   const char* in;
   const char* out;
@@ -8490,4 +8576,20 @@ TEST_CASE(STC_HashLookup) {
                        /*expect_hash=*/true);
 }
 
+TEST_CASE(STC_Metrics) {
+  auto isolate_group = thread->isolate_group();
+  auto entries = isolate_group->GetSubtypeTestCacheEntriesMetric();
+  auto capacity = isolate_group->GetSubtypeTestCacheCapacityMetric();
+  const int64_t entries_before = entries->value();
+  const int64_t capacity_before = capacity->value();
+
+  const intptr_t num_classes = 2 * SubtypeTestCache::kMaxLinearCacheEntries;
+  SubtypeTestCacheTest(thread, num_classes, /*expect_hash=*/true);
+
+  // Running the test may also add entries to caches of the test program.
+  const int64_t added = SubtypeTestCache::kMaxInputs * num_classes;
+  EXPECT_GE(entries->value() - entries_before, added);
+  EXPECT_GE(capacity->value() - capacity_before, added);
+}
+
 }  // namespace dart
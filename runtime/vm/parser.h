@@ -208,6 +208,16 @@ class ParsedFunction : public ZoneAllocated {
     forwarding_stub_super_target_ = forwarding_target;
   }
 
+  // The classes of the values OSR code is entered with, indexed by
+  // environment index, or nullptr if the OSR entry is not specialized.
+  // kDynamicCid marks values of any class.
+  const ZoneGrowableArray<intptr_t>* osr_entry_cids() const {
+    return osr_entry_cids_;
+  }
+  void set_osr_entry_cids(const ZoneGrowableArray<intptr_t>* cids) {
+    osr_entry_cids_ = cids;
+  }
+
   Thread* thread() const { return thread_; }
   Isolate* isolate() const { return thread_->isolate(); }
   Zone* zone() const { return thread_->zone(); }
@@ -319,6 +329,7 @@ class ParsedFunction : public ZoneAllocated {
   bool have_seen_await_expr_;
 
   const Function* forwarding_stub_super_target_ = nullptr;
+  const ZoneGrowableArray<intptr_t>* osr_entry_cids_ = nullptr;
   kernel::ScopeBuildingResult* kernel_scopes_;
 
   const BitVector* covariant_parameters_ = nullptr;
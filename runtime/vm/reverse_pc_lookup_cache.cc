@@ -4,6 +4,9 @@
 
 #include "vm/reverse_pc_lookup_cache.h"
 
+#include <atomic>
+
+#include "vm/flags.h"
 #include "vm/isolate.h"
 #include "vm/object.h"
 #include "vm/object_store.h"
@@ -11,6 +14,58 @@
 
 namespace dart {
 
+DEFINE_FLAG(bool,
+            reverse_pc_cache,
+            true,
+            "Cache the stack maps found for return addresses.");
+
+const UntaggedCompressedStackMaps::Payload* ReversePcCache::Lookup(
+    uword pc,
+    uword* code_start,
+    const UntaggedCompressedStackMaps::Payload** global_table) const {
+  const Entry& entry = entries_[IndexOf(pc)];
+  const uword sequence = entry.sequence.load(std::memory_order_acquire);
+  if ((sequence & 1) != 0) return nullptr;
+  const uword entry_pc = entry.pc.load();
+  const uword entry_generation = entry.generation.load();
+  const uword entry_code_start = entry.code_start.load();
+  const auto entry_map = entry.map.load();
+  const auto entry_global_table = entry.global_table.load();
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (entry.sequence.load() != sequence) return nullptr;
+  if (entry_pc != pc || entry_map == nullptr ||
+      entry_generation != generation_.load(std::memory_order_acquire)) {
+    return nullptr;
+  }
+  *code_start = entry_code_start;
+  *global_table = entry_global_table;
+  return entry_map;
+}
+
+void ReversePcCache::Insert(
+    uword pc,
+    uword code_start,
+    const UntaggedCompressedStackMaps::Payload* map,
+    const UntaggedCompressedStackMaps::Payload* global_table) {
+  Entry& entry = entries_[IndexOf(pc)];
+  uword sequence = entry.sequence.load();
+  if ((sequence & 1) != 0 ||
+      !entry.sequence.compare_exchange_strong(sequence, sequence + 1,
+                                              std::memory_order_acquire)) {
+    // Another thread is writing this entry.
+    return;
+  }
+  // Keeps the stores below from becoming visible before the odd sequence,
+  // which readers would otherwise accept as a consistent entry.
+  std::atomic_thread_fence(std::memory_order_release);
+  entry.pc.store(pc);
+  entry.generation.store(generation_.load(std::memory_order_acquire));
+  entry.code_start.store(code_start);
+  entry.map.store(map);
+  entry.global_table.store(global_table);
+  entry.sequence.store(sequence + 2, std::memory_order_release);
+}
+
 CodePtr ReversePc::FindCodeInGroup(IsolateGroup* group,
                                    uword pc,
                                    bool is_return_address) {
@@ -85,12 +140,25 @@ const UntaggedCompressedStackMaps::Payload* ReversePc::FindStackMap(
   ASSERT(FLAG_precompiled_mode);
   NoSafepointScope no_safepoint;
 
+  // The cache is keyed on the pc inside the call instruction, like the
+  // table lookups below.
+  const uword key = is_return_address ? pc - 1 : pc;
+  ReversePcCache* cache =
+      FLAG_reverse_pc_cache ? group->reverse_pc_cache() : nullptr;
+  if (cache != nullptr) {
+    auto map = cache->Lookup(key, code_start, global_table);
+    if (map != nullptr) return map;
+  }
+
   auto map = FindStackMapInGroup(group, pc, is_return_address, code_start,
                                  global_table);
   if (map == nullptr) {
     map = FindStackMapInGroup(Dart::vm_isolate_group(), pc, is_return_address,
                               code_start, global_table);
   }
+  if (map != nullptr && cache != nullptr) {
+    cache->Insert(key, *code_start, map, *global_table);
+  }
   return map;
 }
 
@@ -5,6 +5,7 @@
 #ifndef RUNTIME_VM_REVERSE_PC_LOOKUP_CACHE_H_
 #define RUNTIME_VM_REVERSE_PC_LOOKUP_CACHE_H_
 
+#include "platform/atomic.h"
 #include "vm/allocation.h"
 #include "vm/globals.h"
 #include "vm/raw_object.h"
@@ -14,6 +15,63 @@ namespace dart {
 
 class IsolateGroup;
 
+// A direct-mapped cache from return addresses to the results of
+// ReversePc::FindStackMap, which otherwise binary searches the instructions
+// tables of every loading unit for every frame visited by the GC.
+//
+// Lookups and insertions are lock-free and may happen concurrently from
+// several GC helper threads. Each entry is protected by a sequence number
+// which is odd while the entry is being written: readers treat entries which
+// are being written or changed under them as misses, and writers skip
+// entries which are being written by another thread.
+//
+// Cached stack maps and code starts refer to instructions images, which
+// stay mapped as long as their isolate group, so entries never dangle. The
+// cache is nevertheless cleared when a loading unit adds an instructions
+// table, so that lookups always reflect the current list of tables.
+class ReversePcCache {
+ public:
+  static constexpr intptr_t kNumEntries = 1024;
+
+  ReversePcCache() {}
+
+  // Returns the cached stack map of the code containing [pc] and sets
+  // [*code_start] and [*global_table], or returns nullptr on a miss.
+  const UntaggedCompressedStackMaps::Payload* Lookup(
+      uword pc,
+      uword* code_start,
+      const UntaggedCompressedStackMaps::Payload** global_table) const;
+
+  void Insert(uword pc,
+              uword code_start,
+              const UntaggedCompressedStackMaps::Payload* map,
+              const UntaggedCompressedStackMaps::Payload* global_table);
+
+  // Invalidates all entries.
+  void Clear() { generation_.fetch_add(1, std::memory_order_acq_rel); }
+
+ private:
+  struct Entry {
+    RelaxedAtomic<uword> sequence = {0};
+    RelaxedAtomic<uword> generation = {0};
+    RelaxedAtomic<uword> pc = {0};
+    RelaxedAtomic<uword> code_start = {0};
+    RelaxedAtomic<const UntaggedCompressedStackMaps::Payload*> map = {nullptr};
+    RelaxedAtomic<const UntaggedCompressedStackMaps::Payload*> global_table = {
+        nullptr};
+  };
+
+  static intptr_t IndexOf(uword pc) {
+    return (pc ^ (pc >> 10)) & (kNumEntries - 1);
+  }
+
+  // Starts at 1 so that zero-initialized entries never match.
+  RelaxedAtomic<uword> generation_ = {1};
+  Entry entries_[kNumEntries];
+
+  DISALLOW_COPY_AND_ASSIGN(ReversePcCache);
+};
+
 // This class provides mechanism to find Code and CompressedStackMaps
 // objects corresponding to the given PC.
 // Can only be used in AOT runtime with bare instructions.
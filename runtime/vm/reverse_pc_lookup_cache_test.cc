@@ -0,0 +1,121 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/reverse_pc_lookup_cache.h"
+
+#include <memory>
+
+#include "platform/assert.h"
+#include "vm/random.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+static const UntaggedCompressedStackMaps::Payload* FakeMap(uword value) {
+  return reinterpret_cast<const UntaggedCompressedStackMaps::Payload*>(value);
+}
+
+UNIT_TEST_CASE(ReversePcCache_LookupAndInsert) {
+  auto cache = std::make_unique<ReversePcCache>();
+  uword code_start = 0;
+  const UntaggedCompressedStackMaps::Payload* global_table = nullptr;
+
+  EXPECT(cache->Lookup(0x1234, &code_start, &global_table) == nullptr);
+  EXPECT(cache->Lookup(0, &code_start, &global_table) == nullptr);
+
+  cache->Insert(0x1234, 0x1200, FakeMap(0x100), FakeMap(0x200));
+  EXPECT(cache->Lookup(0x1234, &code_start, &global_table) == FakeMap(0x100));
+  EXPECT_EQ(0x1200, code_start);
+  EXPECT(global_table == FakeMap(0x200));
+
+  // A pc mapping to the same entry replaces it.
+  const uword other_pc = 0x2238;
+  cache->Insert(other_pc, 0x1500, FakeMap(0x300), nullptr);
+  EXPECT(cache->Lookup(0x1234, &code_start, &global_table) == nullptr);
+  EXPECT(cache->Lookup(other_pc, &code_start, &global_table) ==
+         FakeMap(0x300));
+  EXPECT_EQ(0x1500, code_start);
+  EXPECT(global_table == nullptr);
+}
+
+UNIT_TEST_CASE(ReversePcCache_Clear) {
+  auto cache = std::make_unique<ReversePcCache>();
+  uword code_start = 0;
+  const UntaggedCompressedStackMaps::Payload* global_table = nullptr;
+
+  cache->Insert(0x1234, 0x1200, FakeMap(0x100), nullptr);
+  cache->Clear();
+  EXPECT(cache->Lookup(0x1234, &code_start, &global_table) == nullptr);
+
+  cache->Insert(0x1234, 0x1200, FakeMap(0x100), nullptr);
+  EXPECT(cache->Lookup(0x1234, &code_start, &global_table) == FakeMap(0x100));
+}
+
+class ReversePcCacheStressTask : public ThreadPool::Task {
+ public:
+  ReversePcCacheStressTask(ReversePcCache* cache,
+                           ThreadBarrier* barrier,
+                           RelaxedAtomic<intptr_t>* failures,
+                           uint64_t seed)
+      : cache_(cache), barrier_(barrier), failures_(failures), rng_(seed) {}
+
+  virtual void Run() {
+    for (intptr_t i = 0; i < kNumIterations; ++i) {
+      // Few distinct entries, so that threads keep racing on each of them.
+      const uint32_t r = rng_.NextUInt32();
+      const uword pc = (static_cast<uword>(r % 64) << 20) | ((r % 4) << 3);
+      uword code_start = 0;
+      const UntaggedCompressedStackMaps::Payload* global_table = nullptr;
+      auto map = cache_->Lookup(pc, &code_start, &global_table);
+      if (map == nullptr) {
+        cache_->Insert(pc, CodeStartOf(pc), MapOf(pc), GlobalTableOf(pc));
+      } else if (map != MapOf(pc) || code_start != CodeStartOf(pc) ||
+                 global_table != GlobalTableOf(pc)) {
+        failures_->fetch_add(1);
+      }
+      if ((r % 1000) == 0) {
+        cache_->Clear();
+      }
+    }
+    barrier_->Sync();
+    barrier_->Release();
+  }
+
+  static constexpr intptr_t kNumIterations = 100000;
+
+ private:
+  // Every field of an entry is derived from its pc, so a lookup that mixes
+  // two writes is detected.
+  static uword CodeStartOf(uword pc) { return pc ^ 0x5a50; }
+  static const UntaggedCompressedStackMaps::Payload* MapOf(uword pc) {
+    return FakeMap(pc + 0x100);
+  }
+  static const UntaggedCompressedStackMaps::Payload* GlobalTableOf(uword pc) {
+    return FakeMap(~pc);
+  }
+
+  ReversePcCache* const cache_;
+  ThreadBarrier* const barrier_;
+  RelaxedAtomic<intptr_t>* const failures_;
+  Random rng_;
+};
+
+VM_UNIT_TEST_CASE(ReversePcCache_ConcurrentInsertAndLookup) {
+  const intptr_t kNumTasks = 4;
+  auto cache = std::make_unique<ReversePcCache>();
+  RelaxedAtomic<intptr_t> failures = {0};
+
+  ThreadBarrier* barrier = new ThreadBarrier(kNumTasks + 1, kNumTasks + 1);
+  for (intptr_t i = 0; i < kNumTasks; ++i) {
+    Dart::thread_pool()->Run<ReversePcCacheStressTask>(cache.get(), barrier,
+                                                       &failures, i + 1);
+  }
+  barrier->Sync();
+  barrier->Release();
+  EXPECT_EQ(0, failures.load());
+}
+
+}  // namespace dart
@@ -1049,8 +1049,10 @@ static void UpdateTypeTestCache(
     THR_Print("%s", buffer.buffer());
   }
   {
-    SafepointMutexLocker ml(
-        thread->isolate_group()->subtype_test_cache_mutex());
+    auto isolate_group = thread->isolate_group();
+    SafepointMutexLocker ml(isolate_group->subtype_test_cache_mutex());
+    // The stubs missed the cache, or could not search it.
+    isolate_group->GetSubtypeTestCacheRuntimeLookupsMetric()->increment();
     const intptr_t len = new_cache.NumberOfChecks();
     if (len >= FLAG_max_subtype_cache_entries) {
       if (FLAG_trace_type_checks) {
@@ -1080,6 +1082,7 @@ static void UpdateTypeTestCache(
       }
       // Some other isolate might have updated the cache between entry was
       // found missing and now.
+      isolate_group->GetSubtypeTestCacheRuntimeHitsMetric()->increment();
       return;
     }
     const intptr_t new_index = new_cache.AddCheck(
@@ -3120,11 +3123,43 @@ static void HandleOSRRequest(Thread* thread) {
                  function.usage_counter());
   }
 
-  // Since the code is referenced from the frame and the ZoneHandle,
-  // it cannot have been removed from the function.
-  const Object& result = Object::Handle(
-      Compiler::CompileOptimizedFunction(thread, function, osr_id));
-  ThrowIfError(result);
+  // Reuse the code compiled for an earlier request at the same loop if it can
+  // be entered with the values in this frame.
+  bool specialize = false;
+  Object& result = Object::Handle(
+      Compiler::LookupOsrCode(thread, function, osr_id, frame->fp(),
+                              &specialize));
+  const bool reused = !result.IsNull();
+  if (!reused) {
+    // Since the code is referenced from the frame and the ZoneHandle,
+    // it cannot have been removed from the function.
+    result = Compiler::CompileOptimizedFunction(
+        thread, function, osr_id, specialize ? frame->fp() : 0);
+    ThrowIfError(result);
+  }
+  if (FLAG_trace_osr && reused) {
+    OS::PrintErr("Reusing OSR code for %s at id=%" Pd "\n",
+                 function.ToFullyQualifiedCString(), osr_id);
+  }
+#if !defined(PRODUCT)
+  if (!result.IsNull()) {
+    Isolate* isolate = thread->isolate();
+    Metric* metric = reused ? isolate->GetOsrCodeReusesMetric()
+                            : isolate->GetOsrCompilationsMetric();
+    metric->increment();
+    TimelineStream* stream = Timeline::GetCompilerStream();
+    TimelineEvent* event = stream->StartEvent();
+    if (event != nullptr) {
+      event->Counter("OSR");
+      event->SetNumArguments(2);
+      event->FormatArgument(0, "compilations", "%" Pd64,
+                            isolate->GetOsrCompilationsMetric()->value());
+      event->FormatArgument(1, "reuses", "%" Pd64,
+                            isolate->GetOsrCodeReusesMetric()->value());
+      event->Complete();
+    }
+  }
+#endif  // !defined(PRODUCT)
 
   if (!result.IsNull()) {
     const Code& code = Code::Cast(result);
@@ -3617,6 +3652,12 @@ DEFINE_LEAF_RUNTIME_ENTRY(intptr_t,
       THR_Print("Eager deopt fp=%" Pp " pc=%" Pp "\n", caller_frame->fp(),
                 caller_frame->pc());
     }
+    if (optimized_code.ptr() != top_function.CurrentCode()) {
+      // OSR code failed a speculative check. Keep it from being entered
+      // again through the OSR code cache (see Compiler::LookupOsrCode), so
+      // the next OSR request compiles code using the updated feedback.
+      optimized_code.set_is_alive(false);
+    }
   }
 
   // Copy the saved registers from the stack.
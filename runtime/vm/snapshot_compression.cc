@@ -0,0 +1,312 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/snapshot_compression.h"
+
+#include "platform/atomic.h"
+#include "platform/unaligned.h"
+#include "platform/utils.h"
+#include "vm/dart.h"
+#include "vm/thread_barrier.h"
+#include "vm/thread_pool.h"
+
+namespace dart {
+
+static constexpr intptr_t kHashBits = 14;
+static constexpr intptr_t kHashTableSize = 1 << kHashBits;
+static constexpr intptr_t kMaxOffset = 0xffff;
+static constexpr intptr_t kNibbleMask = 0xf;
+static constexpr intptr_t kLiteralsShift = 4;
+
+static constexpr intptr_t kHeaderSize = 2 * sizeof(uint32_t);
+
+static uint32_t Hash(const uint8_t* data) {
+  return (LoadUnaligned(reinterpret_cast<const uint32_t*>(data)) *
+          2654435761U) >>
+         (32 - kHashBits);
+}
+
+static void WriteLengthExtension(BaseWriteStream* stream, intptr_t length) {
+  ASSERT(length >= kNibbleMask);
+  length -= kNibbleMask;
+  while (length >= 0xff) {
+    stream->WriteByte(0xff);
+    length -= 0xff;
+  }
+  stream->WriteByte(static_cast<uint8_t>(length));
+}
+
+static bool ReadLengthExtension(const uint8_t** cursor,
+                                const uint8_t* end,
+                                intptr_t* length) {
+  uint8_t byte;
+  do {
+    if (*cursor >= end) return false;
+    byte = *(*cursor)++;
+    *length += byte;
+  } while (byte == 0xff);
+  return true;
+}
+
+// Writes [num_literals] bytes from [literals] followed by a match of
+// [match_length] bytes at [offset]. A [match_length] of 0 ends the block.
+static void WriteSequence(BaseWriteStream* stream,
+                          const uint8_t* literals,
+                          intptr_t num_literals,
+                          intptr_t offset,
+                          intptr_t match_length) {
+  const intptr_t match_code =
+      match_length == 0 ? 0 : match_length - SnapshotCompression::kMinMatch;
+  stream->WriteByte(static_cast<uint8_t>(
+      (Utils::Minimum(num_literals, kNibbleMask) << kLiteralsShift) |
+      Utils::Minimum(match_code, kNibbleMask)));
+  if (num_literals >= kNibbleMask) {
+    WriteLengthExtension(stream, num_literals);
+  }
+  stream->WriteBytes(literals, num_literals);
+  if (match_length == 0) return;
+  stream->WriteByte(static_cast<uint8_t>(offset & 0xff));
+  stream->WriteByte(static_cast<uint8_t>(offset >> 8));
+  if (match_code >= kNibbleMask) {
+    WriteLengthExtension(stream, match_code);
+  }
+}
+
+static void CompressBlock(const uint8_t* data,
+                          intptr_t length,
+                          intptr_t* table,
+                          BaseWriteStream* stream) {
+  for (intptr_t i = 0; i < kHashTableSize; i++) {
+    table[i] = -1;
+  }
+  const intptr_t kMinMatch = SnapshotCompression::kMinMatch;
+  intptr_t anchor = 0;
+  intptr_t position = 0;
+  while (position + kMinMatch <= length) {
+    const uint32_t hash = Hash(data + position);
+    const intptr_t candidate = table[hash];
+    table[hash] = position;
+    if (candidate < 0 || position - candidate > kMaxOffset ||
+        memcmp(data + candidate, data + position, kMinMatch) != 0) {
+      position++;
+      continue;
+    }
+    intptr_t match_length = kMinMatch;
+    while (position + match_length < length &&
+           data[candidate + match_length] == data[position + match_length]) {
+      match_length++;
+    }
+    WriteSequence(stream, data + anchor, position - anchor,
+                  position - candidate, match_length);
+    position += match_length;
+    anchor = position;
+  }
+  WriteSequence(stream, data + anchor, length - anchor, 0, 0);
+}
+
+static bool DecompressBlock(const uint8_t* data,
+                            intptr_t length,
+                            uint8_t* out,
+                            intptr_t out_length) {
+  const uint8_t* cursor = data;
+  const uint8_t* end = data + length;
+  uint8_t* out_cursor = out;
+  uint8_t* out_end = out + out_length;
+  while (cursor < end) {
+    const uint8_t token = *cursor++;
+    intptr_t num_literals = token >> kLiteralsShift;
+    if (num_literals == kNibbleMask &&
+        !ReadLengthExtension(&cursor, end, &num_literals)) {
+      return false;
+    }
+    if (num_literals > end - cursor || num_literals > out_end - out_cursor) {
+      return false;
+    }
+    memmove(out_cursor, cursor, num_literals);
+    cursor += num_literals;
+    out_cursor += num_literals;
+    if (cursor == end) break;
+
+    if (end - cursor < 2) return false;
+    const intptr_t offset = cursor[0] | (cursor[1] << 8);
+    cursor += 2;
+    intptr_t match_length = token & kNibbleMask;
+    if (match_length == kNibbleMask &&
+        !ReadLengthExtension(&cursor, end, &match_length)) {
+      return false;
+    }
+    match_length += SnapshotCompression::kMinMatch;
+    if (offset == 0 || offset > out_cursor - out ||
+        match_length > out_end - out_cursor) {
+      return false;
+    }
+    // The match may overlap the bytes it produces, so copy byte by byte.
+    const uint8_t* match = out_cursor - offset;
+    for (intptr_t i = 0; i < match_length; i++) {
+      out_cursor[i] = match[i];
+    }
+    out_cursor += match_length;
+  }
+  return out_cursor == out_end;
+}
+
+void SnapshotCompression::Compress(const uint8_t* data,
+                                   intptr_t length,
+                                   NonStreamingWriteStream* stream) {
+  const intptr_t num_blocks = Utils::RoundUp(length, kBlockSize) / kBlockSize;
+  stream->WriteFixed<uint32_t>(length);
+  stream->WriteFixed<uint32_t>(num_blocks);
+
+  // The block sizes are only known once the blocks are written, so the block
+  // table is filled in afterwards.
+  const intptr_t table_position = stream->Position();
+  for (intptr_t i = 0; i < num_blocks; i++) {
+    stream->WriteFixed<uint32_t>(0);
+  }
+  uint32_t* block_sizes =
+      reinterpret_cast<uint32_t*>(malloc(num_blocks * sizeof(uint32_t)));
+  intptr_t* hash_table =
+      reinterpret_cast<intptr_t*>(malloc(kHashTableSize * sizeof(intptr_t)));
+  for (intptr_t i = 0; i < num_blocks; i++) {
+    const intptr_t start = i * kBlockSize;
+    const intptr_t block_length = Utils::Minimum(kBlockSize, length - start);
+    const intptr_t block_start = stream->Position();
+    CompressBlock(data + start, block_length, hash_table, stream);
+    block_sizes[i] = stream->Position() - block_start;
+  }
+  free(hash_table);
+
+  const intptr_t end_position = stream->Position();
+  stream->SetPosition(table_position);
+  for (intptr_t i = 0; i < num_blocks; i++) {
+    stream->WriteFixed<uint32_t>(block_sizes[i]);
+  }
+  stream->SetPosition(end_position);
+  free(block_sizes);
+}
+
+intptr_t SnapshotCompression::UncompressedLength(const uint8_t* data,
+                                                 intptr_t length) {
+  if (length < kHeaderSize) return -1;
+  const intptr_t uncompressed_length =
+      LoadUnaligned(reinterpret_cast<const uint32_t*>(data));
+  const intptr_t num_blocks =
+      LoadUnaligned(reinterpret_cast<const uint32_t*>(data) + 1);
+  if (num_blocks !=
+      Utils::RoundUp(uncompressed_length, kBlockSize) / kBlockSize) {
+    return -1;
+  }
+  if (num_blocks > (length - kHeaderSize) /
+                       static_cast<intptr_t>(sizeof(uint32_t))) {
+    return -1;
+  }
+  return uncompressed_length;
+}
+
+class DecompressTask : public ThreadPool::Task {
+ public:
+  DecompressTask(const uint8_t* data,
+                 const intptr_t* block_starts,
+                 intptr_t num_blocks,
+                 uint8_t* out,
+                 intptr_t out_length,
+                 RelaxedAtomic<intptr_t>* next_block,
+                 RelaxedAtomic<bool>* failed,
+                 ThreadBarrier* barrier)
+      : data_(data),
+        block_starts_(block_starts),
+        num_blocks_(num_blocks),
+        out_(out),
+        out_length_(out_length),
+        next_block_(next_block),
+        failed_(failed),
+        barrier_(barrier) {}
+
+  void Run() override {
+    if (!barrier_->TryEnter()) {
+      barrier_->Release();
+      return;
+    }
+
+    DecompressBlocks();
+
+    // This task is done. Notify the original thread.
+    barrier_->Sync();
+    barrier_->Release();
+  }
+
+  void DecompressBlocks() {
+    const intptr_t kBlockSize = SnapshotCompression::kBlockSize;
+    while (true) {
+      const intptr_t i = next_block_->fetch_add(1u);
+      if (i >= num_blocks_) break;
+      const intptr_t out_start = i * kBlockSize;
+      if (!DecompressBlock(
+              data_ + block_starts_[i], block_starts_[i + 1] - block_starts_[i],
+              out_ + out_start,
+              Utils::Minimum(kBlockSize, out_length_ - out_start))) {
+        failed_->store(true);
+      }
+    }
+  }
+
+ private:
+  const uint8_t* data_;
+  const intptr_t* block_starts_;
+  const intptr_t num_blocks_;
+  uint8_t* out_;
+  const intptr_t out_length_;
+  RelaxedAtomic<intptr_t>* next_block_;
+  RelaxedAtomic<bool>* failed_;
+  ThreadBarrier* barrier_;
+
+  DISALLOW_COPY_AND_ASSIGN(DecompressTask);
+};
+
+bool SnapshotCompression::Decompress(const uint8_t* data,
+                                     intptr_t length,
+                                     uint8_t* out,
+                                     intptr_t num_tasks) {
+  const intptr_t out_length = UncompressedLength(data, length);
+  if (out_length < 0) return false;
+  const intptr_t num_blocks =
+      LoadUnaligned(reinterpret_cast<const uint32_t*>(data) + 1);
+
+  // Offsets of the compressed blocks in [data], plus the end of the last one.
+  intptr_t* block_starts = reinterpret_cast<intptr_t*>(
+      malloc((num_blocks + 1) * sizeof(intptr_t)));
+  const uint32_t* block_sizes =
+      reinterpret_cast<const uint32_t*>(data + kHeaderSize);
+  block_starts[0] = kHeaderSize + num_blocks * sizeof(uint32_t);
+  for (intptr_t i = 0; i < num_blocks; i++) {
+    block_starts[i + 1] = block_starts[i] + LoadUnaligned(&block_sizes[i]);
+  }
+  if (block_starts[num_blocks] != length) {
+    free(block_starts);
+    return false;
+  }
+
+  num_tasks = Utils::Maximum<intptr_t>(
+      1, Utils::Minimum<intptr_t>(num_tasks, num_blocks));
+  ThreadBarrier* barrier = new ThreadBarrier(num_tasks, 1);
+  RelaxedAtomic<intptr_t> next_block = {0};
+  RelaxedAtomic<bool> failed = {false};
+  for (intptr_t task_index = 0; task_index < num_tasks - 1; task_index++) {
+    // Begin decompressing on a helper thread.
+    Dart::thread_pool()->Run<DecompressTask>(data, block_starts, num_blocks,
+                                             out, out_length, &next_block,
+                                             &failed, barrier);
+  }
+  // Last worker is the main thread.
+  DecompressTask task(data, block_starts, num_blocks, out, out_length,
+                      &next_block, &failed, barrier);
+  task.DecompressBlocks();
+  barrier->Sync();
+  barrier->Release();
+
+  free(block_starts);
+  return !failed.load();
+}
+
+}  // namespace dart
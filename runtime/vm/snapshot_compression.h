@@ -0,0 +1,59 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_SNAPSHOT_COMPRESSION_H_
+#define RUNTIME_VM_SNAPSHOT_COMPRESSION_H_
+
+#include "vm/allocation.h"
+#include "vm/datastream.h"
+#include "vm/globals.h"
+
+namespace dart {
+
+// A simple LZ77 codec for the clustered part of snapshots.
+//
+// The input is split into blocks of [kBlockSize] bytes which are compressed
+// independently, so they can be decompressed in parallel. The compressed
+// format is:
+//
+//   uint32 uncompressed length
+//   uint32 number of blocks
+//   uint32 compressed length of each block
+//   compressed blocks
+//
+// Each block is a sequence of LZ4-style tokens: the high nibble of the token
+// byte is the number of literals following it, the low nibble is the length
+// of the match minus [kMinMatch], followed by a 16-bit little endian offset.
+// A nibble of 15 is extended by the following bytes until one is not 255.
+// The last token of a block has no match.
+class SnapshotCompression : public AllStatic {
+ public:
+  enum Format : uint8_t {
+    kUncompressed = 0,
+    kBlockLZ77 = 1,
+  };
+
+  static constexpr intptr_t kBlockSize = 256 * KB;
+  static constexpr intptr_t kMinMatch = 4;
+
+  // Appends the compressed form of [data] to [stream].
+  static void Compress(const uint8_t* data,
+                       intptr_t length,
+                       NonStreamingWriteStream* stream);
+
+  // Returns the uncompressed length of [data] or -1 if it is malformed.
+  static intptr_t UncompressedLength(const uint8_t* data, intptr_t length);
+
+  // Decompresses [data] into [out], which must have room for
+  // [UncompressedLength] bytes, using up to [num_tasks] threads. Returns
+  // false if [data] is malformed.
+  static bool Decompress(const uint8_t* data,
+                         intptr_t length,
+                         uint8_t* out,
+                         intptr_t num_tasks);
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_SNAPSHOT_COMPRESSION_H_
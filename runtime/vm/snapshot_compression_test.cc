@@ -0,0 +1,84 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/snapshot_compression.h"
+
+#include "platform/assert.h"
+#include "vm/datastream.h"
+#include "vm/random.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+static void ExpectRoundTrip(const uint8_t* data,
+                            intptr_t length,
+                            intptr_t num_tasks) {
+  MallocWriteStream compressed(1 * KB);
+  SnapshotCompression::Compress(data, length, &compressed);
+  EXPECT_EQ(length, SnapshotCompression::UncompressedLength(
+                        compressed.buffer(), compressed.bytes_written()));
+
+  uint8_t* out = reinterpret_cast<uint8_t*>(malloc(length + 1));
+  EXPECT(SnapshotCompression::Decompress(
+      compressed.buffer(), compressed.bytes_written(), out, num_tasks));
+  EXPECT(memcmp(data, out, length) == 0);
+  free(out);
+}
+
+VM_UNIT_TEST_CASE(SnapshotCompression_RoundTrip) {
+  // Spans several blocks, with a partial last block.
+  const intptr_t kLength = 3 * SnapshotCompression::kBlockSize + 1234;
+  uint8_t* data = reinterpret_cast<uint8_t*>(malloc(kLength));
+  Random random(42);
+
+  // Incompressible data.
+  for (intptr_t i = 0; i < kLength; i++) {
+    data[i] = static_cast<uint8_t>(random.NextUInt32());
+  }
+  ExpectRoundTrip(data, kLength, 1);
+  ExpectRoundTrip(data, kLength, 4);
+
+  // Long runs and repeated fragments, which need the length extensions and
+  // overlapping matches.
+  for (intptr_t i = 0; i < kLength; i++) {
+    data[i] = (i % 1000) < 500 ? 0 : static_cast<uint8_t>(i % 7);
+  }
+  ExpectRoundTrip(data, kLength, 1);
+  ExpectRoundTrip(data, kLength, 4);
+
+  ExpectRoundTrip(data, 0, 2);
+  ExpectRoundTrip(data, 3, 2);
+  free(data);
+}
+
+VM_UNIT_TEST_CASE(SnapshotCompression_Malformed) {
+  const intptr_t kLength = 2 * SnapshotCompression::kBlockSize;
+  uint8_t* data = reinterpret_cast<uint8_t*>(calloc(kLength, 1));
+  MallocWriteStream compressed(1 * KB);
+  SnapshotCompression::Compress(data, kLength, &compressed);
+  uint8_t* out = reinterpret_cast<uint8_t*>(malloc(kLength));
+
+  // Truncated.
+  EXPECT_EQ(-1, SnapshotCompression::UncompressedLength(compressed.buffer(),
+                                                        sizeof(uint32_t)));
+  EXPECT(!SnapshotCompression::Decompress(
+      compressed.buffer(), compressed.bytes_written() - 1, out, 2));
+
+  // Match before the start of the block.
+  const intptr_t num_blocks = 2;
+  uint8_t* first_block =
+      compressed.buffer() + (2 + num_blocks) * sizeof(uint32_t);
+  const uint8_t saved = *first_block;
+  *first_block = 0x0f;  // No literals, followed by a match.
+  EXPECT(!SnapshotCompression::Decompress(
+      compressed.buffer(), compressed.bytes_written(), out, 2));
+  *first_block = saved;
+  EXPECT(SnapshotCompression::Decompress(
+      compressed.buffer(), compressed.bytes_written(), out, 2));
+
+  free(out);
+  free(data);
+}
+
+}  // namespace dart
@@ -22,6 +22,8 @@
 
 namespace dart {
 
+DECLARE_FLAG(bool, compress_snapshot_clusters);
+
 // Check if serialized and deserialized objects are equal.
 static bool Equals(const Object& expected, const Object& actual) {
   if (expected.IsNull()) {
@@ -789,6 +791,96 @@ VM_UNIT_TEST_CASE(FullSnapshot) {
   free(isolate_snapshot_data_buffer);
 }
 
+static ExternalTypedDataPtr KernelComponentOf(const char* class_name) {
+  const auto& lib = Library::Handle(Library::RawCast(
+      Api::UnwrapHandle(TestCase::lib())));
+  const auto& cls = Class::Handle(
+      lib.LookupClass(String::Handle(String::New(class_name))));
+  EXPECT(!cls.IsNull());
+  const auto& info = KernelProgramInfo::Handle(cls.KernelProgramInfo());
+  const auto& component = TypedDataBase::Handle(info.kernel_component());
+  EXPECT(component.IsExternalTypedData());
+  return ExternalTypedData::RawCast(component.ptr());
+}
+
+// The features string leaves the clusters at an arbitrary offset in the
+// snapshot, while the kernel buffers in them are aligned. Check that they are
+// read back intact from compressed clusters.
+VM_UNIT_TEST_CASE(FullSnapshotCompressedExternalTypedData) {
+  SetFlagScope<bool> sfs(&FLAG_compress_snapshot_clusters, true);
+  const char* kScriptChars =
+      "class Sum {\n"
+      "  static int compute(int n) {\n"
+      "    int sum = 0;\n"
+      "    for (int i = 0; i < n; i++) sum += i;\n"
+      "    return sum;\n"
+      "  }\n"
+      "}\n";
+
+  uint8_t* isolate_snapshot_data_buffer;
+  uint8_t* kernel_copy;
+  intptr_t kernel_length;
+  {
+    TestIsolateScope __test_isolate__;
+    TestCase::LoadTestScript(kScriptChars, nullptr);
+
+    Thread* thread = Thread::Current();
+    TransitionNativeToVM transition(thread);
+    StackZone zone(thread);
+    HandleScope scope(thread);
+
+    Dart_Handle result = Api::CheckAndFinalizePendingClasses(thread);
+    {
+      TransitionVMToNative to_native(thread);
+      EXPECT_VALID(result);
+    }
+
+    const auto& kernel = ExternalTypedData::Handle(KernelComponentOf("Sum"));
+    kernel_length = kernel.LengthInBytes();
+    kernel_copy = reinterpret_cast<uint8_t*>(malloc(kernel_length));
+    memmove(kernel_copy, kernel.DataAddr(0), kernel_length);
+
+    MallocWriteStream isolate_snapshot_data(FullSnapshotWriter::kInitialSize);
+    FullSnapshotWriter writer(
+        Snapshot::kFull, /*vm_snapshot_data=*/nullptr, &isolate_snapshot_data,
+        /*vm_image_writer=*/nullptr, /*iso_image_writer=*/nullptr);
+    writer.WriteFullSnapshot();
+    intptr_t unused;
+    isolate_snapshot_data_buffer = isolate_snapshot_data.Steal(&unused);
+  }
+
+  TestCase::CreateTestIsolateFromSnapshot(isolate_snapshot_data_buffer);
+  {
+    Dart_EnterScope();
+    {
+      Thread* thread = Thread::Current();
+      TransitionNativeToVM transition(thread);
+      StackZone zone(thread);
+      HandleScope scope(thread);
+      const auto& kernel =
+          ExternalTypedData::Handle(KernelComponentOf("Sum"));
+      EXPECT_EQ(kernel_length, kernel.LengthInBytes());
+      EXPECT(Utils::IsAligned(
+          reinterpret_cast<uword>(kernel.DataAddr(0)),
+          ExternalTypedData::kDataSerializationAlignment));
+      EXPECT_EQ(0, memcmp(kernel_copy, kernel.DataAddr(0), kernel_length));
+    }
+
+    // Compiling the function reads its body from the kernel buffer.
+    Dart_Handle cls = Dart_GetClass(TestCase::lib(), NewString("Sum"));
+    Dart_Handle arg = Dart_NewInteger(10);
+    Dart_Handle result = Dart_Invoke(cls, NewString("compute"), 1, &arg);
+    EXPECT_VALID(result);
+    int64_t value = 0;
+    EXPECT_VALID(Dart_IntegerToInt64(result, &value));
+    EXPECT_EQ(45, value);
+    Dart_ExitScope();
+  }
+  Dart_ShutdownIsolate();
+  free(kernel_copy);
+  free(isolate_snapshot_data_buffer);
+}
+
 // Helper function to call a top level Dart function and serialize the result.
 static std::unique_ptr<Message> GetSerialized(Dart_Handle lib,
                                               const char* dart_function) {
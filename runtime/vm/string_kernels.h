@@ -0,0 +1,162 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#ifndef RUNTIME_VM_STRING_KERNELS_H_
+#define RUNTIME_VM_STRING_KERNELS_H_
+
+#include <string.h>
+
+#include "platform/unaligned.h"
+#include "vm/allocation.h"
+
+namespace dart {
+
+// Loops over the code units of strings, used by the runtime for long strings.
+//
+// The inner loops process fixed-size chunks without branches, so the C++
+// compiler turns them into SSE/AVX or NEON code for the target the VM is
+// built for, and only check for an early exit between chunks. Equality and
+// search use memcmp and memchr, which the C library implements with the best
+// instructions of the CPU it runs on.
+//
+// Two-byte code units may be unaligned, as they can come from external data.
+class StringKernels : public AllStatic {
+ public:
+  static bool Equals(const uint8_t* a, const uint8_t* b, intptr_t len) {
+    return memcmp(a, b, len) == 0;
+  }
+
+  static bool Equals(const uint16_t* a, const uint16_t* b, intptr_t len) {
+    return memcmp(a, b, len * sizeof(uint16_t)) == 0;
+  }
+
+  static bool Equals(const uint16_t* a, const uint8_t* b, intptr_t len) {
+    intptr_t i = 0;
+    for (; i + kChunkSize <= len; i += kChunkSize) {
+      uint16_t diff = 0;
+      for (intptr_t j = 0; j < kChunkSize; j++) {
+        diff |= LoadUnaligned(&a[i + j]) ^ b[i + j];
+      }
+      if (diff != 0) return false;
+    }
+    uint16_t diff = 0;
+    for (; i < len; i++) {
+      diff |= LoadUnaligned(&a[i]) ^ b[i];
+    }
+    return diff == 0;
+  }
+
+  // Whether all the code units are below 0x80.
+  static bool IsAscii(const uint8_t* data, intptr_t len) {
+    intptr_t i = 0;
+    for (; i + kChunkSize <= len; i += kChunkSize) {
+      uint8_t bits = 0;
+      for (intptr_t j = 0; j < kChunkSize; j++) {
+        bits |= data[i + j];
+      }
+      if (bits >= 0x80) return false;
+    }
+    uint8_t bits = 0;
+    for (; i < len; i++) {
+      bits |= data[i];
+    }
+    return bits < 0x80;
+  }
+
+  // Whether all the code units fit in a one-byte string.
+  static bool IsLatin1(const uint16_t* data, intptr_t len) {
+    intptr_t i = 0;
+    for (; i + kChunkSize <= len; i += kChunkSize) {
+      uint16_t bits = 0;
+      for (intptr_t j = 0; j < kChunkSize; j++) {
+        bits |= LoadUnaligned(&data[i + j]);
+      }
+      if (bits > 0xFF) return false;
+    }
+    uint16_t bits = 0;
+    for (; i < len; i++) {
+      bits |= LoadUnaligned(&data[i]);
+    }
+    return bits <= 0xFF;
+  }
+
+  // Whether any of the code units is in [first, last].
+  static bool ContainsInRange(const uint8_t* data,
+                              intptr_t len,
+                              uint8_t first,
+                              uint8_t last) {
+    const uint8_t range = last - first;
+    intptr_t i = 0;
+    for (; i + kChunkSize <= len; i += kChunkSize) {
+      uint8_t found = 0;
+      for (intptr_t j = 0; j < kChunkSize; j++) {
+        found |= static_cast<uint8_t>(data[i + j] - first) <= range;
+      }
+      if (found != 0) return true;
+    }
+    uint8_t found = 0;
+    for (; i < len; i++) {
+      found |= static_cast<uint8_t>(data[i] - first) <= range;
+    }
+    return found != 0;
+  }
+
+  // Copies the ASCII code units of [src] to [dst], switching the case of the
+  // letters in [first, last], which must be all upper or all lower case.
+  static void SwitchAsciiCase(const uint8_t* src,
+                              uint8_t* dst,
+                              intptr_t len,
+                              uint8_t first,
+                              uint8_t last) {
+    const uint8_t range = last - first;
+    for (intptr_t i = 0; i < len; i++) {
+      const uint8_t ch = src[i];
+      const uint8_t is_letter = static_cast<uint8_t>(ch - first) <= range;
+      dst[i] = ch ^ (is_letter << 5);
+    }
+  }
+
+  // Copies one-byte code units to two-byte ones.
+  static void Widen(const uint8_t* src, uint16_t* dst, intptr_t len) {
+    for (intptr_t i = 0; i < len; i++) {
+      dst[i] = src[i];
+    }
+  }
+
+  // Copies two-byte code units, which must all be Latin-1, to one-byte ones.
+  static void Narrow(const uint16_t* src, uint8_t* dst, intptr_t len) {
+    for (intptr_t i = 0; i < len; i++) {
+      dst[i] = static_cast<uint8_t>(LoadUnaligned(&src[i]));
+    }
+  }
+
+  // Returns the index of the first occurrence of [needle] in [haystack], or
+  // -1 if there is none.
+  static intptr_t IndexOf(const uint8_t* haystack,
+                          intptr_t haystack_len,
+                          const uint8_t* needle,
+                          intptr_t needle_len) {
+    if (needle_len == 0) return 0;
+    if (needle_len > haystack_len) return -1;
+    const uint8_t* end = haystack + (haystack_len - needle_len) + 1;
+    const uint8_t* candidate = haystack;
+    while (candidate < end) {
+      candidate = static_cast<const uint8_t*>(
+          memchr(candidate, needle[0], end - candidate));
+      if (candidate == nullptr) return -1;
+      if (memcmp(candidate + 1, needle + 1, needle_len - 1) == 0) {
+        return candidate - haystack;
+      }
+      candidate++;
+    }
+    return -1;
+  }
+
+ private:
+  static constexpr intptr_t kChunkSize = 32;
+};
+
+}  // namespace dart
+
+#endif  // RUNTIME_VM_STRING_KERNELS_H_
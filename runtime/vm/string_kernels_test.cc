@@ -0,0 +1,127 @@
+// Copyright (c) 2024, the Dart project authors.  Please see the AUTHORS file
+// for details. All rights reserved. Use of this source code is governed by a
+// BSD-style license that can be found in the LICENSE file.
+
+#include "vm/string_kernels.h"
+
+#include "platform/assert.h"
+#include "vm/unit_test.h"
+
+namespace dart {
+
+// Long enough to cover several chunks and a remainder.
+static constexpr intptr_t kLength = 100;
+
+VM_UNIT_TEST_CASE(StringKernels_Equals) {
+  uint8_t one_byte[kLength];
+  uint8_t other_one_byte[kLength];
+  uint16_t two_byte[kLength];
+  for (intptr_t i = 0; i < kLength; i++) {
+    one_byte[i] = other_one_byte[i] = 'a' + (i % 26);
+    two_byte[i] = one_byte[i];
+  }
+  // Two-byte code units may be unaligned.
+  uint8_t buffer[(kLength + 1) * sizeof(uint16_t)];
+  uint16_t* unaligned = reinterpret_cast<uint16_t*>(&buffer[1]);
+  memmove(unaligned, two_byte, kLength * sizeof(uint16_t));
+
+  for (intptr_t len = 0; len <= kLength; len++) {
+    EXPECT(StringKernels::Equals(one_byte, other_one_byte, len));
+    EXPECT(StringKernels::Equals(two_byte, one_byte, len));
+    EXPECT(StringKernels::Equals(unaligned, one_byte, len));
+    EXPECT(StringKernels::Equals(unaligned, two_byte, len));
+  }
+  for (intptr_t i = 0; i < kLength; i++) {
+    other_one_byte[i] = 'A';
+    EXPECT(!StringKernels::Equals(one_byte, other_one_byte, kLength));
+    EXPECT(!StringKernels::Equals(unaligned, other_one_byte, kLength));
+    EXPECT(StringKernels::Equals(one_byte, other_one_byte, i));
+    EXPECT(StringKernels::Equals(unaligned, other_one_byte, i));
+    other_one_byte[i] = one_byte[i];
+  }
+  // Code units which only differ in their upper byte.
+  two_byte[kLength / 2] |= 0x100;
+  EXPECT(!StringKernels::Equals(two_byte, one_byte, kLength));
+}
+
+VM_UNIT_TEST_CASE(StringKernels_IsAsciiAndLatin1) {
+  uint8_t one_byte[kLength];
+  uint16_t two_byte[kLength];
+  for (intptr_t i = 0; i < kLength; i++) {
+    one_byte[i] = 0x7F;
+    two_byte[i] = 0xFF;
+  }
+  EXPECT(StringKernels::IsAscii(one_byte, kLength));
+  EXPECT(StringKernels::IsLatin1(two_byte, kLength));
+  for (intptr_t i = 0; i < kLength; i++) {
+    one_byte[i] = 0x80;
+    two_byte[i] = 0x100;
+    EXPECT(!StringKernels::IsAscii(one_byte, kLength));
+    EXPECT(!StringKernels::IsLatin1(two_byte, kLength));
+    EXPECT(StringKernels::IsAscii(one_byte, i));
+    EXPECT(StringKernels::IsLatin1(two_byte, i));
+    one_byte[i] = 0x7F;
+    two_byte[i] = 0xFF;
+  }
+}
+
+VM_UNIT_TEST_CASE(StringKernels_CaseConversion) {
+  const char* kMixed =
+      "The Quick Brown Fox Jumps Over The Lazy Dog @[`{ 0123456789 "
+      "the quick brown fox jumps over the lazy dog ~";
+  const intptr_t len = strlen(kMixed);
+  const uint8_t* mixed = reinterpret_cast<const uint8_t*>(kMixed);
+  uint8_t lower[256];
+  uint8_t upper[256];
+  StringKernels::SwitchAsciiCase(mixed, lower, len, 'A', 'Z');
+  StringKernels::SwitchAsciiCase(mixed, upper, len, 'a', 'z');
+  for (intptr_t i = 0; i < len; i++) {
+    EXPECT_EQ(tolower(kMixed[i]), lower[i]);
+    EXPECT_EQ(toupper(kMixed[i]), upper[i]);
+  }
+  EXPECT(StringKernels::ContainsInRange(mixed, len, 'A', 'Z'));
+  EXPECT(!StringKernels::ContainsInRange(lower, len, 'A', 'Z'));
+  EXPECT(!StringKernels::ContainsInRange(upper, len, 'a', 'z'));
+  // The last character of the range is included.
+  EXPECT(StringKernels::ContainsInRange(mixed, len, '~', '~'));
+}
+
+VM_UNIT_TEST_CASE(StringKernels_WidenAndNarrow) {
+  uint8_t one_byte[kLength];
+  uint16_t two_byte[kLength];
+  uint8_t narrowed[kLength];
+  for (intptr_t i = 0; i < kLength; i++) {
+    one_byte[i] = 0xFF - i;
+  }
+  StringKernels::Widen(one_byte, two_byte, kLength);
+  StringKernels::Narrow(two_byte, narrowed, kLength);
+  for (intptr_t i = 0; i < kLength; i++) {
+    EXPECT_EQ(0xFF - i, two_byte[i]);
+    EXPECT_EQ(one_byte[i], narrowed[i]);
+  }
+}
+
+VM_UNIT_TEST_CASE(StringKernels_IndexOf) {
+  const char* kHaystack =
+      "abababababababababababababababababababababababababababababababababab"
+      "abcabababababababcd";
+  const uint8_t* haystack = reinterpret_cast<const uint8_t*>(kHaystack);
+  const intptr_t len = strlen(kHaystack);
+  auto index_of = [&](const char* needle) {
+    return StringKernels::IndexOf(haystack, len,
+                                  reinterpret_cast<const uint8_t*>(needle),
+                                  strlen(needle));
+  };
+  EXPECT_EQ(0, index_of(""));
+  EXPECT_EQ(0, index_of("ab"));
+  EXPECT_EQ(1, index_of("ba"));
+  EXPECT_EQ(len - 19 + 2, index_of("cab"));
+  EXPECT_EQ(len - 2, index_of("cd"));
+  EXPECT_EQ(len - 1, index_of("d"));
+  EXPECT_EQ(-1, index_of("abd"));
+  EXPECT_EQ(-1, index_of("dd"));
+  EXPECT_EQ(0, index_of(kHaystack));
+  EXPECT_EQ(-1, StringKernels::IndexOf(haystack, 3, haystack, 4));
+}
+
+}  // namespace dart
@@ -371,6 +371,61 @@ StringPtr Symbols::NewSymbol(Thread* thread, const StringType& str) {
   return symbol.ptr();
 }
 
+void Symbols::NewAll(Thread* thread, const class Array& strings) {
+  Zone* zone = thread->zone();
+  REUSABLE_OBJECT_HANDLESCOPE(thread);
+  REUSABLE_SMI_HANDLESCOPE(thread);
+  REUSABLE_WEAK_ARRAY_HANDLESCOPE(thread);
+  String& str = String::Handle(zone);
+  String& symbol = String::Handle(zone);
+  dart::Object& key = thread->ObjectHandle();
+  Smi& value = thread->SmiHandle();
+  class WeakArray& data = thread->WeakArrayHandle();
+  IsolateGroup* group = thread->isolate_group();
+  ObjectStore* object_store = group->object_store();
+
+  // First resolve all strings which are already symbols, without locking.
+  GrowableArray<intptr_t> missing;
+  const intptr_t length = strings.Length();
+  for (intptr_t i = 0; i < length; i++) {
+    str ^= strings.At(i);
+    if (str.IsSymbol()) continue;
+    const StringSlice slice(str, 0, str.Length());
+    data = Dart::vm_isolate_group()->object_store()->symbol_table();
+    {
+      CanonicalStringSet table(&key, &value, &data);
+      symbol ^= table.GetOrNull(slice);
+      table.Release();
+    }
+    if (symbol.IsNull()) {
+      data = object_store->symbol_table();
+      CanonicalStringSet table(&key, &value, &data);
+      symbol ^= table.GetOrNull(slice);
+      table.Release();
+    }
+    if (symbol.IsNull()) {
+      missing.Add(i);
+    } else {
+      strings.SetAt(i, symbol);
+    }
+  }
+  if (missing.is_empty()) return;
+
+  // Then get-or-insert the remaining ones under a single acquisition of the
+  // mutex. Another thread may have added some of them in the meantime.
+  RELEASE_ASSERT(thread->CanAcquireSafepointLocks());
+  SafepointMutexLocker ml(group->symbols_mutex());
+  data = object_store->symbol_table();
+  CanonicalStringSet table(&key, &value, &data);
+  for (intptr_t i = 0; i < missing.length(); i++) {
+    str ^= strings.At(missing[i]);
+    symbol ^= table.InsertNewOrGet(StringSlice(str, 0, str.Length()));
+    ASSERT(symbol.IsSymbol());
+    strings.SetAt(missing[i], symbol);
+  }
+  object_store->set_symbol_table(table.Release());
+}
+
 template <typename StringType>
 StringPtr Symbols::Lookup(Thread* thread, const StringType& str) {
   REUSABLE_OBJECT_HANDLESCOPE(thread);
@@ -766,6 +766,12 @@ class Symbols : public AllStatic {
   static StringPtr FromSet(Thread* thread, const String& str);
   static StringPtr FromDot(Thread* thread, const String& str);
 
+  // Replaces every string in [strings] by the equal symbol. Strings which are
+  // not yet symbols are looked up without locking, and all the missing ones
+  // are then added while holding the symbols mutex once, instead of once per
+  // string as [New] does.
+  static void NewAll(Thread* thread, const class Array& strings);
+
   // Returns char* of predefined symbol.
   static const char* Name(SymbolId symbol);
 
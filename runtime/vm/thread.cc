@@ -261,6 +261,8 @@ const char* Thread::TaskKindToCString(TaskKind kind) {
       return "kSweeperTask";
     case kMarkerTask:
       return "kMarkerTask";
+    case kPrecompilerTask:
+      return "kPrecompilerTask";
     default:
       UNREACHABLE();
       return "";
@@ -17,6 +17,7 @@
 #include "vm/zone_text_buffer.h"
 
 #if !defined(DART_PRECOMPILED_RUNTIME)
+#include "vm/compiler/aot/precompiler.h"
 #include "vm/compiler/backend/flow_graph_compiler.h"
 #include "vm/compiler/backend/il_printer.h"
 #endif  // !defined(DART_PRECOMPILED_RUNTIME)
@@ -335,6 +336,15 @@ void TypeTestingStubGenerator::BuildOptimizedTypeTestStub(
       THR, compiler::target::Thread::slow_type_test_entry_point_offset()));
 }
 
+// Besides the class id register, testing a subtype bitset uses two registers
+// which only hold type arguments in other checks. On architectures where they
+// overlap with the registers of the TypeTestABI, the stubs use cid ranges.
+static constexpr Register kBitsetReg =
+    TTSInternalRegs::kInstanceTypeArgumentsReg;
+static constexpr Register kBitMaskReg = TTSInternalRegs::kSubTypeArgumentReg;
+static constexpr bool kCanTestSubtypeBitsets =
+    (TTSInternalRegs::kSavedTypeArgumentRegisters & (1 << kBitMaskReg)) == 0;
+
 void TypeTestingStubGenerator::BuildOptimizedTypeTestStubFastCases(
     compiler::Assembler* assembler,
     HierarchyInfo* hi,
@@ -383,9 +393,17 @@ void TypeTestingStubGenerator::BuildOptimizedTypeTestStubFastCases(
       __ BranchIfSmi(TypeTestABI::kInstanceReg, &is_not_subtype);
       __ LoadClassId(TTSInternalRegs::kScratchReg, TypeTestABI::kInstanceReg);
     }
-    BuildOptimizedSubtypeRangeCheck(assembler, ranges,
-                                    TTSInternalRegs::kScratchReg, &is_subtype,
-                                    &is_not_subtype);
+    const TypedData* bitset =
+        kCanTestSubtypeBitsets ? hi->SubtypeBitsetFor(type) : nullptr;
+    if (bitset != nullptr) {
+      BuildOptimizedSubtypeBitsetCheck(assembler, *bitset,
+                                       TTSInternalRegs::kScratchReg,
+                                       &is_not_subtype);
+    } else {
+      BuildOptimizedSubtypeRangeCheck(assembler, ranges,
+                                      TTSInternalRegs::kScratchReg,
+                                      &is_subtype, &is_not_subtype);
+    }
     __ Bind(&is_subtype);
     __ Ret();
     __ Bind(&is_not_subtype);
@@ -604,6 +622,33 @@ bool TypeTestingStubGenerator::BuildOptimizedSubtypeRangeCheck(
       assembler, class_id_reg, ranges, check_succeeded, check_failed, true);
 }
 
+// Tests the bit of the class id in [bitset] (see
+// HierarchyInfo::SubtypeBitsetFor). Falls through if it is set, else jumps to
+// check_failed. Clobbers class_id_reg.
+void TypeTestingStubGenerator::BuildOptimizedSubtypeBitsetCheck(
+    compiler::Assembler* assembler,
+    const TypedData& bitset,
+    Register class_id_reg,
+    compiler::Label* check_failed) {
+  ASSERT(kCanTestSubtypeBitsets);
+  __ Comment("Subtype bitset check");
+  __ LoadObject(kBitsetReg, Precompiler::Instance()->subtype_bit_masks());
+  __ MoveRegister(kBitMaskReg, class_id_reg);
+  __ AndImmediate(kBitMaskReg, kBitsPerByte - 1);
+  __ LoadIndexedPayload(kBitMaskReg, kBitsetReg,
+                        compiler::target::TypedData::payload_offset(),
+                        kBitMaskReg, TIMES_1, compiler::kUnsignedByte);
+  __ LoadObject(kBitsetReg, bitset);
+  __ LsrImmediate(class_id_reg, kBitsPerByteLog2);
+  __ LoadIndexedPayload(kBitsetReg, kBitsetReg,
+                        compiler::target::TypedData::payload_offset(),
+                        class_id_reg, TIMES_1, compiler::kUnsignedByte);
+  __ AndRegisters(kBitsetReg, kBitMaskReg);
+  __ CompareImmediate(kBitsetReg, 0);
+  __ BranchIf(EQUAL, check_failed);
+  Precompiler::Instance()->RecordSubtypeBitsetCheck(/*in_stub=*/true);
+}
+
 void TypeTestingStubGenerator::
     BuildOptimizedSubclassRangeCheckWithTypeArguments(
         compiler::Assembler* assembler,
@@ -79,6 +79,11 @@ class TypeTestingStubGenerator {
                                               compiler::Label* check_succeeded,
                                               compiler::Label* check_failed);
 
+  static void BuildOptimizedSubtypeBitsetCheck(compiler::Assembler* assembler,
+                                               const TypedData& bitset,
+                                               Register class_id_reg,
+                                               compiler::Label* check_failed);
+
   static void BuildOptimizedSubclassRangeCheckWithTypeArguments(
       compiler::Assembler* assembler,
       HierarchyInfo* hi,
@@ -442,3 +442,16 @@ class FinalizerEntry {
 
 @pragma("vm:external-name", "StringBase_intern")
 external String intern(String str);
+
+/// Returns a fixed-length list of the interned [strings], in the same order.
+///
+/// Cheaper than calling [intern] on each of the strings, as the strings
+/// which are not interned yet are added to the symbol table all at once.
+List<String> internAll(List<String> strings) {
+  final result = List<String>.of(strings, growable: false);
+  _internAll(result);
+  return result;
+}
+
+@pragma("vm:external-name", "StringBase_internAll")
+external void _internAll(List<String> strings);
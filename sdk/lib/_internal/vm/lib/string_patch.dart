@@ -1097,10 +1097,22 @@ final class _OneByteString extends _StringBase {
         }
         return -1;
       }
+      // Long one-byte strings are searched by the runtime, which is faster
+      // once the cost of the native call is amortized.
+      if ((pCid == ClassID.cidOneByteString) &&
+          (start >= 0) &&
+          (len - start >= _indexOfInRuntimeThreshold)) {
+        return _indexOfInRuntime(patternAsString, start);
+      }
     }
     return super.indexOf(pattern, start);
   }
 
+  static const int _indexOfInRuntimeThreshold = 256;
+
+  @pragma("vm:external-name", "OneByteString_indexOf")
+  external int _indexOfInRuntime(String pattern, int start);
+
   bool contains(Pattern pattern, [int start = 0]) {
     final pCid = ClassID.getID(pattern);
     if ((pCid == ClassID.cidOneByteString) ||